@@ -0,0 +1,136 @@
+// Seek microbenchmark for the restart key prefix array: locates the
+// restart interval of random targets among the restart keys of a data
+// block, once by binary search with full key comparisons (as a block seek
+// does without prefixes) and once with SearchRestartPrefixes() followed by
+// full comparisons of the tied restart points only.  With 16-byte keys
+// every restart key shares its first 8 bytes, the worst case for the
+// prefixes.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "leveldb/comparator.h"
+#include "leveldb/slice.h"
+#include "table/restart_prefix_search.h"
+#include "util/coding.h"
+
+namespace czy_leveldb {
+namespace {
+
+std::string IKey(const std::string& user_key, uint64_t seq) {
+  std::string result = user_key;
+  PutFixed64(&result, (seq << 8) | 1);
+  return result;
+}
+
+int CompareIKeys(const Comparator* ucmp, const Slice& a, const Slice& b) {
+  int r = ucmp->Compare(Slice(a.data(), a.size() - 8),
+                        Slice(b.data(), b.size() - 8));
+  if (r == 0) {
+    const uint64_t na = DecodeFixed64(a.data() + a.size() - 8);
+    const uint64_t nb = DecodeFixed64(b.data() + b.size() - 8);
+    r = (na > nb) ? -1 : (na < nb) ? +1 : 0;
+  }
+  return r;
+}
+
+// Index of the last restart key < target (0 if none), as Block::Iter::Seek.
+uint32_t SeekBinary(const Comparator* ucmp,
+                    const std::vector<std::string>& restarts,
+                    const Slice& target) {
+  uint32_t left = 0;
+  uint32_t right = static_cast<uint32_t>(restarts.size()) - 1;
+  while (left < right) {
+    const uint32_t mid = (left + right + 1) / 2;
+    if (CompareIKeys(ucmp, restarts[mid], target) < 0) {
+      left = mid;
+    } else {
+      right = mid - 1;
+    }
+  }
+  return left;
+}
+
+uint32_t SeekPrefix(const Comparator* ucmp,
+                    const std::vector<std::string>& restarts,
+                    const std::string& prefixes, const Slice& target) {
+  uint32_t left, right;
+  SearchRestartPrefixes(prefixes.data(),
+                        static_cast<uint32_t>(restarts.size()),
+                        RestartKeyPrefix(target), &left, &right);
+  // Binary search the tied restart points for the first one >= target.
+  while (left < right) {
+    const uint32_t mid = left + (right - left) / 2;
+    if (CompareIKeys(ucmp, restarts[mid], target) < 0) {
+      left = mid + 1;
+    } else {
+      right = mid;
+    }
+  }
+  return left > 0 ? left - 1 : 0;
+}
+
+void Run(int num_restarts, int key_size, int num_seeks) {
+  std::mt19937_64 rnd(301);
+  const Comparator* ucmp = BytewiseComparator();
+  std::vector<std::string> user_keys;
+  for (int i = 0; i < num_restarts; i++) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%016d", i * 16);
+    user_keys.push_back(std::string(buf).substr(16 - key_size));
+  }
+  std::vector<std::string> restarts;
+  std::string prefixes;
+  for (const std::string& k : user_keys) {
+    restarts.push_back(IKey(k, 100));
+    PutFixed64(&prefixes, RestartKeyPrefix(restarts.back()));
+  }
+  std::vector<std::string> targets;
+  for (int i = 0; i < 4096; i++) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%016d",
+                  static_cast<int>(rnd() % (num_restarts * 16)));
+    targets.push_back(IKey(std::string(buf).substr(16 - key_size), 200));
+  }
+
+  uint64_t check = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_seeks; i++) {
+    check += SeekBinary(ucmp, restarts, targets[i % targets.size()]);
+  }
+  auto mid = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_seeks; i++) {
+    check -= SeekPrefix(ucmp, restarts, prefixes, targets[i % targets.size()]);
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  const double binary_ns =
+      std::chrono::duration<double, std::nano>(mid - start).count() /
+      num_seeks;
+  const double prefix_ns =
+      std::chrono::duration<double, std::nano>(end - mid).count() / num_seeks;
+  std::printf("restarts %5d  key %2d bytes : binary %7.1f ns/seek  "
+              "prefix %7.1f ns/seek%s\n",
+              num_restarts, key_size, binary_ns, prefix_ns,
+              check == 0 ? "" : "  (MISMATCH)");
+}
+
+}  // namespace
+}  // namespace czy_leveldb
+
+int main(int argc, char** argv) {
+  int num_seeks = 1000000;
+  if (argc > 1) {
+    num_seeks = std::atoi(argv[1]);
+  }
+  for (int restarts : {16, 64, 256, 1024}) {
+    for (int key_size : {8, 16}) {
+      czy_leveldb::Run(restarts, key_size, num_seeks);
+    }
+  }
+  return 0;
+}
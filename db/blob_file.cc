@@ -0,0 +1,172 @@
+#include "db/blob_file.h"
+
+#include "leveldb/env.h"
+#include "table/compression.h"
+#include "util/coding.h"
+#include "util/crc32c.h"
+
+namespace czy_leveldb {
+
+void BlobIndex::EncodeTo(std::string* dst) const {
+  PutVarint64(dst, file_number);
+  PutVarint64(dst, offset);
+  PutVarint64(dst, size);
+  dst->push_back(static_cast<char>(compression));
+}
+
+Status BlobIndex::DecodeFrom(Slice input) {
+  if (GetVarint64(&input, &file_number) && GetVarint64(&input, &offset) &&
+      GetVarint64(&input, &size) && input.size() == 1) {
+    compression = static_cast<CompressionType>(input[0]);
+    return Status::OK();
+  }
+  return Status::Corruption("bad blob index");
+}
+
+BlobFileBuilder::BlobFileBuilder(const Options& options, uint64_t file_number,
+                                 WritableFile* file)
+    : options_(options),
+      file_number_(file_number),
+      file_(file),
+      offset_(0),
+      num_blobs_(0) {
+  char header[kBlobFileHeaderSize];
+  EncodeFixed64(header, kBlobFileMagic);
+  EncodeFixed32(header + 8, kBlobFileVersion);
+  status_ = file_->Append(Slice(header, sizeof(header)));
+  offset_ = sizeof(header);
+}
+
+Status BlobFileBuilder::Add(const Slice& user_key, const Slice& value,
+                            std::string* blob_index) {
+  if (!status_.ok()) {
+    return status_;
+  }
+
+  Slice stored = value;
+  CompressionType type = options_.blob_compression;
+  if (type != CompressionType::kNoCompression) {
+    compressed_.clear();
+    if (CompressBlock(type, options_.zstd_compression_level, nullptr, value,
+                      &compressed_)) {
+      stored = compressed_;
+    } else {
+      type = CompressionType::kNoCompression;
+    }
+  }
+
+  record_.resize(kBlobRecordHeaderSize);
+  EncodeFixed32(&record_[4], static_cast<uint32_t>(user_key.size()));
+  EncodeFixed64(&record_[8], stored.size());
+  record_[16] = static_cast<char>(type);
+  record_.append(user_key.data(), user_key.size());
+  record_.append(stored.data(), stored.size());
+  EncodeFixed32(&record_[0], crc32c::Mask(crc32c::Value(
+                                 record_.data() + 4, record_.size() - 4)));
+
+  status_ = file_->Append(record_);
+  if (!status_.ok()) {
+    return status_;
+  }
+
+  BlobIndex index;
+  index.file_number = file_number_;
+  index.offset = offset_ + kBlobRecordHeaderSize + user_key.size();
+  index.size = stored.size();
+  index.compression = type;
+  blob_index->clear();
+  index.EncodeTo(blob_index);
+
+  offset_ += record_.size();
+  num_blobs_++;
+  return status_;
+}
+
+Status BlobFileBuilder::Finish() {
+  if (status_.ok()) {
+    status_ = file_->Flush();
+  }
+  if (status_.ok()) {
+    status_ = file_->Sync();
+  }
+  return status_;
+}
+
+Status BlobFileReader::Open(uint64_t file_number, RandomAccessFile* file,
+                            uint64_t file_size, BlobFileReader** reader) {
+  *reader = nullptr;
+  if (file_size < kBlobFileHeaderSize) {
+    return Status::Corruption("blob file too short");
+  }
+  char scratch[kBlobFileHeaderSize];
+  Slice header;
+  Status s = file->Read(0, kBlobFileHeaderSize, &header, scratch);
+  if (!s.ok()) {
+    return s;
+  }
+  if (header.size() != kBlobFileHeaderSize ||
+      DecodeFixed64(header.data()) != kBlobFileMagic) {
+    return Status::Corruption("not a blob file");
+  }
+  if (DecodeFixed32(header.data() + 8) != kBlobFileVersion) {
+    return Status::NotSupported("unknown blob file version");
+  }
+  *reader = new BlobFileReader(file_number, file, file_size);
+  return s;
+}
+
+Status BlobFileReader::Get(const ReadOptions& options, const Slice& user_key,
+                           const BlobIndex& index, std::string* value) const {
+  if (index.file_number != file_number_) {
+    return Status::InvalidArgument("blob index refers to another file");
+  }
+  // The value is the tail of its record; read the whole record so the key
+  // and checksum can be checked.
+  const uint64_t record_size = kBlobRecordHeaderSize + user_key.size() +
+                               index.size;
+  if (index.offset < kBlobFileHeaderSize + kBlobRecordHeaderSize +
+                         user_key.size() ||
+      index.offset + index.size > file_size_) {
+    return Status::Corruption("blob index out of range");
+  }
+  const uint64_t record_offset = index.offset + index.size - record_size;
+
+  std::string buf(record_size, '\0');
+  Slice record;
+  Status s = file_->Read(record_offset, record_size, &record, &buf[0]);
+  if (!s.ok()) {
+    return s;
+  }
+  if (record.size() != record_size) {
+    return Status::Corruption("truncated blob record");
+  }
+
+  const char* p = record.data();
+  if (DecodeFixed32(p + 4) != user_key.size() ||
+      DecodeFixed64(p + 8) != index.size ||
+      static_cast<CompressionType>(p[16]) != index.compression ||
+      Slice(p + kBlobRecordHeaderSize, user_key.size()) != user_key) {
+    return Status::Corruption("blob record does not match its index");
+  }
+  if (options.verify_checksums) {
+    const uint32_t expected = crc32c::Unmask(DecodeFixed32(p));
+    if (crc32c::Value(p + 4, record_size - 4) != expected) {
+      return Status::Corruption("blob record checksum mismatch");
+    }
+  }
+
+  Slice stored(p + kBlobRecordHeaderSize + user_key.size(), index.size);
+  if (index.compression == CompressionType::kNoCompression) {
+    value->assign(stored.data(), stored.size());
+    return s;
+  }
+  return UncompressBlock(index.compression, nullptr, stored, value);
+}
+
+bool NeedsBlobGarbageCollection(const BlobFileMetaData& meta,
+                                const Options& options) {
+  return options.enable_blob_garbage_collection && meta.file_size > 0 &&
+         meta.GarbageRatio() >= options.blob_garbage_collection_ratio;
+}
+
+}  // namespace czy_leveldb
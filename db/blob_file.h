@@ -0,0 +1,108 @@
+#pragma once
+// A blob file holds the large values of a DB when Options::enable_blob_files
+// is set.  It is written once, front to back, and never modified:
+//
+//    header:  magic (fixed64) | version (fixed32)
+//    record*: checksum (fixed32) | key size (fixed32) | value size (fixed64)
+//             | compression (uint8) | user key | value
+//
+// The checksum is a masked crc32c of everything in the record after it.
+// The user key is kept so garbage collection can tell, by looking the key
+// up in the LSM, whether a record is still live.
+
+#include <cstdint>
+#include <string>
+
+#include "db/blob_index.h"
+#include "leveldb/options.h"
+#include "leveldb/slice.h"
+#include "leveldb/status.h"
+
+namespace czy_leveldb {
+
+class RandomAccessFile;
+class WritableFile;
+
+static const uint64_t kBlobFileMagic = 0x626c6f6266696c65ull;  // "blobfile"
+static const uint32_t kBlobFileVersion = 1;
+static const size_t kBlobFileHeaderSize = 12;
+static const size_t kBlobRecordHeaderSize = 17;
+
+class BlobFileBuilder {
+ public:
+  // Writes into *file, which must be empty.  Does not take ownership of
+  // "file" and does not close it.
+  BlobFileBuilder(const Options& options, uint64_t file_number,
+                  WritableFile* file);
+
+  BlobFileBuilder(const BlobFileBuilder&) = delete;
+  BlobFileBuilder& operator=(const BlobFileBuilder&) = delete;
+
+  // Append "value" for "user_key" and set *blob_index to the encoded
+  // BlobIndex to store in the LSM instead of the value.
+  Status Add(const Slice& user_key, const Slice& value,
+             std::string* blob_index);
+
+  // Flush and sync the file.  Stops using it after this returns.
+  Status Finish();
+
+  uint64_t NumBlobs() const { return num_blobs_; }
+  uint64_t FileSize() const { return offset_; }
+
+ private:
+  const Options options_;
+  const uint64_t file_number_;
+  WritableFile* file_;
+  uint64_t offset_;
+  uint64_t num_blobs_;
+  Status status_;
+  std::string compressed_;
+  std::string record_;
+};
+
+class BlobFileReader {
+ public:
+  // Check the header of "file" and return a reader for it in *reader.
+  // Does not take ownership of "file", which must outlive the reader.
+  static Status Open(uint64_t file_number, RandomAccessFile* file,
+                     uint64_t file_size, BlobFileReader** reader);
+
+  BlobFileReader(const BlobFileReader&) = delete;
+  BlobFileReader& operator=(const BlobFileReader&) = delete;
+
+  // Read the value "index" refers to into *value.  The record's key must
+  // equal "user_key"; a mismatch means the index is stale or corrupt.
+  Status Get(const ReadOptions& options, const Slice& user_key,
+             const BlobIndex& index, std::string* value) const;
+
+ private:
+  BlobFileReader(uint64_t file_number, RandomAccessFile* file,
+                 uint64_t file_size)
+      : file_number_(file_number), file_(file), file_size_(file_size) {}
+
+  const uint64_t file_number_;
+  RandomAccessFile* const file_;
+  const uint64_t file_size_;
+};
+
+// What the DB tracks per blob file to drive garbage collection.  A blob
+// becomes garbage when the table entry referring to it is overwritten,
+// deleted or dropped by compaction.
+struct BlobFileMetaData {
+  uint64_t file_number = 0;
+  uint64_t file_size = 0;
+  uint64_t garbage_bytes = 0;  // Record bytes no live entry refers to
+
+  double GarbageRatio() const {
+    return file_size == 0 ? 0.0
+                          : static_cast<double>(garbage_bytes) / file_size;
+  }
+};
+
+// Returns true if the live records of "meta" should be copied to a new
+// blob file by the next compaction that touches them, so that the file
+// can be deleted.
+bool NeedsBlobGarbageCollection(const BlobFileMetaData& meta,
+                                const Options& options);
+
+}  // namespace czy_leveldb
@@ -0,0 +1,190 @@
+#include "db/blob_file.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "leveldb/env.h"
+
+namespace czy_leveldb {
+
+namespace {
+
+class StringSink : public WritableFile {
+ public:
+  Status Append(const Slice& data) override {
+    contents_.append(data.data(), data.size());
+    return Status::OK();
+  }
+  Status Close() override { return Status::OK(); }
+  Status Flush() override { return Status::OK(); }
+  Status Sync() override { return Status::OK(); }
+
+  std::string* contents() { return &contents_; }
+
+ private:
+  std::string contents_;
+};
+
+class StringSource : public RandomAccessFile {
+ public:
+  explicit StringSource(const std::string* contents) : contents_(contents) {}
+
+  Status Read(uint64_t offset, size_t n, Slice* result,
+              char* scratch) const override {
+    if (offset >= contents_->size()) {
+      *result = Slice();
+      return Status::OK();
+    }
+    n = std::min(n, static_cast<size_t>(contents_->size() - offset));
+    std::memcpy(scratch, contents_->data() + offset, n);
+    *result = Slice(scratch, n);
+    return Status::OK();
+  }
+
+ private:
+  const std::string* const contents_;
+};
+
+class BlobFileTest : public testing::Test {
+ public:
+  BlobFileTest() : source_(sink_.contents()) {}
+
+  // Write "values" for keys "k0", "k1", ... and return their blob indexes.
+  std::vector<BlobIndex> Build(const std::vector<std::string>& values) {
+    BlobFileBuilder builder(options_, 7, &sink_);
+    std::vector<BlobIndex> indexes;
+    for (size_t i = 0; i < values.size(); i++) {
+      std::string encoded;
+      EXPECT_TRUE(
+          builder.Add("k" + std::to_string(i), values[i], &encoded).ok());
+      BlobIndex index;
+      EXPECT_TRUE(index.DecodeFrom(encoded).ok());
+      indexes.push_back(index);
+    }
+    EXPECT_TRUE(builder.Finish().ok());
+    EXPECT_EQ(values.size(), builder.NumBlobs());
+    EXPECT_EQ(sink_.contents()->size(), builder.FileSize());
+    return indexes;
+  }
+
+  BlobFileReader* Open() {
+    BlobFileReader* reader;
+    EXPECT_TRUE(
+        BlobFileReader::Open(7, &source_, sink_.contents()->size(), &reader)
+            .ok());
+    return reader;
+  }
+
+  Options options_;
+  StringSink sink_;
+  StringSource source_;
+};
+
+}  // namespace
+
+TEST(BlobIndex, EncodeDecode) {
+  BlobIndex index;
+  index.file_number = 12;
+  index.offset = 1ull << 33;
+  index.size = 4096;
+  index.compression = CompressionType::kZstdCompression;
+  std::string encoded;
+  index.EncodeTo(&encoded);
+  BlobIndex decoded;
+  ASSERT_TRUE(decoded.DecodeFrom(encoded).ok());
+  ASSERT_EQ(12u, decoded.file_number);
+  ASSERT_EQ(1ull << 33, decoded.offset);
+  ASSERT_EQ(4096u, decoded.size);
+  ASSERT_EQ(CompressionType::kZstdCompression, decoded.compression);
+  ASSERT_TRUE(decoded.DecodeFrom(Slice(encoded.data(), encoded.size() - 1))
+                  .IsCorruption());
+}
+
+TEST_F(BlobFileTest, ReadBack) {
+  const std::vector<std::string> values = {std::string(10000, 'x'), "small",
+                                           "", std::string(5000, 'y')};
+  std::vector<BlobIndex> indexes = Build(values);
+  BlobFileReader* reader = Open();
+  ReadOptions read_options;
+  read_options.verify_checksums = true;
+  for (size_t i = 0; i < values.size(); i++) {
+    std::string value;
+    ASSERT_TRUE(
+        reader->Get(read_options, "k" + std::to_string(i), indexes[i], &value)
+            .ok());
+    ASSERT_EQ(values[i], value);
+  }
+  delete reader;
+}
+
+TEST_F(BlobFileTest, CompressedValues) {
+  options_.blob_compression = CompressionType::kSnappyCompression;
+  const std::vector<std::string> values = {std::string(10000, 'x')};
+  std::vector<BlobIndex> indexes = Build(values);
+  BlobFileReader* reader = Open();
+  std::string value;
+  ASSERT_TRUE(reader->Get(ReadOptions(), "k0", indexes[0], &value).ok());
+  ASSERT_EQ(values[0], value);
+  delete reader;
+}
+
+TEST_F(BlobFileTest, StaleOrCorruptIndex) {
+  std::vector<BlobIndex> indexes = Build({"value0", "value1"});
+  BlobFileReader* reader = Open();
+  std::string value;
+  // Wrong key for the record.
+  ASSERT_TRUE(reader->Get(ReadOptions(), "k1", indexes[0], &value)
+                  .IsCorruption());
+  // Another file's index.
+  BlobIndex other = indexes[0];
+  other.file_number = 8;
+  ASSERT_TRUE(reader->Get(ReadOptions(), "k0", other, &value)
+                  .IsInvalidArgument());
+  // Past the end of the file.
+  BlobIndex past = indexes[1];
+  past.offset += 100;
+  ASSERT_TRUE(
+      reader->Get(ReadOptions(), "k1", past, &value).IsCorruption());
+  delete reader;
+}
+
+TEST_F(BlobFileTest, ChecksumMismatch) {
+  std::vector<BlobIndex> indexes = Build({"value0"});
+  (*sink_.contents())[indexes[0].offset] ^= 0x01;
+  BlobFileReader* reader = Open();
+  ReadOptions read_options;
+  read_options.verify_checksums = true;
+  std::string value;
+  ASSERT_TRUE(
+      reader->Get(read_options, "k0", indexes[0], &value).IsCorruption());
+  delete reader;
+}
+
+TEST_F(BlobFileTest, BadHeader) {
+  Build({"value0"});
+  (*sink_.contents())[0] ^= 0x01;
+  BlobFileReader* reader;
+  ASSERT_TRUE(
+      BlobFileReader::Open(7, &source_, sink_.contents()->size(), &reader)
+          .IsCorruption());
+  ASSERT_EQ(nullptr, reader);
+}
+
+TEST(BlobGarbageCollection, Threshold) {
+  Options options;
+  options.blob_garbage_collection_ratio = 0.5;
+  BlobFileMetaData meta;
+  ASSERT_FALSE(NeedsBlobGarbageCollection(meta, options));
+  meta.file_size = 1000;
+  meta.garbage_bytes = 499;
+  ASSERT_FALSE(NeedsBlobGarbageCollection(meta, options));
+  meta.garbage_bytes = 500;
+  ASSERT_TRUE(NeedsBlobGarbageCollection(meta, options));
+  options.enable_blob_garbage_collection = false;
+  ASSERT_FALSE(NeedsBlobGarbageCollection(meta, options));
+}
+
+}  // namespace czy_leveldb
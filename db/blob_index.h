@@ -0,0 +1,23 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+#include "leveldb/options.h"
+#include "leveldb/slice.h"
+#include "leveldb/status.h"
+
+namespace czy_leveldb {
+
+// Reference stored in the LSM, as the value of a kTypeBlobIndex entry, in
+// place of a value that was written to a blob file.
+struct BlobIndex {
+  uint64_t file_number = 0;
+  uint64_t offset = 0;  // Offset of the (possibly compressed) value
+  uint64_t size = 0;    // Stored size of the value
+  CompressionType compression = CompressionType::kNoCompression;
+
+  void EncodeTo(std::string* dst) const;
+  Status DecodeFrom(Slice input);
+};
+
+}  // namespace czy_leveldb
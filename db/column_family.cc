@@ -0,0 +1,114 @@
+#include "db/column_family.h"
+
+namespace czy_leveldb {
+
+const char kDefaultColumnFamilyName[] = "default";
+
+ColumnFamilyHandle::~ColumnFamilyHandle() = default;
+
+Options SanitizeColumnFamilyOptions(const Options& db_options,
+                                    const Options& cf_options) {
+  Options result = cf_options;
+  result.create_if_missing = db_options.create_if_missing;
+  result.error_if_exists = db_options.error_if_exists;
+  result.paranoid_checks = db_options.paranoid_checks;
+  result.env = db_options.env;
+  result.info_log = db_options.info_log;
+  result.max_open_files = db_options.max_open_files;
+  result.block_cache = db_options.block_cache;
+  result.reuse_logs = db_options.reuse_logs;
+  result.async_io_threads = db_options.async_io_threads;
+  return result;
+}
+
+void ColumnFamilyData::Unref() {
+  // acq_rel so that whichever thread drops the last reference sees every
+  // other holder's use of the family before deleting it.
+  const int old_refs = refs_.fetch_sub(1, std::memory_order_acq_rel);
+  assert(old_refs > 0);
+  if (old_refs == 1) {
+    delete this;
+  }
+}
+
+ColumnFamilySet::ColumnFamilySet(const Options& db_options)
+    : db_options_(db_options), default_(nullptr), next_id_(1) {
+  Status s = CreateWithId(kDefaultColumnFamilyId, kDefaultColumnFamilyName,
+                          db_options, &default_);
+  assert(s.ok());
+  (void)s;
+}
+
+ColumnFamilySet::~ColumnFamilySet() {
+  // Release the set's own references; families still referenced by
+  // handles are deleted when those are released.
+  for (auto& entry : by_id_) {
+    entry.second->Unref();
+  }
+}
+
+ColumnFamilyData* ColumnFamilySet::GetByName(const std::string& name) const {
+  auto it = by_name_.find(name);
+  return it == by_name_.end() ? nullptr : GetById(it->second);
+}
+
+ColumnFamilyData* ColumnFamilySet::GetById(uint32_t id) const {
+  auto it = by_id_.find(id);
+  return it == by_id_.end() ? nullptr : it->second;
+}
+
+Status ColumnFamilySet::Create(const std::string& name,
+                               const Options& cf_options,
+                               ColumnFamilyData** result) {
+  return CreateWithId(next_id_, name, cf_options, result);
+}
+
+Status ColumnFamilySet::CreateWithId(uint32_t id, const std::string& name,
+                                     const Options& cf_options,
+                                     ColumnFamilyData** result) {
+  if (name.empty()) {
+    return Status::InvalidArgument("empty column family name");
+  }
+  if (by_name_.count(name) != 0) {
+    return Status::InvalidArgument("column family already exists", name);
+  }
+  if (by_id_.count(id) != 0) {
+    return Status::Corruption("duplicate column family id", name);
+  }
+  ColumnFamilyData* cfd = new ColumnFamilyData(
+      id, name, SanitizeColumnFamilyOptions(db_options_, cf_options));
+  cfd->Ref();  // Owned by the set until dropped
+  by_id_[id] = cfd;
+  by_name_[name] = id;
+  if (id >= next_id_) {
+    next_id_ = id + 1;
+  }
+  *result = cfd;
+  return Status::OK();
+}
+
+Status ColumnFamilySet::Drop(ColumnFamilyData* cfd) {
+  if (cfd == default_) {
+    return Status::InvalidArgument("can not drop the default column family");
+  }
+  if (cfd->dropped_ || GetById(cfd->id()) != cfd) {
+    return Status::InvalidArgument("column family already dropped",
+                                   cfd->name());
+  }
+  cfd->dropped_ = true;
+  by_name_.erase(cfd->name());
+  by_id_.erase(cfd->id());
+  cfd->Unref();
+  return Status::OK();
+}
+
+std::vector<std::string> ColumnFamilySet::GetNames() const {
+  std::vector<std::string> names;
+  names.reserve(by_id_.size());
+  for (const auto& entry : by_id_) {  // Ordered by id, so default first
+    names.push_back(entry.second->name());
+  }
+  return names;
+}
+
+}  // namespace czy_leveldb
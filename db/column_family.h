@@ -0,0 +1,130 @@
+#pragma once
+// Bookkeeping for column families.  The DB keeps one ColumnFamilySet,
+// guarded by its mutex; each family's memtable, Version list and
+// compaction state hang off its ColumnFamilyData.
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "leveldb/column_family.h"
+#include "leveldb/options.h"
+#include "leveldb/status.h"
+
+namespace czy_leveldb {
+
+static const uint32_t kDefaultColumnFamilyId = 0;
+
+// WriteBatch record tags for non-default column families.  The tag is
+// followed by the family id as a varint32 and then the same fields as the
+// record of the ValueType in its low bits.  Records for the default family
+// keep the old tags, so batches written before column families existed
+// decode unchanged.
+enum WriteBatchColumnFamilyTag {
+  kTypeColumnFamilyDeletion = 0x10,
+  kTypeColumnFamilyValue = 0x11,
+  kTypeColumnFamilyRangeDeletion = 0x13,
+  kTypeColumnFamilyMerge = 0x14,
+};
+
+// Return "cf_options" with the fields that belong to the DB as a whole
+// (env, logging, block cache, file limits, recovery behaviour) replaced by
+// those of "db_options", since every family shares them.
+Options SanitizeColumnFamilyOptions(const Options& db_options,
+                                    const Options& cf_options);
+
+class ColumnFamilyData {
+ public:
+  uint32_t id() const { return id_; }
+  const std::string& name() const { return name_; }
+  const Options& options() const { return options_; }
+  bool dropped() const { return dropped_; }
+
+  // Handles and in-flight reads keep a reference; the family's state is
+  // deleted when the last one is released after it has been dropped.
+  // Handles are deleted by users without the DB mutex, so references may
+  // be taken and released from any thread.
+  void Ref() { refs_.fetch_add(1, std::memory_order_relaxed); }
+  void Unref();
+
+ private:
+  friend class ColumnFamilySet;
+
+  ColumnFamilyData(uint32_t id, const std::string& name,
+                   const Options& options)
+      : id_(id), name_(name), options_(options), dropped_(false), refs_(0) {}
+  ~ColumnFamilyData() { assert(refs_.load(std::memory_order_relaxed) == 0); }
+
+  const uint32_t id_;
+  const std::string name_;
+  const Options options_;
+  bool dropped_;
+  std::atomic<int> refs_;
+};
+
+class ColumnFamilySet {
+ public:
+  // Creates the default column family with "db_options".
+  explicit ColumnFamilySet(const Options& db_options);
+
+  ColumnFamilySet(const ColumnFamilySet&) = delete;
+  ColumnFamilySet& operator=(const ColumnFamilySet&) = delete;
+
+  ~ColumnFamilySet();
+
+  ColumnFamilyData* GetDefault() const { return default_; }
+
+  // Return the live family with that name / id, or nullptr.
+  ColumnFamilyData* GetByName(const std::string& name) const;
+  ColumnFamilyData* GetById(uint32_t id) const;
+
+  // Add a family named "name", assigning it the next unused id, or "id"
+  // when replaying the MANIFEST.  Fails if the name is already in use.
+  Status Create(const std::string& name, const Options& cf_options,
+                ColumnFamilyData** result);
+  Status CreateWithId(uint32_t id, const std::string& name,
+                      const Options& cf_options, ColumnFamilyData** result);
+
+  // Remove "cfd" from the set.  The default family can not be dropped.
+  Status Drop(ColumnFamilyData* cfd);
+
+  // Names of the live families, default first.
+  std::vector<std::string> GetNames() const;
+
+  // Id the next created family gets.  Persisted in the MANIFEST so ids of
+  // dropped families are never reused.
+  uint32_t next_id() const { return next_id_; }
+
+ private:
+  const Options db_options_;
+  ColumnFamilyData* default_;
+  std::map<uint32_t, ColumnFamilyData*> by_id_;
+  std::map<std::string, uint32_t> by_name_;
+  uint32_t next_id_;
+};
+
+// The ColumnFamilyHandle the DB hands out.  Holds a reference to the
+// family so its state outlives a concurrent DropColumnFamily().
+class ColumnFamilyHandleImpl : public ColumnFamilyHandle {
+ public:
+  explicit ColumnFamilyHandleImpl(ColumnFamilyData* cfd) : cfd_(cfd) {
+    cfd_->Ref();
+  }
+  ~ColumnFamilyHandleImpl() override { cfd_->Unref(); }
+
+  const std::string& GetName() const override { return cfd_->name(); }
+  uint32_t GetID() const override { return cfd_->id(); }
+  const Comparator* GetComparator() const override {
+    return cfd_->options().comparator;
+  }
+
+  ColumnFamilyData* cfd() const { return cfd_; }
+
+ private:
+  ColumnFamilyData* const cfd_;
+};
+
+}  // namespace czy_leveldb
@@ -0,0 +1,118 @@
+#include "db/column_family.h"
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "db/dbformat.h"
+#include "gtest/gtest.h"
+
+namespace czy_leveldb {
+
+TEST(ColumnFamilyTest, RecordTagsCarryValueType) {
+  ASSERT_EQ(0x10 | kTypeDeletion, kTypeColumnFamilyDeletion);
+  ASSERT_EQ(0x10 | kTypeValue, kTypeColumnFamilyValue);
+  ASSERT_EQ(0x10 | kTypeRangeDeletion, kTypeColumnFamilyRangeDeletion);
+  ASSERT_EQ(0x10 | kTypeMerge, kTypeColumnFamilyMerge);
+}
+
+TEST(ColumnFamilyTest, SanitizeTakesDBWideFields) {
+  Options db_options;
+  db_options.create_if_missing = true;
+  db_options.max_open_files = 123;
+  Options cf_options;
+  cf_options.write_buffer_size = 1 << 20;
+  cf_options.max_open_files = 7;
+
+  Options result = SanitizeColumnFamilyOptions(db_options, cf_options);
+  ASSERT_TRUE(result.create_if_missing);
+  ASSERT_EQ(123, result.max_open_files);
+  ASSERT_EQ(size_t{1} << 20, result.write_buffer_size);
+}
+
+TEST(ColumnFamilyTest, CreateLookupDrop) {
+  ColumnFamilySet set{Options()};
+  ColumnFamilyData* def = set.GetDefault();
+  ASSERT_EQ(kDefaultColumnFamilyId, def->id());
+  ASSERT_EQ(kDefaultColumnFamilyName, def->name());
+
+  ColumnFamilyData* a;
+  ColumnFamilyData* b;
+  ASSERT_TRUE(set.Create("a", Options(), &a).ok());
+  ASSERT_TRUE(set.Create("b", Options(), &b).ok());
+  ASSERT_EQ(1u, a->id());
+  ASSERT_EQ(2u, b->id());
+  ASSERT_EQ(a, set.GetByName("a"));
+  ASSERT_EQ(b, set.GetById(2));
+  ASSERT_EQ(nullptr, set.GetByName("c"));
+  ASSERT_EQ((std::vector<std::string>{"default", "a", "b"}), set.GetNames());
+
+  ColumnFamilyData* dup;
+  ASSERT_TRUE(set.Create("a", Options(), &dup).IsInvalidArgument());
+  ASSERT_TRUE(set.Create("", Options(), &dup).IsInvalidArgument());
+
+  ASSERT_TRUE(set.Drop(def).IsInvalidArgument());
+  ASSERT_TRUE(set.Drop(a).ok());
+  ASSERT_EQ(nullptr, set.GetByName("a"));
+  ASSERT_EQ((std::vector<std::string>{"default", "b"}), set.GetNames());
+
+  // Ids of dropped families are not reused, but names are.
+  ColumnFamilyData* again;
+  ASSERT_TRUE(set.Create("a", Options(), &again).ok());
+  ASSERT_EQ(3u, again->id());
+  ASSERT_EQ(4u, set.next_id());
+}
+
+TEST(ColumnFamilyTest, CreateWithIdFromManifest) {
+  ColumnFamilySet set{Options()};
+  ColumnFamilyData* cfd;
+  ASSERT_TRUE(set.CreateWithId(9, "replayed", Options(), &cfd).ok());
+  ASSERT_EQ(10u, set.next_id());
+  ASSERT_TRUE(set.CreateWithId(9, "other", Options(), &cfd).IsCorruption());
+}
+
+TEST(ColumnFamilyTest, HandleOutlivesDrop) {
+  ColumnFamilySet set{Options()};
+  ColumnFamilyData* cfd;
+  ASSERT_TRUE(set.Create("logs", Options(), &cfd).ok());
+  std::unique_ptr<ColumnFamilyHandleImpl> handle(
+      new ColumnFamilyHandleImpl(cfd));
+
+  ASSERT_TRUE(set.Drop(cfd).ok());
+  ASSERT_TRUE(set.Drop(cfd).IsInvalidArgument());
+  // The handle's reference keeps the family readable.
+  ASSERT_TRUE(handle->cfd()->dropped());
+  ASSERT_EQ("logs", handle->GetName());
+  ASSERT_EQ(1u, handle->GetID());
+  ASSERT_EQ(BytewiseComparator(), handle->GetComparator());
+}
+
+TEST(ColumnFamilyTest, HandlesReleasedConcurrently) {
+  ColumnFamilySet set{Options()};
+  ColumnFamilyData* cfd;
+  ASSERT_TRUE(set.Create("logs", Options(), &cfd).ok());
+  const int kThreads = 8;
+  std::vector<std::unique_ptr<ColumnFamilyHandleImpl>> handles;
+  for (int i = 0; i < kThreads; i++) {
+    handles.emplace_back(new ColumnFamilyHandleImpl(cfd));
+  }
+  ASSERT_TRUE(set.Drop(cfd).ok());
+
+  // Each thread takes and releases references of its own before
+  // deleting its handle; the last one out deletes the family.
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreads; i++) {
+    threads.emplace_back([&handles, i] {
+      for (int j = 0; j < 1000; j++) {
+        ColumnFamilyHandleImpl extra(handles[i]->cfd());
+      }
+      handles[i].reset();
+    });
+  }
+  for (std::thread& t : threads) {
+    t.join();
+  }
+}
+
+}  // namespace czy_leveldb
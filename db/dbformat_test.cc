@@ -0,0 +1,113 @@
+#include "db/dbformat.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace czy_leveldb {
+
+namespace {
+
+std::string IKey(const std::string& user_key, uint64_t seq, ValueType vt) {
+  std::string encoded;
+  AppendInternalKey(&encoded, ParsedInternalKey(user_key, seq, vt));
+  return encoded;
+}
+
+// Remembers the keys it was given and matches exactly those.
+class RecordingPolicy : public FilterPolicy {
+ public:
+  const char* Name() const override { return "test.Recording"; }
+
+  void CreateFilter(const Slice* keys, int n,
+                    std::string* dst) const override {
+    for (int i = 0; i < n; i++) {
+      dst->append(keys[i].data(), keys[i].size());
+      dst->push_back('\0');
+    }
+  }
+
+  bool KeyMayMatch(const Slice& key, const Slice& filter) const override {
+    std::string needle = key.ToString();
+    needle.push_back('\0');
+    const std::string f = filter.ToString();
+    return f.compare(0, needle.size(), needle) == 0 ||
+           f.find('\0' + needle) != std::string::npos;
+  }
+};
+
+}  // namespace
+
+TEST(FormatTest, InternalKeyEncodeDecode) {
+  const char* keys[] = {"", "k", "hello", "longggggggggggggggggggggg"};
+  const uint64_t seq[] = {1,
+                          2,
+                          3,
+                          (1ull << 8) - 1,
+                          1ull << 8,
+                          (1ull << 8) + 1,
+                          (1ull << 16) - 1,
+                          1ull << 16,
+                          (1ull << 32) - 1,
+                          1ull << 32,
+                          kMaxSequenceNumber};
+  for (const char* key : keys) {
+    for (uint64_t s : seq) {
+      for (ValueType vt : {kTypeValue, kTypeDeletion, kTypeMerge}) {
+        std::string encoded = IKey(key, s, vt);
+        ParsedInternalKey decoded("", 0, kTypeValue);
+        ASSERT_TRUE(ParseInternalKey(encoded, &decoded));
+        ASSERT_EQ(key, decoded.user_key.ToString());
+        ASSERT_EQ(s, decoded.sequence);
+        ASSERT_EQ(vt, decoded.type);
+        ASSERT_EQ(key, ExtractUserKey(encoded).ToString());
+      }
+    }
+  }
+  ParsedInternalKey decoded;
+  ASSERT_FALSE(ParseInternalKey(Slice("bar"), &decoded));
+}
+
+TEST(FormatTest, InternalKeyOrdering) {
+  InternalKeyComparator cmp(BytewiseComparator());
+  ASSERT_LT(cmp.Compare(IKey("a", 100, kTypeValue), IKey("b", 1, kTypeValue)),
+            0);
+  // Newer versions of a user key sort first.
+  ASSERT_LT(cmp.Compare(IKey("a", 100, kTypeValue), IKey("a", 99, kTypeValue)),
+            0);
+  ASSERT_EQ(0,
+            cmp.Compare(IKey("a", 7, kTypeValue), IKey("a", 7, kTypeValue)));
+}
+
+TEST(FormatTest, InternalKeyShortSeparator) {
+  InternalKeyComparator cmp(BytewiseComparator());
+  std::string start = IKey("foo", 100, kTypeValue);
+  cmp.FindShortestSeparator(&start, IKey("hello", 200, kTypeValue));
+  ASSERT_EQ(IKey("g", kMaxSequenceNumber, kValueTypeForSeek), start);
+
+  std::string key = IKey("foo", 100, kTypeValue);
+  cmp.FindShortSuccessor(&key);
+  ASSERT_EQ(IKey("g", kMaxSequenceNumber, kValueTypeForSeek), key);
+}
+
+TEST(FormatTest, InternalFilterPolicyUsesUserKeys) {
+  RecordingPolicy user_policy;
+  InternalFilterPolicy policy(&user_policy);
+  ASSERT_STREQ("test.Recording", policy.Name());
+
+  std::vector<std::string> ikeys = {IKey("apple", 5, kTypeValue),
+                                    IKey("banana", 9, kTypeDeletion)};
+  std::vector<Slice> keys(ikeys.begin(), ikeys.end());
+  std::string filter;
+  policy.CreateFilter(keys.data(), static_cast<int>(keys.size()), &filter);
+  // The user policy saw user keys only.
+  ASSERT_EQ(std::string("apple\0banana\0", 13), filter);
+
+  // Any sequence number of a user key matches.
+  ASSERT_TRUE(policy.KeyMayMatch(IKey("apple", 1000, kTypeValue), filter));
+  ASSERT_TRUE(policy.KeyMayMatch(IKey("banana", 1, kTypeValue), filter));
+  ASSERT_FALSE(policy.KeyMayMatch(IKey("cherry", 9, kTypeValue), filter));
+}
+
+}  // namespace czy_leveldb
@@ -0,0 +1,183 @@
+#include <atomic>
+#include <vector>
+
+#include "db/inlineskiplist.h"
+#include "db/sorted_vector_iterator.h"
+#include "leveldb/memtablerep.h"
+#include "leveldb/options.h"
+#include "leveldb/slice_transform.h"
+#include "util/concurrent_arena.h"
+#include "util/hash.h"
+
+namespace czy_leveldb {
+
+namespace {
+
+class HashSkipListRep : public MemTableRep {
+ public:
+  HashSkipListRep(const KeyComparator& cmp, const Options& options,
+                  const SliceTransform* transform, size_t bucket_count)
+      : cmp_(cmp),
+        transform_(transform),
+        bucket_count_(bucket_count),
+        arena_(ConcurrentArena::kDefaultBlockSize, options.memtable_huge_page_size),
+        buckets_(new std::atomic<Bucket*>[bucket_count]),
+        allocator_(cmp, &arena_) {
+    for (size_t i = 0; i < bucket_count_; i++) {
+      buckets_[i].store(nullptr, std::memory_order_relaxed);
+    }
+  }
+
+  ~HashSkipListRep() override {
+    for (size_t i = 0; i < bucket_count_; i++) {
+      delete buckets_[i].load(std::memory_order_relaxed);
+    }
+    delete[] buckets_;
+  }
+
+  KeyHandle Allocate(size_t len, char** buf) override {
+    *buf = allocator_.AllocateKey(len);
+    return static_cast<KeyHandle>(*buf);
+  }
+
+  void Insert(KeyHandle handle) override {
+    const char* entry = static_cast<const char*>(handle);
+    GetOrCreateBucket(UserKey(entry))->Insert(entry);
+  }
+
+  void InsertConcurrently(KeyHandle handle) override {
+    const char* entry = static_cast<const char*>(handle);
+    GetOrCreateBucket(UserKey(entry))->InsertConcurrently(entry);
+  }
+
+  bool Contains(const char* entry) const override {
+    Bucket* bucket = GetBucket(UserKey(entry));
+    return bucket != nullptr && bucket->Contains(entry);
+  }
+
+  size_t ApproximateMemoryUsage() override {
+    return arena_.MemoryUsage() + bucket_count_ * sizeof(buckets_[0]) +
+           num_buckets_.load(std::memory_order_relaxed) * sizeof(Bucket);
+  }
+
+  size_t ApproximateHugePageUsage() override { return arena_.HugePageUsage(); }
+
+  // Full, ordered iteration, as the flush needs: merge every bucket.
+  MemTableRep::Iterator* GetIterator() override {
+    std::vector<const char*>* entries = new std::vector<const char*>;
+    for (size_t i = 0; i < bucket_count_; i++) {
+      Bucket* bucket = buckets_[i].load(std::memory_order_acquire);
+      if (bucket != nullptr) {
+        Bucket::Iterator iter(bucket);
+        for (iter.SeekToFirst(); iter.Valid(); iter.Next()) {
+          entries->push_back(iter.key());
+        }
+      }
+    }
+    return new SortedVectorIterator(entries, cmp_, true);
+  }
+
+  MemTableRep::Iterator* GetPrefixIterator() override {
+    return new PrefixIterator(this);
+  }
+
+ private:
+  typedef InlineSkipList<const KeyComparator&> Bucket;
+
+  // Iterates over the bucket of the last Seek() target.
+  class PrefixIterator : public MemTableRep::Iterator {
+   public:
+    explicit PrefixIterator(const HashSkipListRep* rep)
+        : rep_(rep), iter_(&rep->allocator_) {}
+
+    bool Valid() const override { return iter_.Valid(); }
+    const char* key() const override { return iter_.key(); }
+    void Next() override { iter_.Next(); }
+    void Prev() override { iter_.Prev(); }
+
+    void Seek(const Slice& target) override {
+      // "target" is an internal key.
+      Bucket* bucket = rep_->GetBucket(
+          Slice(target.data(), target.size() - 8));
+      iter_ = Bucket::Iterator(bucket != nullptr ? bucket : &rep_->allocator_);
+      iter_.Seek(target);
+    }
+
+    // Only meaningful after a Seek(); otherwise yields nothing.
+    void SeekToFirst() override { iter_.SeekToFirst(); }
+    void SeekToLast() override { iter_.SeekToLast(); }
+
+   private:
+    const HashSkipListRep* const rep_;
+    Bucket::Iterator iter_;
+  };
+
+  Slice Prefix(const Slice& user_key) const {
+    return transform_->InDomain(user_key) ? transform_->Transform(user_key)
+                                          : user_key;
+  }
+
+  std::atomic<Bucket*>* BucketSlot(const Slice& user_key) const {
+    const Slice prefix = Prefix(user_key);
+    return &buckets_[Hash(prefix.data(), prefix.size(), 0) % bucket_count_];
+  }
+
+  Bucket* GetBucket(const Slice& user_key) const {
+    return BucketSlot(user_key)->load(std::memory_order_acquire);
+  }
+
+  Bucket* GetOrCreateBucket(const Slice& user_key) {
+    std::atomic<Bucket*>* slot = BucketSlot(user_key);
+    Bucket* bucket = slot->load(std::memory_order_acquire);
+    if (bucket == nullptr) {
+      Bucket* created = new Bucket(cmp_, &arena_);
+      if (slot->compare_exchange_strong(bucket, created)) {
+        num_buckets_.fetch_add(1, std::memory_order_relaxed);
+        bucket = created;
+      } else {
+        delete created;  // Another writer won; "bucket" holds its list
+      }
+    }
+    return bucket;
+  }
+
+  const KeyComparator& cmp_;
+  const SliceTransform* const transform_;
+  const size_t bucket_count_;
+  ConcurrentArena arena_;
+  std::atomic<Bucket*>* const buckets_;
+  std::atomic<size_t> num_buckets_{0};
+  // Never holds entries.  Allocates the nodes of every bucket, which all
+  // share arena_, before the entry's bucket is known; also serves as the
+  // empty list for seeks into a missing bucket.
+  Bucket allocator_;
+};
+
+class HashSkipListRepFactory : public MemTableRepFactory {
+ public:
+  HashSkipListRepFactory(const SliceTransform* transform, size_t bucket_count)
+      : transform_(transform), bucket_count_(bucket_count) {}
+
+  MemTableRep* CreateMemTableRep(const MemTableRep::KeyComparator& cmp,
+                                 const Options& options) override {
+    return new HashSkipListRep(cmp, options, transform_, bucket_count_);
+  }
+
+  const char* Name() const override { return "HashSkipListRepFactory"; }
+
+  bool IsInsertConcurrentlySupported() const override { return true; }
+
+ private:
+  const SliceTransform* const transform_;
+  const size_t bucket_count_;
+};
+
+}  // namespace
+
+MemTableRepFactory* NewHashSkipListRepFactory(
+    const SliceTransform* prefix_extractor, size_t bucket_count) {
+  return new HashSkipListRepFactory(prefix_extractor,
+                                    bucket_count > 0 ? bucket_count : 1);
+}
+
+}  // namespace czy_leveldb
@@ -0,0 +1,406 @@
+#pragma once
+// A skip list whose keys are stored inline with their node, and which
+// supports lock-free concurrent inserts.
+//
+// Layout of a node of height h, as allocated from the arena:
+//
+//    next_[h-1] ... next_[1] | next_[0] | key bytes
+//                              ^ Node*
+//
+// The links of the upper levels sit before the Node so that a node costs
+// only the links it uses, and the key follows immediately, usually in the
+// same cache line as next_[0].
+//
+// Thread safety
+// -------------
+// Reads need no locking and may run concurrently with inserts.  Insert()
+// needs external synchronization with other inserts; InsertConcurrently()
+// does not.  A concurrent insert links the node in level by level from the
+// bottom with compare-and-swap, recomputing the splice of a level when
+// another insert got in first.  Nodes are never deleted until the list is
+// destroyed.
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "util/concurrent_arena.h"
+
+namespace czy_leveldb {
+
+template <typename Comparator>
+class InlineSkipList {
+ private:
+  struct Node;
+
+ public:
+  static const int kMaxHeight = 12;
+
+  // Create a new list that orders keys with "cmp" and allocates nodes
+  // from "*arena", which must outlive the list.
+  InlineSkipList(Comparator cmp, ConcurrentArena* arena);
+
+  InlineSkipList(const InlineSkipList&) = delete;
+  InlineSkipList& operator=(const InlineSkipList&) = delete;
+
+  // Allocate a node for a key of "key_size" bytes and return a pointer to
+  // the key, which the caller fills in before passing it to Insert() or
+  // InsertConcurrently().  Thread-safe.
+  char* AllocateKey(size_t key_size);
+
+  // Insert a key returned by AllocateKey().
+  // REQUIRES: nothing that compares equal to key is in the list.
+  void Insert(const char* key);
+  void InsertConcurrently(const char* key);
+
+  // Returns true iff an entry that compares equal to key is in the list.
+  bool Contains(const char* key) const;
+
+  // Iteration over the contents of a skip list
+  class Iterator {
+   public:
+    // Initialize an iterator over the specified list.
+    // The returned iterator is not valid.
+    explicit Iterator(const InlineSkipList* list)
+        : list_(list), node_(nullptr) {}
+
+    bool Valid() const { return node_ != nullptr; }
+
+    // REQUIRES: Valid()
+    const char* key() const {
+      assert(Valid());
+      return node_->Key();
+    }
+
+    // REQUIRES: Valid()
+    void Next() {
+      assert(Valid());
+      node_ = node_->Next(0);
+    }
+
+    // REQUIRES: Valid()
+    void Prev() {
+      assert(Valid());
+      node_ = list_->FindLessThan(node_->Key());
+      if (node_ == list_->head_) {
+        node_ = nullptr;
+      }
+    }
+
+    // Advance to the first entry with a key >= target, where target is
+    // anything the comparator accepts as its second argument.
+    template <typename Target>
+    void Seek(const Target& target) {
+      node_ = list_->FindGreaterOrEqual(target);
+    }
+
+    void SeekToFirst() { node_ = list_->head_->Next(0); }
+
+    void SeekToLast() {
+      node_ = list_->FindLast();
+      if (node_ == list_->head_) {
+        node_ = nullptr;
+      }
+    }
+
+   private:
+    const InlineSkipList* list_;
+    Node* node_;
+  };
+
+ private:
+  int GetMaxHeight() const {
+    return max_height_.load(std::memory_order_relaxed);
+  }
+
+  int RandomHeight();
+
+  Node* AllocateNode(size_t key_size, int height);
+
+  bool Equal(const char* a, const char* b) const {
+    return compare_(a, b) == 0;
+  }
+
+  // True if key is greater than the key of "n".  A null n is considered
+  // infinite.
+  template <typename Target>
+  bool KeyIsAfterNode(const Target& key, Node* n) const {
+    return (n != nullptr) && (compare_(n->Key(), key) < 0);
+  }
+
+  template <typename Target>
+  Node* FindGreaterOrEqual(const Target& key) const;
+  Node* FindLessThan(const char* key) const;
+  Node* FindLast() const;
+
+  // Find the nodes at "level" between which "key" belongs, starting the
+  // search at "before", which must precede key.
+  void FindSpliceForLevel(const char* key, Node* before, int level,
+                          Node** out_prev, Node** out_next) const;
+
+  template <bool kConcurrent>
+  void DoInsert(const char* key);
+
+  Comparator const compare_;
+  ConcurrentArena* const arena_;
+  Node* const head_;
+
+  // Modified only by inserts.  Read racily by readers, but stale values
+  // are ok.
+  std::atomic<int> max_height_;  // Height of the entire list
+};
+
+template <typename Comparator>
+struct InlineSkipList<Comparator>::Node {
+  const char* Key() const { return reinterpret_cast<const char*>(&next_[1]); }
+
+  // The height is kept in the first link until the node is inserted.
+  void StashHeight(int height) {
+    static_assert(sizeof(int) <= sizeof(next_[0]), "link too small");
+    std::memcpy(static_cast<void*>(&next_[0]), &height, sizeof(int));
+  }
+  int UnstashHeight() const {
+    int height;
+    std::memcpy(&height, static_cast<const void*>(&next_[0]), sizeof(int));
+    return height;
+  }
+
+  // Accessors/mutators for links.  Wrapped in methods so we can add the
+  // appropriate barriers as necessary.  Level n is stored n slots before
+  // next_[0].
+  Node* Next(int n) {
+    assert(n >= 0);
+    // Use an 'acquire load' so that we observe a fully initialized
+    // version of the returned Node.
+    return (&next_[0] - n)->load(std::memory_order_acquire);
+  }
+  void SetNext(int n, Node* x) {
+    assert(n >= 0);
+    // Use a 'release store' so that anybody who reads through this
+    // pointer observes a fully initialized version of the inserted node.
+    (&next_[0] - n)->store(x, std::memory_order_release);
+  }
+  bool CASNext(int n, Node* expected, Node* x) {
+    assert(n >= 0);
+    return (&next_[0] - n)->compare_exchange_strong(expected, x);
+  }
+
+  // No-barrier variants that can be safely used in a few locations.
+  Node* NoBarrier_Next(int n) {
+    assert(n >= 0);
+    return (&next_[0] - n)->load(std::memory_order_relaxed);
+  }
+  void NoBarrier_SetNext(int n, Node* x) {
+    assert(n >= 0);
+    (&next_[0] - n)->store(x, std::memory_order_relaxed);
+  }
+
+ private:
+  // next_[0] is the lowest level link; the key follows it.
+  std::atomic<Node*> next_[1];
+};
+
+template <typename Comparator>
+InlineSkipList<Comparator>::InlineSkipList(Comparator cmp,
+                                           ConcurrentArena* arena)
+    : compare_(cmp),
+      arena_(arena),
+      head_(AllocateNode(0, kMaxHeight)),
+      max_height_(1) {
+  for (int i = 0; i < kMaxHeight; i++) {
+    head_->SetNext(i, nullptr);
+  }
+}
+
+template <typename Comparator>
+int InlineSkipList<Comparator>::RandomHeight() {
+  // Each thread has its own generator, so concurrent inserts do not share
+  // state.  Increase height with probability 1 in kBranching.
+  static const unsigned int kBranching = 4;
+  static thread_local uint32_t seed =
+      static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&seed)) | 1;
+  int height = 1;
+  while (height < kMaxHeight) {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    if (seed % kBranching != 0) {
+      break;
+    }
+    height++;
+  }
+  assert(height > 0);
+  assert(height <= kMaxHeight);
+  return height;
+}
+
+template <typename Comparator>
+typename InlineSkipList<Comparator>::Node*
+InlineSkipList<Comparator>::AllocateNode(size_t key_size, int height) {
+  const size_t prefix = sizeof(std::atomic<Node*>) * (height - 1);
+  char* raw = arena_->AllocateAligned(prefix + sizeof(Node) + key_size);
+  Node* x = reinterpret_cast<Node*>(raw + prefix);
+  x->StashHeight(height);
+  return x;
+}
+
+template <typename Comparator>
+char* InlineSkipList<Comparator>::AllocateKey(size_t key_size) {
+  return const_cast<char*>(AllocateNode(key_size, RandomHeight())->Key());
+}
+
+template <typename Comparator>
+template <typename Target>
+typename InlineSkipList<Comparator>::Node*
+InlineSkipList<Comparator>::FindGreaterOrEqual(const Target& key) const {
+  Node* x = head_;
+  int level = GetMaxHeight() - 1;
+  while (true) {
+    Node* next = x->Next(level);
+    if (KeyIsAfterNode(key, next)) {
+      // Keep searching in this list
+      x = next;
+    } else if (level == 0) {
+      return next;
+    } else {
+      // Switch to next list
+      level--;
+    }
+  }
+}
+
+template <typename Comparator>
+typename InlineSkipList<Comparator>::Node*
+InlineSkipList<Comparator>::FindLessThan(const char* key) const {
+  Node* x = head_;
+  int level = GetMaxHeight() - 1;
+  while (true) {
+    assert(x == head_ || compare_(x->Key(), key) < 0);
+    Node* next = x->Next(level);
+    if (next == nullptr || compare_(next->Key(), key) >= 0) {
+      if (level == 0) {
+        return x;
+      } else {
+        // Switch to next list
+        level--;
+      }
+    } else {
+      x = next;
+    }
+  }
+}
+
+template <typename Comparator>
+typename InlineSkipList<Comparator>::Node*
+InlineSkipList<Comparator>::FindLast() const {
+  Node* x = head_;
+  int level = GetMaxHeight() - 1;
+  while (true) {
+    Node* next = x->Next(level);
+    if (next == nullptr) {
+      if (level == 0) {
+        return x;
+      } else {
+        // Switch to next list
+        level--;
+      }
+    } else {
+      x = next;
+    }
+  }
+}
+
+template <typename Comparator>
+void InlineSkipList<Comparator>::FindSpliceForLevel(const char* key,
+                                                    Node* before, int level,
+                                                    Node** out_prev,
+                                                    Node** out_next) const {
+  while (true) {
+    Node* next = before->Next(level);
+    if (!KeyIsAfterNode(key, next)) {
+      *out_prev = before;
+      *out_next = next;
+      return;
+    }
+    before = next;
+  }
+}
+
+template <typename Comparator>
+void InlineSkipList<Comparator>::Insert(const char* key) {
+  DoInsert<false>(key);
+}
+
+template <typename Comparator>
+void InlineSkipList<Comparator>::InsertConcurrently(const char* key) {
+  DoInsert<true>(key);
+}
+
+template <typename Comparator>
+template <bool kConcurrent>
+void InlineSkipList<Comparator>::DoInsert(const char* key) {
+  Node* x = reinterpret_cast<Node*>(const_cast<char*>(key)) - 1;
+  const int height = x->UnstashHeight();
+  assert(height >= 1 && height <= kMaxHeight);
+
+  int max_height = GetMaxHeight();
+  while (height > max_height) {
+    if (kConcurrent) {
+      if (max_height_.compare_exchange_weak(max_height, height)) {
+        max_height = height;
+        break;
+      }
+      // max_height was reloaded by the failed exchange
+    } else {
+      // It is ok to mutate max_height_ without any synchronization with
+      // concurrent readers.  A concurrent reader that observes the new
+      // value will see either the old value of new level pointers from
+      // head_ (nullptr), or a new value set in the loop below.
+      max_height_.store(height, std::memory_order_relaxed);
+      max_height = height;
+    }
+  }
+
+  // Find the splice at every level top-down, each search starting from
+  // the predecessor found one level up.
+  Node* prev[kMaxHeight];
+  Node* next[kMaxHeight];
+  Node* before = head_;
+  for (int i = max_height - 1; i >= 0; i--) {
+    FindSpliceForLevel(key, before, i, &prev[i], &next[i]);
+    before = prev[i];
+  }
+  // Duplicate insertion is not allowed.
+  assert(next[0] == nullptr || !Equal(key, next[0]->Key()));
+
+  // Link bottom-up, so a node reachable on some level is always reachable
+  // on every level below it.
+  for (int i = 0; i < height; i++) {
+    if (kConcurrent) {
+      while (true) {
+        x->NoBarrier_SetNext(i, next[i]);
+        if (prev[i]->CASNext(i, next[i], x)) {
+          break;
+        }
+        // Another insert changed prev[i]'s link; recompute the splice for
+        // this level from prev[i], which still precedes key.
+        FindSpliceForLevel(key, prev[i], i, &prev[i], &next[i]);
+      }
+    } else {
+      // NoBarrier_SetNext() suffices since we will add a barrier when
+      // we publish a pointer to "x" in prev[i].
+      x->NoBarrier_SetNext(i, next[i]);
+      prev[i]->SetNext(i, x);
+    }
+  }
+}
+
+template <typename Comparator>
+bool InlineSkipList<Comparator>::Contains(const char* key) const {
+  Node* x = FindGreaterOrEqual(key);
+  return x != nullptr && Equal(key, x->Key());
+}
+
+}  // namespace czy_leveldb
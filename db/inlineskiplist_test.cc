@@ -0,0 +1,247 @@
+#include "db/inlineskiplist.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "util/coding.h"
+#include "util/concurrent_arena.h"
+
+namespace czy_leveldb {
+
+typedef uint64_t Key;
+
+namespace {
+
+// Keys are stored as 8-byte fixed64 values.
+struct TestComparator {
+  static Key Decode(const char* p) { return DecodeFixed64(p); }
+
+  int operator()(const char* a, const char* b) const {
+    return Compare(Decode(a), Decode(b));
+  }
+  int operator()(const char* a, const Key& b) const {
+    return Compare(Decode(a), b);
+  }
+
+  static int Compare(Key a, Key b) {
+    if (a < b) {
+      return -1;
+    } else if (a > b) {
+      return +1;
+    } else {
+      return 0;
+    }
+  }
+};
+
+typedef InlineSkipList<TestComparator> TestInlineSkipList;
+
+void InsertKey(TestInlineSkipList* list, Key key, bool concurrently) {
+  char* buf = list->AllocateKey(sizeof(Key));
+  EncodeFixed64(buf, key);
+  if (concurrently) {
+    list->InsertConcurrently(buf);
+  } else {
+    list->Insert(buf);
+  }
+}
+
+bool ListContains(const TestInlineSkipList& list, Key key) {
+  char buf[sizeof(Key)];
+  EncodeFixed64(buf, key);
+  return list.Contains(buf);
+}
+
+}  // namespace
+
+TEST(InlineSkipListTest, Empty) {
+  ConcurrentArena arena;
+  TestInlineSkipList list(TestComparator(), &arena);
+  ASSERT_FALSE(ListContains(list, 10));
+
+  TestInlineSkipList::Iterator iter(&list);
+  ASSERT_FALSE(iter.Valid());
+  iter.SeekToFirst();
+  ASSERT_FALSE(iter.Valid());
+  iter.Seek(Key(100));
+  ASSERT_FALSE(iter.Valid());
+  iter.SeekToLast();
+  ASSERT_FALSE(iter.Valid());
+}
+
+TEST(InlineSkipListTest, InsertAndLookup) {
+  const int N = 2000;
+  const Key R = 5000;
+  std::mt19937 rnd(1000);
+  std::set<Key> keys;
+  ConcurrentArena arena;
+  TestInlineSkipList list(TestComparator(), &arena);
+  for (int i = 0; i < N; i++) {
+    Key key = rnd() % R;
+    if (keys.insert(key).second) {
+      InsertKey(&list, key, false);
+    }
+  }
+
+  for (Key i = 0; i < R; i++) {
+    ASSERT_EQ(keys.count(i) == 1, ListContains(list, i)) << i;
+  }
+
+  // Simple iterator tests
+  {
+    TestInlineSkipList::Iterator iter(&list);
+    iter.Seek(Key(0));
+    ASSERT_TRUE(iter.Valid());
+    ASSERT_EQ(*(keys.begin()), TestComparator::Decode(iter.key()));
+
+    iter.SeekToFirst();
+    ASSERT_TRUE(iter.Valid());
+    ASSERT_EQ(*(keys.begin()), TestComparator::Decode(iter.key()));
+
+    iter.SeekToLast();
+    ASSERT_TRUE(iter.Valid());
+    ASSERT_EQ(*(keys.rbegin()), TestComparator::Decode(iter.key()));
+  }
+
+  // Forward iteration test
+  for (Key i = 0; i < R; i++) {
+    TestInlineSkipList::Iterator iter(&list);
+    iter.Seek(i);
+
+    // Compare against model iterator
+    std::set<Key>::iterator model_iter = keys.lower_bound(i);
+    for (int j = 0; j < 3; j++) {
+      if (model_iter == keys.end()) {
+        ASSERT_FALSE(iter.Valid());
+        break;
+      } else {
+        ASSERT_TRUE(iter.Valid());
+        ASSERT_EQ(*model_iter, TestComparator::Decode(iter.key()));
+        ++model_iter;
+        iter.Next();
+      }
+    }
+  }
+
+  // Backward iteration test
+  {
+    TestInlineSkipList::Iterator iter(&list);
+    iter.SeekToLast();
+
+    // Compare against model iterator
+    for (std::set<Key>::reverse_iterator model_iter = keys.rbegin();
+         model_iter != keys.rend(); ++model_iter) {
+      ASSERT_TRUE(iter.Valid());
+      ASSERT_EQ(*model_iter, TestComparator::Decode(iter.key()));
+      iter.Prev();
+    }
+    ASSERT_FALSE(iter.Valid());
+  }
+}
+
+// Several threads insert interleaved keys at once; every key must end up
+// linked, in order, on every level it was allocated for.
+TEST(InlineSkipListTest, ConcurrentInsert) {
+  const int kThreads = 8;
+  const int kKeysPerThread = 5000;
+  ConcurrentArena arena;
+  TestInlineSkipList list(TestComparator(), &arena);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; t++) {
+    threads.emplace_back([&list, t]() {
+      std::mt19937 rnd(t);
+      std::vector<Key> keys;
+      for (int i = 0; i < kKeysPerThread; i++) {
+        keys.push_back(static_cast<Key>(i) * kThreads + t);
+      }
+      std::shuffle(keys.begin(), keys.end(), rnd);
+      for (Key key : keys) {
+        InsertKey(&list, key, true);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  TestInlineSkipList::Iterator iter(&list);
+  Key expected = 0;
+  for (iter.SeekToFirst(); iter.Valid(); iter.Next()) {
+    ASSERT_EQ(expected, TestComparator::Decode(iter.key()));
+    expected++;
+  }
+  ASSERT_EQ(static_cast<Key>(kThreads) * kKeysPerThread, expected);
+  // Lookups go through the upper levels.
+  for (Key key = 0; key < expected; key += 7) {
+    ASSERT_TRUE(ListContains(list, key)) << key;
+  }
+  ASSERT_FALSE(ListContains(list, expected));
+}
+
+// Readers scanning while writers insert concurrently must always see a
+// sorted list that holds at least every key inserted before the scan
+// began.
+TEST(InlineSkipListTest, ConcurrentReadDuringInsert) {
+  const int kWriters = 4;
+  const int kKeysPerWriter = 5000;
+  ConcurrentArena arena;
+  TestInlineSkipList list(TestComparator(), &arena);
+  // Keys below "floor" were inserted by the seeding below, before any
+  // reader started.
+  const Key floor = 1000;
+  for (Key key = 0; key < floor; key++) {
+    InsertKey(&list, key * 2, false);
+  }
+
+  std::atomic<bool> done(false);
+  std::thread reader([&]() {
+    while (!done.load(std::memory_order_acquire)) {
+      TestInlineSkipList::Iterator iter(&list);
+      size_t seeded = 0;
+      bool first = true;
+      Key last = 0;
+      for (iter.SeekToFirst(); iter.Valid(); iter.Next()) {
+        const Key key = TestComparator::Decode(iter.key());
+        ASSERT_TRUE(first || last < key);
+        if (key < floor * 2 && key % 2 == 0) {
+          seeded++;
+        }
+        first = false;
+        last = key;
+      }
+      ASSERT_EQ(floor, seeded);
+    }
+  });
+
+  std::vector<std::thread> writers;
+  for (int t = 0; t < kWriters; t++) {
+    writers.emplace_back([&list, t]() {
+      for (int i = 0; i < kKeysPerWriter; i++) {
+        // Odd keys interleave with the seeded ones; the rest land above.
+        const Key key = (static_cast<Key>(i) * kWriters + t) * 2 + 1;
+        InsertKey(&list, key, true);
+      }
+    });
+  }
+  for (std::thread& writer : writers) {
+    writer.join();
+  }
+  done.store(true, std::memory_order_release);
+  reader.join();
+
+  size_t count = 0;
+  TestInlineSkipList::Iterator iter(&list);
+  for (iter.SeekToFirst(); iter.Valid(); iter.Next()) {
+    count++;
+  }
+  ASSERT_EQ(floor + kWriters * kKeysPerWriter, count);
+}
+
+}  // namespace czy_leveldb
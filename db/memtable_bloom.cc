@@ -0,0 +1,57 @@
+#include "db/memtable_bloom.h"
+
+#include <algorithm>
+
+#include "leveldb/options.h"
+#include "leveldb/slice_transform.h"
+
+namespace czy_leveldb {
+
+MemTableBloom* MemTableBloom::Create(const Options& options) {
+  if (options.memtable_prefix_bloom_size_ratio <= 0 ||
+      (options.prefix_extractor == nullptr &&
+       !options.memtable_whole_key_filtering)) {
+    return nullptr;
+  }
+  const double ratio = std::min(options.memtable_prefix_bloom_size_ratio, 0.25);
+  const size_t total_bits =
+      static_cast<size_t>(options.write_buffer_size * ratio) * 8;
+  return new MemTableBloom(total_bits, options.prefix_extractor,
+                           options.memtable_whole_key_filtering);
+}
+
+MemTableBloom::MemTableBloom(size_t total_bits,
+                             const SliceTransform* prefix_extractor,
+                             bool whole_key_filtering)
+    : prefix_extractor_(prefix_extractor),
+      whole_key_filtering_(whole_key_filtering),
+      bloom_(std::max<size_t>(total_bits, 1)) {}
+
+void MemTableBloom::Add(const Slice& user_key) {
+  // Prefixes and whole keys share one filter.
+  if (prefix_extractor_ != nullptr && prefix_extractor_->InDomain(user_key)) {
+    bloom_.AddConcurrently(prefix_extractor_->Transform(user_key));
+  }
+  if (whole_key_filtering_) {
+    bloom_.AddConcurrently(user_key);
+  }
+}
+
+bool MemTableBloom::MayContain(const Slice& user_key) const {
+  if (whole_key_filtering_) {
+    return bloom_.MayContain(user_key);
+  }
+  if (prefix_extractor_ != nullptr && prefix_extractor_->InDomain(user_key)) {
+    return bloom_.MayContain(prefix_extractor_->Transform(user_key));
+  }
+  return true;
+}
+
+bool MemTableBloom::MayContainPrefix(const Slice& prefix) const {
+  if (prefix_extractor_ == nullptr) {
+    return true;
+  }
+  return bloom_.MayContain(prefix);
+}
+
+}  // namespace czy_leveldb
@@ -0,0 +1,47 @@
+#pragma once
+// The optional Bloom filter of a memtable (see
+// Options::memtable_prefix_bloom_size_ratio).  The memtable adds the user
+// key of every entry it inserts and asks the filter before searching its
+// rep, so Get()s of keys it does not hold skip the skip list walk.
+
+#include <cstddef>
+
+#include "leveldb/slice.h"
+#include "util/dynamic_bloom.h"
+
+namespace czy_leveldb {
+
+struct Options;
+class SliceTransform;
+
+class MemTableBloom {
+ public:
+  // Return a new filter sized for one memtable of "options", or nullptr
+  // if "options" do not enable one.
+  static MemTableBloom* Create(const Options& options);
+
+  MemTableBloom(const MemTableBloom&) = delete;
+  MemTableBloom& operator=(const MemTableBloom&) = delete;
+
+  // Record the user key of an inserted entry.  Thread-safe.
+  void Add(const Slice& user_key);
+
+  // Returns false if the memtable certainly holds no entry of "user_key".
+  bool MayContain(const Slice& user_key) const;
+
+  // Returns false if the memtable certainly holds no key with "prefix",
+  // as returned by the prefix extractor, so a prefix Seek() can skip it.
+  bool MayContainPrefix(const Slice& prefix) const;
+
+  size_t MemoryUsage() const { return bloom_.MemoryUsage(); }
+
+ private:
+  MemTableBloom(size_t total_bits, const SliceTransform* prefix_extractor,
+                bool whole_key_filtering);
+
+  const SliceTransform* const prefix_extractor_;  // May be null
+  const bool whole_key_filtering_;
+  DynamicBloom bloom_;
+};
+
+}  // namespace czy_leveldb
@@ -0,0 +1,74 @@
+#include "db/memtable_bloom.h"
+
+#include <memory>
+
+#include "gtest/gtest.h"
+#include "leveldb/options.h"
+#include "leveldb/slice_transform.h"
+
+namespace czy_leveldb {
+
+TEST(MemTableBloomTest, DisabledByDefault) {
+  Options options;
+  ASSERT_EQ(nullptr, MemTableBloom::Create(options));
+
+  // A ratio alone is not enough: there is nothing to filter on.
+  options.memtable_prefix_bloom_size_ratio = 0.1;
+  ASSERT_EQ(nullptr, MemTableBloom::Create(options));
+}
+
+TEST(MemTableBloomTest, WholeKey) {
+  Options options;
+  options.write_buffer_size = 64 << 10;
+  options.memtable_prefix_bloom_size_ratio = 0.1;
+  options.memtable_whole_key_filtering = true;
+  std::unique_ptr<MemTableBloom> bloom(MemTableBloom::Create(options));
+  ASSERT_NE(nullptr, bloom);
+  // 10% of the write buffer, in bits.
+  ASSERT_GE(bloom->MemoryUsage(), (64u << 10) / 10);
+
+  bloom->Add("apple");
+  bloom->Add("banana");
+  ASSERT_TRUE(bloom->MayContain("apple"));
+  ASSERT_TRUE(bloom->MayContain("banana"));
+  ASSERT_FALSE(bloom->MayContain("cherry"));
+  // Without a prefix extractor prefix seeks are never filtered.
+  ASSERT_TRUE(bloom->MayContainPrefix("zzz"));
+}
+
+TEST(MemTableBloomTest, PrefixOnly) {
+  std::unique_ptr<const SliceTransform> prefix(NewFixedPrefixTransform(3));
+  Options options;
+  options.memtable_prefix_bloom_size_ratio = 0.1;
+  options.prefix_extractor = prefix.get();
+  std::unique_ptr<MemTableBloom> bloom(MemTableBloom::Create(options));
+  ASSERT_NE(nullptr, bloom);
+
+  bloom->Add("abc-1");
+  bloom->Add("x");  // Outside the prefix domain
+  ASSERT_TRUE(bloom->MayContainPrefix("abc"));
+  ASSERT_FALSE(bloom->MayContainPrefix("xyz"));
+  // Gets are answered by the key's prefix.
+  ASSERT_TRUE(bloom->MayContain("abc-2"));
+  ASSERT_FALSE(bloom->MayContain("xyz-1"));
+  // Keys outside the domain can not be filtered.
+  ASSERT_TRUE(bloom->MayContain("q"));
+}
+
+TEST(MemTableBloomTest, PrefixAndWholeKey) {
+  std::unique_ptr<const SliceTransform> prefix(NewFixedPrefixTransform(3));
+  Options options;
+  options.memtable_prefix_bloom_size_ratio = 0.1;
+  options.prefix_extractor = prefix.get();
+  options.memtable_whole_key_filtering = true;
+  std::unique_ptr<MemTableBloom> bloom(MemTableBloom::Create(options));
+  ASSERT_NE(nullptr, bloom);
+
+  bloom->Add("abc-1");
+  ASSERT_TRUE(bloom->MayContainPrefix("abc"));
+  ASSERT_TRUE(bloom->MayContain("abc-1"));
+  // Same prefix, but the whole key was never added.
+  ASSERT_FALSE(bloom->MayContain("abc-2"));
+}
+
+}  // namespace czy_leveldb
@@ -0,0 +1,221 @@
+#include "leveldb/memtablerep.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "db/dbformat.h"
+#include "gtest/gtest.h"
+#include "leveldb/comparator.h"
+#include "leveldb/options.h"
+#include "leveldb/slice_transform.h"
+#include "util/coding.h"
+
+namespace czy_leveldb {
+
+namespace {
+
+// Orders memtable entries (length prefixed internal key, then value) by
+// internal key, as the memtable does.
+class EntryComparator : public MemTableRep::KeyComparator {
+ public:
+  EntryComparator() : icmp_(BytewiseComparator()) {}
+
+  int operator()(const char* a, const char* b) const override {
+    return icmp_.Compare(InternalKeyOf(a), InternalKeyOf(b));
+  }
+
+  int operator()(const char* entry, const Slice& key) const override {
+    return icmp_.Compare(InternalKeyOf(entry), key);
+  }
+
+  static Slice InternalKeyOf(const char* entry) {
+    uint32_t len;
+    const char* p = GetVarint32Ptr(entry, entry + 5, &len);
+    return Slice(p, len);
+  }
+
+ private:
+  InternalKeyComparator icmp_;
+};
+
+std::string InternalKeyFor(const std::string& user_key, SequenceNumber seq) {
+  std::string result;
+  AppendInternalKey(&result, ParsedInternalKey(user_key, seq, kTypeValue));
+  return result;
+}
+
+// Encode "user_key"@seq -> "value" into an entry allocated from "rep".
+MemTableRep::KeyHandle MakeEntry(MemTableRep* rep, const std::string& user_key,
+                                 SequenceNumber seq, const std::string& value) {
+  std::string encoded;
+  PutLengthPrefixedSlice(&encoded, InternalKeyFor(user_key, seq));
+  PutLengthPrefixedSlice(&encoded, value);
+  char* buf;
+  MemTableRep::KeyHandle handle = rep->Allocate(encoded.size(), &buf);
+  std::memcpy(buf, encoded.data(), encoded.size());
+  return handle;
+}
+
+std::string UserKeyAt(const MemTableRep::Iterator& iter) {
+  return MemTableRep::UserKey(iter.key()).ToString();
+}
+
+std::string Key(int prefix, int i) {
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "p%02d-%05d", prefix, i);
+  return buf;
+}
+
+enum RepType { kSkipList, kVector, kHashSkipList };
+
+class MemTableRepTest : public testing::TestWithParam<RepType> {
+ public:
+  MemTableRepTest() : prefix_extractor_(NewFixedPrefixTransform(3)) {
+    switch (GetParam()) {
+      case kSkipList:
+        factory_.reset(NewSkipListRepFactory());
+        break;
+      case kVector:
+        factory_.reset(NewVectorRepFactory(16));
+        break;
+      case kHashSkipList:
+        factory_.reset(NewHashSkipListRepFactory(prefix_extractor_.get(), 16));
+        break;
+    }
+    rep_.reset(factory_->CreateMemTableRep(cmp_, options_));
+  }
+
+  // The user keys of every entry, in iteration order.
+  std::vector<std::string> Scan(MemTableRep::Iterator* iter) {
+    std::vector<std::string> keys;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      keys.push_back(UserKeyAt(*iter));
+    }
+    return keys;
+  }
+
+  bool Contains(const std::string& user_key, SequenceNumber seq) {
+    std::string encoded;
+    PutLengthPrefixedSlice(&encoded, InternalKeyFor(user_key, seq));
+    return rep_->Contains(encoded.data());
+  }
+
+  EntryComparator cmp_;
+  Options options_;
+  std::unique_ptr<const SliceTransform> prefix_extractor_;
+  std::unique_ptr<MemTableRepFactory> factory_;
+  std::unique_ptr<MemTableRep> rep_;
+};
+
+}  // namespace
+
+TEST_P(MemTableRepTest, InsertAndIterate) {
+  std::vector<std::string> expected;
+  for (int prefix = 0; prefix < 5; prefix++) {
+    for (int i = 0; i < 50; i++) {
+      expected.push_back(Key(prefix, i));
+    }
+  }
+  std::vector<std::string> shuffled = expected;
+  std::reverse(shuffled.begin(), shuffled.end());
+  std::swap(shuffled[3], shuffled[100]);
+  for (const std::string& key : shuffled) {
+    rep_->Insert(MakeEntry(rep_.get(), key, 1, "v"));
+  }
+  ASSERT_GT(rep_->ApproximateMemoryUsage(), 0u);
+  ASSERT_TRUE(Contains(Key(2, 7), 1));
+  ASSERT_FALSE(Contains(Key(2, 7), 2));
+  ASSERT_FALSE(Contains(Key(9, 0), 1));
+
+  std::unique_ptr<MemTableRep::Iterator> iter(rep_->GetIterator());
+  ASSERT_EQ(expected, Scan(iter.get()));
+
+  rep_->MarkReadOnly();
+  iter.reset(rep_->GetIterator());
+  ASSERT_EQ(expected, Scan(iter.get()));
+  ASSERT_TRUE(Contains(Key(4, 49), 1));
+  ASSERT_FALSE(Contains("p04-99999", 1));
+
+  iter->Seek(InternalKeyFor(Key(3, 10), kMaxSequenceNumber));
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(Key(3, 10), UserKeyAt(*iter));
+  iter->Prev();
+  ASSERT_EQ(Key(3, 9), UserKeyAt(*iter));
+  iter->SeekToLast();
+  ASSERT_EQ(Key(4, 49), UserKeyAt(*iter));
+}
+
+TEST_P(MemTableRepTest, NewerSequenceFirst) {
+  rep_->Insert(MakeEntry(rep_.get(), "p00-k", 5, "old"));
+  rep_->Insert(MakeEntry(rep_.get(), "p00-k", 9, "new"));
+  std::unique_ptr<MemTableRep::Iterator> iter(rep_->GetIterator());
+  iter->Seek(InternalKeyFor("p00-k", kMaxSequenceNumber));
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(InternalKeyFor("p00-k", 9),
+            EntryComparator::InternalKeyOf(iter->key()).ToString());
+  iter->Seek(InternalKeyFor("p00-k", 7));
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(InternalKeyFor("p00-k", 5),
+            EntryComparator::InternalKeyOf(iter->key()).ToString());
+}
+
+TEST_P(MemTableRepTest, PrefixIterator) {
+  for (int prefix = 0; prefix < 4; prefix++) {
+    for (int i = 0; i < 10; i++) {
+      rep_->Insert(MakeEntry(rep_.get(), Key(prefix, i), 1, "v"));
+    }
+  }
+  std::unique_ptr<MemTableRep::Iterator> iter(rep_->GetPrefixIterator());
+  iter->Seek(InternalKeyFor(Key(2, 3), kMaxSequenceNumber));
+  // Every rep must yield the prefix's entries in order from the target;
+  // what follows them is unspecified.
+  for (int i = 3; i < 10; i++) {
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(Key(2, i), UserKeyAt(*iter));
+    iter->Next();
+  }
+  if (iter->Valid()) {
+    ASSERT_NE("p02", UserKeyAt(*iter).substr(0, 3));
+  }
+
+  iter->Seek(InternalKeyFor("p07-00000", kMaxSequenceNumber));
+  if (iter->Valid()) {
+    ASSERT_NE("p07", UserKeyAt(*iter).substr(0, 3));
+  }
+}
+
+TEST_P(MemTableRepTest, ConcurrentInsert) {
+  ASSERT_TRUE(factory_->IsInsertConcurrentlySupported());
+  const int kThreads = 4;
+  const int kKeysPerThread = 2000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; t++) {
+    threads.emplace_back([this, t]() {
+      for (int i = 0; i < kKeysPerThread; i++) {
+        // Spread each thread's keys over every prefix.
+        const std::string key = Key(i % 8, i * kThreads + t);
+        rep_->InsertConcurrently(MakeEntry(rep_.get(), key, 1, "v"));
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  rep_->MarkReadOnly();
+  std::unique_ptr<MemTableRep::Iterator> iter(rep_->GetIterator());
+  std::vector<std::string> keys = Scan(iter.get());
+  ASSERT_EQ(static_cast<size_t>(kThreads * kKeysPerThread), keys.size());
+  ASSERT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+  ASSERT_TRUE(std::adjacent_find(keys.begin(), keys.end()) == keys.end());
+}
+
+INSTANTIATE_TEST_SUITE_P(AllReps, MemTableRepTest,
+                         testing::Values(kSkipList, kVector, kHashSkipList));
+
+}  // namespace czy_leveldb
@@ -0,0 +1,43 @@
+#include "db/merge_context.h"
+
+namespace czy_leveldb {
+
+Status MergeContext::FullMerge(const MergeOperator* merge_operator,
+                               const Slice& user_key, const Slice* base_value,
+                               std::string* result) const {
+  if (merge_operator == nullptr) {
+    return Status::InvalidArgument("merge operand found but no "
+                                   "merge_operator is set");
+  }
+  std::vector<Slice> oldest_first;
+  oldest_first.reserve(operands_.size());
+  for (auto it = operands_.rbegin(); it != operands_.rend(); ++it) {
+    oldest_first.emplace_back(*it);
+  }
+  if (!merge_operator->FullMerge(user_key, base_value, oldest_first, result)) {
+    return Status::Corruption("merge failed", user_key);
+  }
+  return Status::OK();
+}
+
+void MergeContext::PartialMerge(const MergeOperator* merge_operator,
+                                const Slice& user_key) {
+  if (merge_operator == nullptr || operands_.size() < 2) {
+    return;
+  }
+  // Work oldest first, keeping the combined operands in "merged".
+  std::vector<std::string> merged;
+  std::string combined;
+  for (auto it = operands_.rbegin(); it != operands_.rend(); ++it) {
+    if (!merged.empty() &&
+        merge_operator->PartialMerge(user_key, merged.back(), *it,
+                                     &combined)) {
+      merged.back().swap(combined);
+    } else {
+      merged.push_back(*it);
+    }
+  }
+  operands_.assign(merged.rbegin(), merged.rend());
+}
+
+}  // namespace czy_leveldb
@@ -0,0 +1,49 @@
+#pragma once
+// Collects the merge operands of one user key while a read or compaction
+// walks its entries from newest to oldest, and folds them once the base
+// value (or its absence) is known.
+
+#include <string>
+#include <vector>
+
+#include "leveldb/merge_operator.h"
+#include "leveldb/slice.h"
+#include "leveldb/status.h"
+
+namespace czy_leveldb {
+
+class MergeContext {
+ public:
+  MergeContext() = default;
+
+  MergeContext(const MergeContext&) = delete;
+  MergeContext& operator=(const MergeContext&) = delete;
+
+  // Record an operand.  Operands are pushed newest first.
+  void PushOperand(const Slice& operand) {
+    operands_.emplace_back(operand.data(), operand.size());
+  }
+
+  size_t num_operands() const { return operands_.size(); }
+  bool empty() const { return operands_.empty(); }
+  void Clear() { operands_.clear(); }
+
+  // Fold the operands onto "base_value" (nullptr if the key has no value)
+  // into *result.
+  Status FullMerge(const MergeOperator* merge_operator, const Slice& user_key,
+                   const Slice* base_value, std::string* result) const;
+
+  // For compactions that did not reach the base value: combine the
+  // operands pairwise, oldest first, with PartialMerge() wherever the
+  // operator allows, so fewer operands are written out.
+  void PartialMerge(const MergeOperator* merge_operator,
+                    const Slice& user_key);
+
+  // Operand i, newest first, for writing compaction output.
+  const std::string& operand(size_t i) const { return operands_[i]; }
+
+ private:
+  std::vector<std::string> operands_;  // Newest first
+};
+
+}  // namespace czy_leveldb
@@ -0,0 +1,146 @@
+#include "db/merge_context.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "util/coding.h"
+
+namespace czy_leveldb {
+
+namespace {
+
+std::string Fixed64(uint64_t v) {
+  std::string result;
+  PutFixed64(&result, v);
+  return result;
+}
+
+// Appends operands like StringAppendOperator, but refuses to combine
+// operands without the base value, as a non-associative operator would.
+class NoPartialMergeOperator : public MergeOperator {
+ public:
+  const char* Name() const override { return "test.NoPartialMerge"; }
+
+  bool FullMerge(const Slice& /*key*/, const Slice* existing_value,
+                 const std::vector<Slice>& operands,
+                 std::string* new_value) const override {
+    new_value->assign(existing_value != nullptr ? existing_value->ToString()
+                                                : "");
+    for (const Slice& operand : operands) {
+      new_value->append(operand.data(), operand.size());
+    }
+    return true;
+  }
+};
+
+}  // namespace
+
+TEST(MergeOperatorTest, UInt64Add) {
+  std::unique_ptr<const MergeOperator> op(NewUInt64AddOperator());
+  const std::string base = Fixed64(10);
+  const std::string one = Fixed64(1);
+  const std::string two = Fixed64(2);
+  std::string result;
+
+  ASSERT_TRUE(op->FullMerge("k", nullptr, {one, two}, &result));
+  ASSERT_EQ(Fixed64(3), result);
+  Slice base_slice(base);
+  ASSERT_TRUE(op->FullMerge("k", &base_slice, {one, two}, &result));
+  ASSERT_EQ(Fixed64(13), result);
+
+  ASSERT_TRUE(op->PartialMerge("k", one, two, &result));
+  ASSERT_EQ(Fixed64(3), result);
+
+  // Malformed operands and values are rejected.
+  ASSERT_FALSE(op->FullMerge("k", nullptr, {one, "bad"}, &result));
+  Slice bad("bad");
+  ASSERT_FALSE(op->FullMerge("k", &bad, {one}, &result));
+  ASSERT_FALSE(op->PartialMerge("k", one, "bad", &result));
+}
+
+TEST(MergeOperatorTest, StringAppend) {
+  std::unique_ptr<const MergeOperator> op(NewStringAppendOperator(','));
+  std::string result;
+
+  ASSERT_TRUE(op->FullMerge("k", nullptr, {"a", "b"}, &result));
+  ASSERT_EQ("a,b", result);
+  Slice base("x");
+  ASSERT_TRUE(op->FullMerge("k", &base, {"a", "b"}, &result));
+  ASSERT_EQ("x,a,b", result);
+  ASSERT_TRUE(op->FullMerge("k", &base, {}, &result));
+  ASSERT_EQ("x", result);
+
+  ASSERT_TRUE(op->PartialMerge("k", "a", "b", &result));
+  ASSERT_EQ("a,b", result);
+}
+
+TEST(MergeOperatorTest, DefaultPartialMergeDeclines) {
+  NoPartialMergeOperator op;
+  std::string result = "unchanged";
+  ASSERT_FALSE(op.PartialMerge("k", "a", "b", &result));
+  ASSERT_EQ("unchanged", result);
+}
+
+TEST(MergeContextTest, FullMergeFoldsOldestFirst) {
+  std::unique_ptr<const MergeOperator> op(NewStringAppendOperator(','));
+  MergeContext context;
+  ASSERT_TRUE(context.empty());
+  // Pushed newest first, as a read walks the key's entries.
+  context.PushOperand("c");
+  context.PushOperand("b");
+  context.PushOperand("a");
+  ASSERT_EQ(3u, context.num_operands());
+
+  std::string result;
+  Slice base("base");
+  ASSERT_TRUE(context.FullMerge(op.get(), "k", &base, &result).ok());
+  ASSERT_EQ("base,a,b,c", result);
+  ASSERT_TRUE(context.FullMerge(op.get(), "k", nullptr, &result).ok());
+  ASSERT_EQ("a,b,c", result);
+
+  context.Clear();
+  ASSERT_TRUE(context.empty());
+}
+
+TEST(MergeContextTest, FullMergeErrors) {
+  MergeContext context;
+  context.PushOperand("bad");
+  std::string result;
+  ASSERT_TRUE(context.FullMerge(nullptr, "k", nullptr, &result)
+                  .IsInvalidArgument());
+
+  std::unique_ptr<const MergeOperator> op(NewUInt64AddOperator());
+  ASSERT_TRUE(context.FullMerge(op.get(), "k", nullptr, &result)
+                  .IsCorruption());
+}
+
+TEST(MergeContextTest, PartialMergeCombinesOperands) {
+  std::unique_ptr<const MergeOperator> op(NewUInt64AddOperator());
+  MergeContext context;
+  for (uint64_t v = 1; v <= 4; v++) {
+    context.PushOperand(Fixed64(v));
+  }
+  context.PartialMerge(op.get(), "k");
+  ASSERT_EQ(1u, context.num_operands());
+  ASSERT_EQ(Fixed64(10), context.operand(0));
+}
+
+TEST(MergeContextTest, PartialMergeKeepsOrderWhenDeclined) {
+  NoPartialMergeOperator op;
+  MergeContext context;
+  context.PushOperand("c");
+  context.PushOperand("b");
+  context.PushOperand("a");
+  context.PartialMerge(&op, "k");
+  ASSERT_EQ(3u, context.num_operands());
+  ASSERT_EQ("c", context.operand(0));
+  ASSERT_EQ("a", context.operand(2));
+
+  std::string result;
+  ASSERT_TRUE(context.FullMerge(&op, "k", nullptr, &result).ok());
+  ASSERT_EQ("abc", result);
+}
+
+}  // namespace czy_leveldb
@@ -0,0 +1,198 @@
+#include "db/range_tombstone.h"
+
+#include <algorithm>
+
+namespace czy_leveldb {
+
+const char kRangeDelBlockName[] = "leveldb.range_del";
+
+std::string RangeTombstone::InternalStartKey() const {
+  std::string result;
+  AppendInternalKey(&result,
+                    ParsedInternalKey(start_key, seq, kTypeRangeDeletion));
+  return result;
+}
+
+bool RangeTombstone::DecodeFrom(const Slice& key, const Slice& value) {
+  ParsedInternalKey parsed;
+  if (!ParseInternalKey(key, &parsed) || parsed.type != kTypeRangeDeletion) {
+    return false;
+  }
+  start_key.assign(parsed.user_key.data(), parsed.user_key.size());
+  end_key.assign(value.data(), value.size());
+  seq = parsed.sequence;
+  return true;
+}
+
+FragmentedRangeTombstoneList::FragmentedRangeTombstoneList(
+    Iterator* iter, const InternalKeyComparator& icmp)
+    : ucmp_(icmp.user_comparator()) {
+  std::vector<RangeTombstone> tombstones;
+  RangeTombstone t;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    if (!t.DecodeFrom(iter->key(), iter->value())) {
+      status_ = Status::Corruption("bad entry in range tombstone block");
+      break;
+    }
+    tombstones.push_back(t);
+  }
+  if (status_.ok()) {
+    status_ = iter->status();
+  }
+  Build(std::move(tombstones));
+}
+
+FragmentedRangeTombstoneList::FragmentedRangeTombstoneList(
+    const std::vector<RangeTombstone>& tombstones,
+    const InternalKeyComparator& icmp)
+    : ucmp_(icmp.user_comparator()) {
+  Build(tombstones);
+}
+
+void FragmentedRangeTombstoneList::Build(
+    std::vector<RangeTombstone> tombstones) {
+  const Comparator* ucmp = ucmp_;
+  auto key_less = [ucmp](const std::string& a, const std::string& b) {
+    return ucmp->Compare(a, b) < 0;
+  };
+
+  // Empty ranges delete nothing.
+  tombstones.erase(
+      std::remove_if(tombstones.begin(), tombstones.end(),
+                     [ucmp](const RangeTombstone& t) {
+                       return ucmp->Compare(t.start_key, t.end_key) >= 0;
+                     }),
+      tombstones.end());
+  if (tombstones.empty()) {
+    return;
+  }
+
+  // Every start and end is a fragment boundary.
+  std::vector<std::string> points;
+  points.reserve(tombstones.size() * 2);
+  for (const RangeTombstone& t : tombstones) {
+    points.push_back(t.start_key);
+    points.push_back(t.end_key);
+  }
+  std::sort(points.begin(), points.end(), key_less);
+  points.erase(std::unique(points.begin(), points.end(),
+                           [ucmp](const std::string& a, const std::string& b) {
+                             return ucmp->Compare(a, b) == 0;
+                           }),
+               points.end());
+
+  std::sort(tombstones.begin(), tombstones.end(),
+            [ucmp](const RangeTombstone& a, const RangeTombstone& b) {
+              return ucmp->Compare(a.start_key, b.start_key) < 0;
+            });
+
+  // Sweep the boundaries, keeping the tombstones that cover the piece
+  // starting at each one.
+  std::vector<const RangeTombstone*> active;
+  size_t next = 0;
+  for (size_t i = 0; i + 1 < points.size(); i++) {
+    const std::string& start = points[i];
+    const std::string& end = points[i + 1];
+    while (next < tombstones.size() &&
+           ucmp->Compare(tombstones[next].start_key, start) <= 0) {
+      active.push_back(&tombstones[next]);
+      next++;
+    }
+    active.erase(std::remove_if(active.begin(), active.end(),
+                                [ucmp, &start](const RangeTombstone* t) {
+                                  return ucmp->Compare(t->end_key, start) <= 0;
+                                }),
+                 active.end());
+    if (active.empty()) {
+      continue;  // Gap between tombstones
+    }
+    Fragment f;
+    f.start_key = start;
+    f.end_key = end;
+    for (const RangeTombstone* t : active) {
+      f.seqs.push_back(t->seq);
+    }
+    std::sort(f.seqs.begin(), f.seqs.end(),
+              [](SequenceNumber a, SequenceNumber b) { return a > b; });
+    f.seqs.erase(std::unique(f.seqs.begin(), f.seqs.end()), f.seqs.end());
+    fragments_.push_back(std::move(f));
+  }
+}
+
+int FragmentedRangeTombstoneList::FindFragment(const Slice& user_key) const {
+  // Find the last fragment starting at or before "user_key".
+  int left = 0;
+  int right = static_cast<int>(fragments_.size()) - 1;
+  int found = -1;
+  while (left <= right) {
+    const int mid = left + (right - left) / 2;
+    if (ucmp_->Compare(fragments_[mid].start_key, user_key) <= 0) {
+      found = mid;
+      left = mid + 1;
+    } else {
+      right = mid - 1;
+    }
+  }
+  if (found >= 0 && ucmp_->Compare(user_key, fragments_[found].end_key) < 0) {
+    return found;
+  }
+  return -1;
+}
+
+SequenceNumber FragmentedRangeTombstoneList::MaxCoveringSeq(
+    const Slice& user_key, SequenceNumber snapshot) const {
+  const int i = FindFragment(user_key);
+  if (i < 0) {
+    return 0;
+  }
+  for (SequenceNumber seq : fragments_[i].seqs) {
+    if (seq <= snapshot) {
+      return seq;
+    }
+  }
+  return 0;
+}
+
+bool FragmentedRangeTombstoneList::CoversRange(const Slice& smallest,
+                                               const Slice& largest,
+                                               SequenceNumber largest_seq,
+                                               SequenceNumber snapshot) const {
+  int i = FindFragment(smallest);
+  if (i < 0) {
+    return false;
+  }
+  // Walk contiguous fragments until one reaches past "largest".
+  while (true) {
+    const Fragment& f = fragments_[i];
+    bool covers = false;
+    for (SequenceNumber seq : f.seqs) {
+      if (seq <= snapshot) {
+        covers = seq > largest_seq;
+        break;
+      }
+    }
+    if (!covers) {
+      return false;
+    }
+    if (ucmp_->Compare(largest, f.end_key) < 0) {
+      return true;
+    }
+    i++;
+    if (i == static_cast<int>(fragments_.size()) ||
+        ucmp_->Compare(fragments_[i].start_key, f.end_key) != 0) {
+      return false;  // Gap
+    }
+  }
+}
+
+std::vector<RangeTombstone> FragmentedRangeTombstoneList::NewestFragments()
+    const {
+  std::vector<RangeTombstone> result;
+  result.reserve(fragments_.size());
+  for (const Fragment& f : fragments_) {
+    result.emplace_back(f.start_key, f.end_key, f.seqs.front());
+  }
+  return result;
+}
+
+}  // namespace czy_leveldb
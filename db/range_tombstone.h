@@ -0,0 +1,110 @@
+#pragma once
+// Range tombstones written by DB::DeleteRange().  Memtables keep them
+// apart from point entries, and tables store them in the
+// kRangeDelBlockName meta block, each as an internal start key of type
+// kTypeRangeDeletion mapped to the exclusive end user key.
+//
+// Tombstones may overlap arbitrarily.  Readers fragment them into
+// non-overlapping [start, end) pieces, each listing the sequence numbers
+// of the tombstones covering it, so a point lookup is one binary search.
+
+#include <string>
+#include <vector>
+
+#include "db/dbformat.h"
+#include "leveldb/iterator.h"
+#include "leveldb/slice.h"
+#include "leveldb/status.h"
+
+namespace czy_leveldb {
+
+// Name of the meta block holding a table's range tombstones.
+extern const char kRangeDelBlockName[];
+
+struct RangeTombstone {
+  std::string start_key;  // user key, inclusive
+  std::string end_key;    // user key, exclusive
+  SequenceNumber seq = 0;
+
+  RangeTombstone() = default;
+  RangeTombstone(const Slice& start, const Slice& end, SequenceNumber s)
+      : start_key(start.data(), start.size()),
+        end_key(end.data(), end.size()),
+        seq(s) {}
+
+  // The internal key / value pair this tombstone is stored as.
+  std::string InternalStartKey() const;
+  Slice Value() const { return end_key; }
+
+  // Parse a stored tombstone.  Returns false if "key" is not an internal
+  // key of type kTypeRangeDeletion.
+  bool DecodeFrom(const Slice& key, const Slice& value);
+};
+
+class FragmentedRangeTombstoneList {
+ public:
+  // Fragment the tombstones read from "iter" (as stored, see above),
+  // which may be in any order.  Does not take ownership of "iter".  Stops
+  // at an entry that is not a range tombstone or an iterator error; see
+  // status().
+  FragmentedRangeTombstoneList(Iterator* iter,
+                               const InternalKeyComparator& icmp);
+  FragmentedRangeTombstoneList(const std::vector<RangeTombstone>& tombstones,
+                               const InternalKeyComparator& icmp);
+
+  FragmentedRangeTombstoneList(const FragmentedRangeTombstoneList&) = delete;
+  FragmentedRangeTombstoneList& operator=(
+      const FragmentedRangeTombstoneList&) = delete;
+
+  bool empty() const { return fragments_.empty(); }
+
+  // Corruption if an entry read from the iterator did not decode, else
+  // the iterator's error, if any.  If not OK the list may be missing
+  // tombstones, so it must not be trusted to hide keys.
+  Status status() const { return status_; }
+
+  // Return the largest sequence number, not above "snapshot", of the
+  // tombstones covering "user_key", or 0 if none covers it.
+  SequenceNumber MaxCoveringSeq(const Slice& user_key,
+                                SequenceNumber snapshot) const;
+
+  // Return true if "key" is deleted by a tombstone visible at "snapshot",
+  // i.e. one written after the key.
+  bool ShouldDelete(const ParsedInternalKey& key,
+                    SequenceNumber snapshot) const {
+    return MaxCoveringSeq(key.user_key, snapshot) > key.sequence;
+  }
+
+  // Return true if every user key in [smallest, largest] is covered by
+  // tombstones, visible at "snapshot", that are newer than "largest_seq".
+  // Compaction uses this to drop a table whose keys are all deleted
+  // (largest_seq being the table's largest sequence number) without
+  // reading it.
+  bool CoversRange(const Slice& smallest, const Slice& largest,
+                   SequenceNumber largest_seq,
+                   SequenceNumber snapshot) const;
+
+  // The fragments as tombstones, each with the newest sequence number
+  // covering it, for writing compaction output.  Older covering
+  // tombstones are dropped since they hide nothing extra.
+  // REQUIRES: no snapshot lies between the sequence numbers of a fragment.
+  std::vector<RangeTombstone> NewestFragments() const;
+
+ private:
+  struct Fragment {
+    std::string start_key;
+    std::string end_key;
+    std::vector<SequenceNumber> seqs;  // Decreasing
+  };
+
+  void Build(std::vector<RangeTombstone> tombstones);
+
+  // Index of the fragment containing "user_key", or -1.
+  int FindFragment(const Slice& user_key) const;
+
+  const Comparator* const ucmp_;
+  std::vector<Fragment> fragments_;  // Sorted, non-overlapping
+  Status status_;
+};
+
+}  // namespace czy_leveldb
@@ -0,0 +1,186 @@
+#include "db/range_tombstone.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace czy_leveldb {
+
+namespace {
+
+// Iterates over stored (internal start key, end key) pairs in the order
+// given.
+class TombstoneIterator : public Iterator {
+ public:
+  explicit TombstoneIterator(const std::vector<RangeTombstone>& tombstones) {
+    for (const RangeTombstone& t : tombstones) {
+      keys_.push_back(t.InternalStartKey());
+      values_.push_back(t.end_key);
+    }
+    pos_ = keys_.size();
+  }
+
+  // Append an entry as is, whether or not it is a valid tombstone.
+  void AddRaw(const std::string& key, const std::string& value) {
+    keys_.push_back(key);
+    values_.push_back(value);
+  }
+
+  void SetStatus(const Status& s) { status_ = s; }
+
+  bool Valid() const override { return pos_ < keys_.size(); }
+  void SeekToFirst() override { pos_ = 0; }
+  void SeekToLast() override { pos_ = keys_.size() - 1; }
+  void Seek(const Slice&) override { pos_ = keys_.size(); }
+  void Next() override { pos_++; }
+  void Prev() override { pos_--; }
+  Slice key() const override { return keys_[pos_]; }
+  Slice value() const override { return values_[pos_]; }
+  Status status() const override { return status_; }
+
+ private:
+  std::vector<std::string> keys_;
+  std::vector<std::string> values_;
+  size_t pos_;
+  Status status_;
+};
+
+std::string Describe(const std::vector<RangeTombstone>& tombstones) {
+  std::string result;
+  for (const RangeTombstone& t : tombstones) {
+    result += "[" + t.start_key + "," + t.end_key + ")@" +
+              std::to_string(t.seq) + " ";
+  }
+  return result;
+}
+
+}  // namespace
+
+class RangeTombstoneTest : public testing::Test {
+ public:
+  RangeTombstoneTest() : icmp_(BytewiseComparator()) {}
+
+  InternalKeyComparator icmp_;
+};
+
+TEST_F(RangeTombstoneTest, EncodeDecode) {
+  RangeTombstone t("apple", "banana", 42);
+  RangeTombstone decoded;
+  ASSERT_TRUE(decoded.DecodeFrom(t.InternalStartKey(), t.Value()));
+  ASSERT_EQ("apple", decoded.start_key);
+  ASSERT_EQ("banana", decoded.end_key);
+  ASSERT_EQ(42u, decoded.seq);
+
+  std::string point;
+  AppendInternalKey(&point, ParsedInternalKey("apple", 42, kTypeValue));
+  ASSERT_FALSE(decoded.DecodeFrom(point, "banana"));
+}
+
+TEST_F(RangeTombstoneTest, FragmentsOverlaps) {
+  FragmentedRangeTombstoneList list(
+      {RangeTombstone("c", "g", 20), RangeTombstone("a", "e", 10),
+       RangeTombstone("x", "z", 5), RangeTombstone("m", "m", 99)},
+      icmp_);
+  ASSERT_FALSE(list.empty());
+  // The empty [m,m) is dropped and the gap [g,x) has no fragment.
+  ASSERT_EQ("[a,c)@10 [c,e)@20 [e,g)@20 [x,z)@5 ",
+            Describe(list.NewestFragments()));
+
+  ASSERT_EQ(10u, list.MaxCoveringSeq("a", kMaxSequenceNumber));
+  ASSERT_EQ(20u, list.MaxCoveringSeq("d", kMaxSequenceNumber));
+  // Under an older snapshot the newer tombstone is invisible.
+  ASSERT_EQ(10u, list.MaxCoveringSeq("d", 15));
+  ASSERT_EQ(0u, list.MaxCoveringSeq("f", 15));
+  ASSERT_EQ(0u, list.MaxCoveringSeq("g", kMaxSequenceNumber));
+  ASSERT_EQ(0u, list.MaxCoveringSeq("z", kMaxSequenceNumber));
+  ASSERT_EQ(0u, list.MaxCoveringSeq("0", kMaxSequenceNumber));
+
+  ASSERT_TRUE(list.ShouldDelete(ParsedInternalKey("d", 15, kTypeValue),
+                                kMaxSequenceNumber));
+  ASSERT_FALSE(list.ShouldDelete(ParsedInternalKey("d", 25, kTypeValue),
+                                 kMaxSequenceNumber));
+  ASSERT_FALSE(list.ShouldDelete(ParsedInternalKey("d", 15, kTypeValue), 12));
+}
+
+TEST_F(RangeTombstoneTest, FromIterator) {
+  const std::vector<RangeTombstone> tombstones = {
+      RangeTombstone("k", "p", 3), RangeTombstone("a", "c", 8)};
+  TombstoneIterator iter(tombstones);
+  FragmentedRangeTombstoneList list(&iter, icmp_);
+  ASSERT_EQ("[a,c)@8 [k,p)@3 ", Describe(list.NewestFragments()));
+  ASSERT_TRUE(list.status().ok());
+}
+
+TEST_F(RangeTombstoneTest, FromIteratorReportsBadEntries) {
+  TombstoneIterator iter({RangeTombstone("a", "c", 8)});
+  std::string point;
+  AppendInternalKey(&point, ParsedInternalKey("k", 3, kTypeValue));
+  iter.AddRaw(point, "p");
+  FragmentedRangeTombstoneList list(&iter, icmp_);
+  ASSERT_TRUE(list.status().IsCorruption());
+
+  TombstoneIterator short_key({});
+  short_key.AddRaw("k", "p");
+  FragmentedRangeTombstoneList short_list(&short_key, icmp_);
+  ASSERT_TRUE(short_list.status().IsCorruption());
+}
+
+TEST_F(RangeTombstoneTest, FromIteratorReportsIteratorErrors) {
+  TombstoneIterator iter({RangeTombstone("a", "c", 8)});
+  iter.SetStatus(Status::IOError("read failed"));
+  FragmentedRangeTombstoneList list(&iter, icmp_);
+  ASSERT_TRUE(list.status().IsIOError());
+}
+
+TEST_F(RangeTombstoneTest, CoversRange) {
+  FragmentedRangeTombstoneList list(
+      {RangeTombstone("a", "e", 10), RangeTombstone("c", "g", 20),
+       RangeTombstone("h", "k", 30)},
+      icmp_);
+  // Contiguous fragments, all newer than the table.
+  ASSERT_TRUE(list.CoversRange("b", "f", 5, kMaxSequenceNumber));
+  // [a,c) is only covered at 10.
+  ASSERT_FALSE(list.CoversRange("b", "f", 15, kMaxSequenceNumber));
+  ASSERT_TRUE(list.CoversRange("c", "f", 15, kMaxSequenceNumber));
+  // Gap at [g,h).
+  ASSERT_FALSE(list.CoversRange("f", "i", 5, kMaxSequenceNumber));
+  // The end key is exclusive.
+  ASSERT_FALSE(list.CoversRange("h", "k", 5, kMaxSequenceNumber));
+  // Invisible at the snapshot.
+  ASSERT_FALSE(list.CoversRange("h", "i", 5, 25));
+}
+
+TEST_F(RangeTombstoneTest, MatchesBruteForce) {
+  std::srand(301);
+  for (int round = 0; round < 50; round++) {
+    std::vector<RangeTombstone> tombstones;
+    const int n = 1 + std::rand() % 10;
+    for (int i = 0; i < n; i++) {
+      const char a = 'a' + std::rand() % 20;
+      const char b = 'a' + std::rand() % 20;
+      tombstones.emplace_back(std::string(1, std::min(a, b)),
+                              std::string(1, std::max(a, b)),
+                              1 + std::rand() % 100);
+    }
+    FragmentedRangeTombstoneList list(tombstones, icmp_);
+    for (char c = 'a'; c <= 'u'; c++) {
+      const std::string key(1, c);
+      for (SequenceNumber snapshot : {SequenceNumber(50), kMaxSequenceNumber}) {
+        SequenceNumber expected = 0;
+        for (const RangeTombstone& t : tombstones) {
+          if (t.start_key <= key && key < t.end_key && t.seq <= snapshot &&
+              t.seq > expected) {
+            expected = t.seq;
+          }
+        }
+        ASSERT_EQ(expected, list.MaxCoveringSeq(key, snapshot))
+            << "key " << key << " tombstones " << Describe(tombstones);
+      }
+    }
+  }
+}
+
+}  // namespace czy_leveldb
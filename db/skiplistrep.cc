@@ -0,0 +1,97 @@
+#include "db/inlineskiplist.h"
+#include "leveldb/memtablerep.h"
+#include "leveldb/options.h"
+#include "util/coding.h"
+#include "util/concurrent_arena.h"
+
+namespace czy_leveldb {
+
+MemTableRep::~MemTableRep() = default;
+
+void MemTableRep::InsertConcurrently(KeyHandle handle) {
+  // Reps whose factory does not claim IsInsertConcurrentlySupported() are
+  // never called here.
+  assert(false);
+  Insert(handle);
+}
+
+Slice MemTableRep::UserKey(const char* entry) {
+  uint32_t len;
+  const char* p = GetVarint32Ptr(entry, entry + 5, &len);
+  assert(p != nullptr && len >= 8);
+  return Slice(p, len - 8);
+}
+
+MemTableRepFactory::~MemTableRepFactory() = default;
+
+namespace {
+
+class SkipListRep : public MemTableRep {
+ public:
+  SkipListRep(const MemTableRep::KeyComparator& cmp, const Options& options)
+      : arena_(ConcurrentArena::kDefaultBlockSize, options.memtable_huge_page_size),
+        list_(cmp, &arena_) {}
+
+  KeyHandle Allocate(size_t len, char** buf) override {
+    *buf = list_.AllocateKey(len);
+    return static_cast<KeyHandle>(*buf);
+  }
+
+  void Insert(KeyHandle handle) override {
+    list_.Insert(static_cast<char*>(handle));
+  }
+
+  void InsertConcurrently(KeyHandle handle) override {
+    list_.InsertConcurrently(static_cast<char*>(handle));
+  }
+
+  bool Contains(const char* entry) const override {
+    return list_.Contains(entry);
+  }
+
+  size_t ApproximateMemoryUsage() override { return arena_.MemoryUsage(); }
+
+  size_t ApproximateHugePageUsage() override { return arena_.HugePageUsage(); }
+
+  class Iterator : public MemTableRep::Iterator {
+   public:
+    explicit Iterator(const InlineSkipList<const KeyComparator&>* list)
+        : iter_(list) {}
+
+    bool Valid() const override { return iter_.Valid(); }
+    const char* key() const override { return iter_.key(); }
+    void Next() override { iter_.Next(); }
+    void Prev() override { iter_.Prev(); }
+    void Seek(const Slice& target) override { iter_.Seek(target); }
+    void SeekToFirst() override { iter_.SeekToFirst(); }
+    void SeekToLast() override { iter_.SeekToLast(); }
+
+   private:
+    InlineSkipList<const KeyComparator&>::Iterator iter_;
+  };
+
+  MemTableRep::Iterator* GetIterator() override { return new Iterator(&list_); }
+
+ private:
+  // Declared first: the list allocates its head node from the arena.
+  ConcurrentArena arena_;
+  InlineSkipList<const KeyComparator&> list_;
+};
+
+class SkipListRepFactory : public MemTableRepFactory {
+ public:
+  MemTableRep* CreateMemTableRep(const MemTableRep::KeyComparator& cmp,
+                                 const Options& options) override {
+    return new SkipListRep(cmp, options);
+  }
+
+  const char* Name() const override { return "SkipListRepFactory"; }
+
+  bool IsInsertConcurrentlySupported() const override { return true; }
+};
+
+}  // namespace
+
+MemTableRepFactory* NewSkipListRepFactory() { return new SkipListRepFactory; }
+
+}  // namespace czy_leveldb
@@ -0,0 +1,70 @@
+#pragma once
+// A MemTableRep::Iterator over a sorted vector of encoded entries, shared
+// by the reps that do not keep their entries in one ordered structure.
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "leveldb/memtablerep.h"
+
+namespace czy_leveldb {
+
+class SortedVectorIterator : public MemTableRep::Iterator {
+ public:
+  // Iterate over "*entries", which must be sorted by "cmp" and outlive the
+  // iterator.
+  SortedVectorIterator(const std::vector<const char*>* entries,
+                       const MemTableRep::KeyComparator& cmp)
+      : entries_(entries), cmp_(cmp), pos_(entries->size()) {}
+
+  // Sort "entries" and iterate over them, taking ownership.
+  SortedVectorIterator(std::vector<const char*>* entries,
+                       const MemTableRep::KeyComparator& cmp, bool owned)
+      : owned_(entries), entries_(entries), cmp_(cmp), pos_(entries->size()) {
+    assert(owned);
+    const MemTableRep::KeyComparator& c = cmp_;
+    std::sort(entries->begin(), entries->end(),
+              [&c](const char* a, const char* b) { return c(a, b) < 0; });
+  }
+
+  bool Valid() const override { return pos_ < entries_->size(); }
+
+  const char* key() const override {
+    assert(Valid());
+    return (*entries_)[pos_];
+  }
+
+  void Next() override {
+    assert(Valid());
+    pos_++;
+  }
+
+  void Prev() override {
+    assert(Valid());
+    pos_ = (pos_ == 0) ? entries_->size() : pos_ - 1;
+  }
+
+  void Seek(const Slice& target) override {
+    const MemTableRep::KeyComparator& c = cmp_;
+    pos_ = std::lower_bound(entries_->begin(), entries_->end(), target,
+                            [&c](const char* entry, const Slice& t) {
+                              return c(entry, t) < 0;
+                            }) -
+           entries_->begin();
+  }
+
+  void SeekToFirst() override { pos_ = 0; }
+
+  void SeekToLast() override {
+    pos_ = entries_->empty() ? 0 : entries_->size() - 1;
+  }
+
+ private:
+  std::unique_ptr<std::vector<const char*>> owned_;
+  const std::vector<const char*>* const entries_;
+  const MemTableRep::KeyComparator& cmp_;
+  size_t pos_;  // entries_->size() when not valid
+};
+
+}  // namespace czy_leveldb
@@ -0,0 +1,134 @@
+#include "db/universal_compaction_picker.h"
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+
+namespace czy_leveldb {
+
+UniversalCompactionPicker::UniversalCompactionPicker(
+    const CompactionOptionsUniversal& options, int num_levels)
+    : options_(options), num_levels_(num_levels) {
+  assert(num_levels_ > 1);
+}
+
+bool UniversalCompactionPicker::NeedsCompaction(
+    const std::vector<SortedRun>& runs) const {
+  size_t idle = 0;
+  for (const SortedRun& run : runs) {
+    if (!run.being_compacted) {
+      idle++;
+    }
+  }
+  return idle >= 2 &&
+         runs.size() >= static_cast<size_t>(options_.num_sorted_runs_trigger);
+}
+
+bool UniversalCompactionPicker::PickCompaction(
+    const std::vector<SortedRun>& runs, UniversalCompactionPick* pick) const {
+  if (!NeedsCompaction(runs)) {
+    return false;
+  }
+
+  // Space first: once the newer runs outgrow the oldest one by enough,
+  // merging everything is what keeps the DB from growing without bound.
+  if (PickSizeAmplification(runs, pick)) {
+    return true;
+  }
+
+  const size_t min_width = std::max(options_.min_merge_width, 2u);
+  if (PickSizeRatio(runs, options_.size_ratio, min_width,
+                    std::max<size_t>(options_.max_merge_width, min_width),
+                    pick)) {
+    return true;
+  }
+
+  // Too many runs of unrelated sizes: merge the newest ones, regardless
+  // of size, until the count is back at the trigger.  Any two idle
+  // neighbours will do; requiring min_merge_width here could leave the
+  // run count growing without bound while compactions hold every wider
+  // stretch.
+  const size_t trigger =
+      static_cast<size_t>(std::max(options_.num_sorted_runs_trigger, 1));
+  if (runs.size() > trigger) {
+    const size_t width = std::max<size_t>(runs.size() - trigger + 1, 2);
+    if (PickSizeRatio(runs, UINT_MAX, 2, width, pick)) {
+      pick->reason = UniversalCompactionPick::kSortedRunNum;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool UniversalCompactionPicker::PickSizeAmplification(
+    const std::vector<SortedRun>& runs, UniversalCompactionPick* pick) const {
+  if (runs.size() < 2) {
+    return false;
+  }
+  uint64_t newer_size = 0;
+  for (size_t i = 0; i < runs.size(); i++) {
+    if (runs[i].being_compacted) {
+      return false;
+    }
+    if (i + 1 < runs.size()) {
+      newer_size += runs[i].size;
+    }
+  }
+  const uint64_t oldest_size = runs.back().size;
+  if (newer_size * 100 <=
+      oldest_size * options_.max_size_amplification_percent) {
+    return false;
+  }
+  pick->start = 0;
+  pick->count = runs.size();
+  pick->output_level = num_levels_ - 1;
+  pick->reason = UniversalCompactionPick::kSizeAmplification;
+  return true;
+}
+
+bool UniversalCompactionPicker::PickSizeRatio(
+    const std::vector<SortedRun>& runs, unsigned int ratio, size_t min_width,
+    size_t max_width, UniversalCompactionPick* pick) const {
+  for (size_t start = 0; start < runs.size(); start++) {
+    if (runs[start].being_compacted) {
+      continue;
+    }
+    // Grow the candidate with older runs while each next run is no bigger
+    // than (100 + ratio)% of the candidate so far.
+    uint64_t candidate_size = runs[start].size;
+    size_t end = start + 1;
+    while (end < runs.size() && end - start < max_width &&
+           !runs[end].being_compacted) {
+      const double limit =
+          static_cast<double>(candidate_size) * (100.0 + ratio) / 100.0;
+      if (static_cast<double>(runs[end].size) > limit) {
+        break;
+      }
+      candidate_size += runs[end].size;
+      end++;
+    }
+    if (end - start >= min_width) {
+      pick->start = start;
+      pick->count = end - start;
+      pick->output_level = OutputLevel(runs, end);
+      pick->reason = UniversalCompactionPick::kSizeRatio;
+      return true;
+    }
+  }
+  return false;
+}
+
+int UniversalCompactionPicker::OutputLevel(const std::vector<SortedRun>& runs,
+                                           size_t end) const {
+  if (end == runs.size()) {
+    return num_levels_ - 1;
+  }
+  // Write just above the next older run.  The levels in between are empty:
+  // every non-empty level is a run, and the picked runs are contiguous.
+  const int next_level = runs[end].level;
+  const int output_level = next_level > 0 ? next_level - 1 : 0;
+  assert(output_level >= runs[end - 1].level);
+  return output_level;
+}
+
+}  // namespace czy_leveldb
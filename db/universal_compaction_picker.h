@@ -0,0 +1,72 @@
+#pragma once
+// Picks compactions for CompactionStyle::kUniversal.
+//
+// The DB views its tables as sorted runs: every level-0 table on its own
+// and every non-empty deeper level as a whole, newest first.  Like leveled
+// compaction, the background thread scheduled through Env::Schedule()
+// asks NeedsCompaction() / PickCompaction() after each flush and each
+// finished compaction, then merges the picked runs into one table set on
+// the output level.  Runs that are being compacted are never picked again
+// until that compaction finishes.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "leveldb/options.h"
+
+namespace czy_leveldb {
+
+struct SortedRun {
+  SortedRun(int level, uint64_t size, bool being_compacted)
+      : level(level), size(size), being_compacted(being_compacted) {}
+
+  int level;     // 0 for a level-0 table, otherwise the level of the run
+  uint64_t size;  // Total file size of the run in bytes
+  bool being_compacted;
+};
+
+struct UniversalCompactionPick {
+  enum Reason {
+    kSizeAmplification,  // Merge everything to reclaim space
+    kSizeRatio,          // Merge runs of similar size
+    kSortedRunNum,       // Merge the newest runs to bound read cost
+  };
+
+  // The picked runs are runs[start, start + count).
+  size_t start;
+  size_t count;
+  int output_level;
+  Reason reason;
+};
+
+class UniversalCompactionPicker {
+ public:
+  // "num_levels" is the number of levels of the DB; a compaction that
+  // includes the oldest run writes to the last level.
+  UniversalCompactionPicker(const CompactionOptionsUniversal& options,
+                            int num_levels);
+
+  // Whether there are enough sorted runs to consider a compaction.
+  bool NeedsCompaction(const std::vector<SortedRun>& runs) const;
+
+  // If a compaction should run, store it in *pick and return true.
+  // "runs" are ordered from newest to oldest.
+  bool PickCompaction(const std::vector<SortedRun>& runs,
+                      UniversalCompactionPick* pick) const;
+
+ private:
+  bool PickSizeAmplification(const std::vector<SortedRun>& runs,
+                             UniversalCompactionPick* pick) const;
+  // Pick the newest stretch of [min_width, max_width] idle runs in which
+  // each run is at most (100 + ratio)% of the newer ones together.
+  bool PickSizeRatio(const std::vector<SortedRun>& runs, unsigned int ratio,
+                     size_t min_width, size_t max_width,
+                     UniversalCompactionPick* pick) const;
+  int OutputLevel(const std::vector<SortedRun>& runs, size_t end) const;
+
+  const CompactionOptionsUniversal options_;
+  const int num_levels_;
+};
+
+}  // namespace czy_leveldb
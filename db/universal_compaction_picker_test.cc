@@ -0,0 +1,183 @@
+#include "db/universal_compaction_picker.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace czy_leveldb {
+
+namespace {
+
+const int kNumLevels = 7;
+
+}  // namespace
+
+class UniversalCompactionPickerTest : public testing::Test {
+ public:
+  UniversalCompactionPickerTest() {
+    options_.num_sorted_runs_trigger = 4;
+    // Keep the size amplification rule out of the way unless a test
+    // wants it.
+    options_.max_size_amplification_percent = 1000000;
+  }
+
+  // Newest first, like the DB passes them.
+  void AddRun(int level, uint64_t size, bool being_compacted = false) {
+    runs_.emplace_back(level, size, being_compacted);
+  }
+
+  bool Pick() {
+    UniversalCompactionPicker picker(options_, kNumLevels);
+    return picker.PickCompaction(runs_, &pick_);
+  }
+
+  CompactionOptionsUniversal options_;
+  std::vector<SortedRun> runs_;
+  UniversalCompactionPick pick_;
+};
+
+TEST_F(UniversalCompactionPickerTest, NeedsCompaction) {
+  UniversalCompactionPicker picker(options_, kNumLevels);
+  AddRun(0, 1);
+  AddRun(0, 1);
+  AddRun(0, 1);
+  ASSERT_FALSE(picker.NeedsCompaction(runs_));
+  AddRun(6, 1000);
+  ASSERT_TRUE(picker.NeedsCompaction(runs_));
+
+  // Fewer than two idle runs leave nothing to merge.
+  for (size_t i = 1; i < runs_.size(); i++) {
+    runs_[i].being_compacted = true;
+  }
+  ASSERT_FALSE(picker.NeedsCompaction(runs_));
+  ASSERT_FALSE(Pick());
+}
+
+TEST_F(UniversalCompactionPickerTest, SizeAmplification) {
+  options_.max_size_amplification_percent = 200;
+  AddRun(0, 100);
+  AddRun(0, 100);
+  AddRun(0, 101);
+  AddRun(6, 150);
+  ASSERT_TRUE(Pick());
+  ASSERT_EQ(UniversalCompactionPick::kSizeAmplification, pick_.reason);
+  ASSERT_EQ(0u, pick_.start);
+  ASSERT_EQ(4u, pick_.count);
+  ASSERT_EQ(kNumLevels - 1, pick_.output_level);
+
+  // Under the limit the size ratio rule applies instead.
+  runs_.back().size = 1000;
+  ASSERT_TRUE(Pick());
+  ASSERT_EQ(UniversalCompactionPick::kSizeRatio, pick_.reason);
+}
+
+TEST_F(UniversalCompactionPickerTest, SizeAmplificationWaitsForCompactions) {
+  options_.max_size_amplification_percent = 200;
+  AddRun(0, 100);
+  AddRun(0, 100, true);
+  AddRun(0, 100);
+  AddRun(6, 10);
+  ASSERT_TRUE(Pick());
+  ASSERT_NE(UniversalCompactionPick::kSizeAmplification, pick_.reason);
+}
+
+TEST_F(UniversalCompactionPickerTest, SizeRatio) {
+  AddRun(0, 10);
+  AddRun(0, 10);
+  AddRun(0, 20);
+  AddRun(0, 41);  // Above (100 + size_ratio)% of 40
+  AddRun(6, 10000);
+  ASSERT_TRUE(Pick());
+  ASSERT_EQ(UniversalCompactionPick::kSizeRatio, pick_.reason);
+  ASSERT_EQ(0u, pick_.start);
+  ASSERT_EQ(3u, pick_.count);
+  ASSERT_EQ(0, pick_.output_level);
+
+  options_.size_ratio = 10;
+  ASSERT_TRUE(Pick());
+  ASSERT_EQ(4u, pick_.count);
+  // Written just above the next older run.
+  ASSERT_EQ(5, pick_.output_level);
+}
+
+TEST_F(UniversalCompactionPickerTest, SizeRatioMaxWidth) {
+  options_.max_merge_width = 2;
+  for (int i = 0; i < 5; i++) {
+    AddRun(0, 10);
+  }
+  ASSERT_TRUE(Pick());
+  ASSERT_EQ(UniversalCompactionPick::kSizeRatio, pick_.reason);
+  ASSERT_EQ(0u, pick_.start);
+  ASSERT_EQ(2u, pick_.count);
+}
+
+TEST_F(UniversalCompactionPickerTest, OutputLevel) {
+  AddRun(0, 10);
+  AddRun(0, 10);
+  AddRun(4, 1000);
+  AddRun(6, 100000);
+  ASSERT_TRUE(Pick());
+  ASSERT_EQ(2u, pick_.count);
+  // Levels 1 to 3 are empty; the output lands right above level 4.
+  ASSERT_EQ(3, pick_.output_level);
+
+  // A pick that includes the oldest run writes to the last level.
+  runs_.clear();
+  for (int i = 0; i < 4; i++) {
+    AddRun(0, 10);
+  }
+  ASSERT_TRUE(Pick());
+  ASSERT_EQ(4u, pick_.count);
+  ASSERT_EQ(kNumLevels - 1, pick_.output_level);
+}
+
+TEST_F(UniversalCompactionPickerTest, SkipsRunsBeingCompacted) {
+  AddRun(0, 10, true);
+  AddRun(0, 10);
+  AddRun(0, 10);
+  AddRun(0, 10, true);
+  AddRun(0, 10);
+  AddRun(6, 10000);
+  ASSERT_TRUE(Pick());
+  ASSERT_EQ(1u, pick_.start);
+  ASSERT_EQ(2u, pick_.count);
+  for (size_t i = pick_.start; i < pick_.start + pick_.count; i++) {
+    ASSERT_FALSE(runs_[i].being_compacted);
+  }
+  // The output stays above the busy run.
+  ASSERT_EQ(0, pick_.output_level);
+}
+
+TEST_F(UniversalCompactionPickerTest, SortedRunNum) {
+  // Every run is much bigger than the newer ones, so no size ratio
+  // compaction applies.
+  AddRun(0, 1);
+  AddRun(0, 100);
+  AddRun(0, 10000);
+  AddRun(0, 1000000);
+  AddRun(0, 100000000);
+  AddRun(6, 10000000000);
+  ASSERT_TRUE(Pick());
+  ASSERT_EQ(UniversalCompactionPick::kSortedRunNum, pick_.reason);
+  ASSERT_EQ(0u, pick_.start);
+  // Back to the trigger of 4 runs.
+  ASSERT_EQ(3u, pick_.count);
+  ASSERT_EQ(0, pick_.output_level);
+}
+
+// The run count fallback must not be held back by min_merge_width: if it
+// were, no compaction could be picked here and runs would pile up.
+TEST_F(UniversalCompactionPickerTest, SortedRunNumIgnoresMinMergeWidth) {
+  options_.min_merge_width = 4;
+  AddRun(0, 1);
+  AddRun(0, 100);
+  AddRun(0, 10000, true);
+  AddRun(0, 1000000);
+  AddRun(6, 100000000);
+  ASSERT_TRUE(Pick());
+  ASSERT_EQ(UniversalCompactionPick::kSortedRunNum, pick_.reason);
+  ASSERT_EQ(0u, pick_.start);
+  ASSERT_EQ(2u, pick_.count);
+}
+
+}  // namespace czy_leveldb
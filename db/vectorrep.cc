@@ -0,0 +1,114 @@
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+#include "db/sorted_vector_iterator.h"
+#include "leveldb/memtablerep.h"
+#include "leveldb/options.h"
+#include "util/concurrent_arena.h"
+
+namespace czy_leveldb {
+
+namespace {
+
+class VectorRep : public MemTableRep {
+ public:
+  VectorRep(const KeyComparator& cmp, const Options& options, size_t reserved)
+      : cmp_(cmp),
+        arena_(ConcurrentArena::kDefaultBlockSize, options.memtable_huge_page_size),
+        immutable_(false) {
+    entries_.reserve(reserved);
+  }
+
+  KeyHandle Allocate(size_t len, char** buf) override {
+    *buf = arena_.AllocateAligned(len);
+    return static_cast<KeyHandle>(*buf);
+  }
+
+  void Insert(KeyHandle handle) override {
+    std::lock_guard<std::mutex> l(mu_);
+    assert(!immutable_);
+    entries_.push_back(static_cast<const char*>(handle));
+  }
+
+  // Appending under the lock is cheap enough that concurrent writers
+  // barely contend.
+  void InsertConcurrently(KeyHandle handle) override { Insert(handle); }
+
+  bool Contains(const char* entry) const override {
+    std::lock_guard<std::mutex> l(mu_);
+    if (immutable_) {
+      const KeyComparator& c = cmp_;
+      return std::binary_search(
+          entries_.begin(), entries_.end(), entry,
+          [&c](const char* a, const char* b) { return c(a, b) < 0; });
+    }
+    for (const char* e : entries_) {
+      if (cmp_(e, entry) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  size_t ApproximateMemoryUsage() override {
+    std::lock_guard<std::mutex> l(mu_);
+    return arena_.MemoryUsage() + entries_.capacity() * sizeof(const char*);
+  }
+
+  size_t ApproximateHugePageUsage() override { return arena_.HugePageUsage(); }
+
+  void MarkReadOnly() override {
+    std::lock_guard<std::mutex> l(mu_);
+    if (!immutable_) {
+      const KeyComparator& c = cmp_;
+      std::sort(entries_.begin(), entries_.end(),
+                [&c](const char* a, const char* b) { return c(a, b) < 0; });
+      immutable_ = true;
+    }
+  }
+
+  MemTableRep::Iterator* GetIterator() override {
+    std::lock_guard<std::mutex> l(mu_);
+    if (immutable_) {
+      // Sorted and no longer modified: iterate in place.
+      return new SortedVectorIterator(&entries_, cmp_);
+    }
+    // Still taking writes: sort a snapshot.
+    return new SortedVectorIterator(new std::vector<const char*>(entries_),
+                                    cmp_, true);
+  }
+
+ private:
+  const KeyComparator& cmp_;
+  ConcurrentArena arena_;
+
+  mutable std::mutex mu_;
+  std::vector<const char*> entries_;  // Sorted once immutable_
+  bool immutable_;
+};
+
+class VectorRepFactory : public MemTableRepFactory {
+ public:
+  explicit VectorRepFactory(size_t reserved) : reserved_(reserved) {}
+
+  MemTableRep* CreateMemTableRep(const MemTableRep::KeyComparator& cmp,
+                                 const Options& options) override {
+    return new VectorRep(cmp, options, reserved_);
+  }
+
+  const char* Name() const override { return "VectorRepFactory"; }
+
+  bool IsInsertConcurrentlySupported() const override { return true; }
+
+ private:
+  const size_t reserved_;
+};
+
+}  // namespace
+
+MemTableRepFactory* NewVectorRepFactory(size_t reserved) {
+  return new VectorRepFactory(reserved);
+}
+
+}  // namespace czy_leveldb
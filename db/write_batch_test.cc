@@ -0,0 +1,166 @@
+#include "leveldb/write_batch.h"
+
+#include <string>
+
+#include "db/write_batch_internal.h"
+#include "gtest/gtest.h"
+#include "leveldb/column_family.h"
+#include "leveldb/comparator.h"
+
+namespace czy_leveldb {
+
+namespace {
+
+class FakeHandle : public ColumnFamilyHandle {
+ public:
+  FakeHandle(uint32_t id, const std::string& name) : id_(id), name_(name) {}
+
+  const std::string& GetName() const override { return name_; }
+  uint32_t GetID() const override { return id_; }
+  const Comparator* GetComparator() const override {
+    return BytewiseComparator();
+  }
+
+ private:
+  const uint32_t id_;
+  const std::string name_;
+};
+
+// Records every callback, with the family id for the CF variants.
+class RecordingHandler : public WriteBatch::Handler {
+ public:
+  void PutCF(uint32_t id, const Slice& key, const Slice& value) override {
+    state += "Put" + Family(id) + "(" + key.ToString() + "," +
+             value.ToString() + ")";
+  }
+  void DeleteCF(uint32_t id, const Slice& key) override {
+    state += "Delete" + Family(id) + "(" + key.ToString() + ")";
+  }
+  void DeleteRangeCF(uint32_t id, const Slice& begin_key,
+                     const Slice& end_key) override {
+    state += "DeleteRange" + Family(id) + "(" + begin_key.ToString() + "," +
+             end_key.ToString() + ")";
+  }
+  void MergeCF(uint32_t id, const Slice& key, const Slice& value) override {
+    state += "Merge" + Family(id) + "(" + key.ToString() + "," +
+             value.ToString() + ")";
+  }
+
+  void Put(const Slice&, const Slice&) override {}
+  void Delete(const Slice&) override {}
+
+  std::string state;
+
+ private:
+  static std::string Family(uint32_t id) {
+    return id == 0 ? "" : "@" + std::to_string(id);
+  }
+};
+
+// A handler written before column families, range deletions and merges
+// existed: it only overrides Put() and Delete().
+class LegacyHandler : public WriteBatch::Handler {
+ public:
+  void Put(const Slice& key, const Slice& value) override {
+    state += "Put(" + key.ToString() + "," + value.ToString() + ")";
+  }
+  void Delete(const Slice& key) override {
+    state += "Delete(" + key.ToString() + ")";
+  }
+
+  std::string state;
+};
+
+std::string PrintContents(const WriteBatch& batch) {
+  RecordingHandler handler;
+  Status s = batch.Iterate(&handler);
+  if (!s.ok()) {
+    return s.ToString();
+  }
+  return handler.state;
+}
+
+}  // namespace
+
+TEST(WriteBatchTest, Empty) {
+  WriteBatch batch;
+  ASSERT_EQ("", PrintContents(batch));
+  ASSERT_EQ(0, WriteBatchInternal::Count(&batch));
+}
+
+TEST(WriteBatchTest, Multiple) {
+  WriteBatch batch;
+  batch.Put("foo", "bar");
+  batch.Delete("box");
+  batch.DeleteRange("a", "c");
+  batch.Merge("baz", "+1");
+  WriteBatchInternal::SetSequence(&batch, 100);
+  ASSERT_EQ(100u, WriteBatchInternal::Sequence(&batch));
+  ASSERT_EQ(4, WriteBatchInternal::Count(&batch));
+  ASSERT_EQ("Put(foo,bar)Delete(box)DeleteRange(a,c)Merge(baz,+1)",
+            PrintContents(batch));
+}
+
+TEST(WriteBatchTest, ColumnFamilies) {
+  FakeHandle def(0, kDefaultColumnFamilyName);
+  FakeHandle logs(3, "logs");
+  WriteBatch batch;
+  batch.Put(&logs, "k1", "v1");
+  batch.Delete(&logs, "k2");
+  batch.DeleteRange(&logs, "k3", "k4");
+  batch.Merge(&logs, "k5", "v5");
+  batch.Merge(&def, "k6", "v6");
+  ASSERT_EQ(5, WriteBatchInternal::Count(&batch));
+  ASSERT_EQ(
+      "Put@3(k1,v1)Delete@3(k2)DeleteRange@3(k3,k4)Merge@3(k5,v5)"
+      "Merge(k6,v6)",
+      PrintContents(batch));
+}
+
+TEST(WriteBatchTest, LegacyHandlerSeesDefaultFamilyOnly) {
+  FakeHandle logs(3, "logs");
+  WriteBatch batch;
+  batch.Put("a", "1");
+  batch.Put(&logs, "b", "2");
+  batch.Delete(&logs, "c");
+  batch.DeleteRange("d", "e");
+  batch.Merge("f", "3");
+  batch.Delete("g");
+
+  LegacyHandler handler;
+  ASSERT_TRUE(batch.Iterate(&handler).ok());
+  ASSERT_EQ("Put(a,1)Delete(g)", handler.state);
+}
+
+TEST(WriteBatchTest, Corruption) {
+  WriteBatch batch;
+  batch.Put("foo", "bar");
+  batch.Merge("baz", "+1");
+  WriteBatchInternal::SetContents(
+      &batch, Slice(WriteBatchInternal::Contents(&batch).data(),
+                    WriteBatchInternal::ByteSize(&batch) - 1));
+  ASSERT_EQ("Corruption: bad WriteBatch Merge", PrintContents(batch));
+
+  WriteBatch miscounted;
+  miscounted.Put("foo", "bar");
+  WriteBatchInternal::SetCount(&miscounted, 2);
+  ASSERT_EQ("Corruption: WriteBatch has wrong count",
+            PrintContents(miscounted));
+}
+
+TEST(WriteBatchTest, Append) {
+  FakeHandle logs(1, "logs");
+  WriteBatch b1, b2;
+  b1.Put("a", "va");
+  b2.Merge(&logs, "b", "vb");
+  b2.DeleteRange("c", "d");
+  b1.Append(b2);
+  ASSERT_EQ(3, WriteBatchInternal::Count(&b1));
+  ASSERT_EQ("Put(a,va)Merge@1(b,vb)DeleteRange(c,d)", PrintContents(b1));
+
+  b1.Clear();
+  ASSERT_EQ("", PrintContents(b1));
+  ASSERT_EQ(0, WriteBatchInternal::Count(&b1));
+}
+
+}  // namespace czy_leveldb
@@ -0,0 +1,136 @@
+#include "db/write_thread.h"
+
+#include <cassert>
+
+namespace czy_leveldb {
+
+WriteThread::WriteThread(bool enable_pipelined_write,
+                         bool allow_concurrent_memtable_write)
+    : pipelined_(enable_pipelined_write),
+      concurrent_memtable_(allow_concurrent_memtable_write) {}
+
+void WriteThread::WaitForState(Writer* w, std::unique_lock<std::mutex>* l) {
+  const State start = w->state;
+  while (w->state == start) {
+    w->cv.wait(*l);
+  }
+}
+
+void WriteThread::JoinBatchGroup(Writer* w) {
+  std::unique_lock<std::mutex> l(mu_);
+  wal_queue_.push_back(w);
+  if (wal_queue_.front() == w) {
+    w->state = kGroupLeader;
+    return;
+  }
+  WaitForState(w, &l);
+}
+
+void WriteThread::EnterAsBatchGroupLeader(Writer* leader, WriteGroup* group) {
+  std::lock_guard<std::mutex> l(mu_);
+  assert(leader->state == kGroupLeader);
+  assert(wal_queue_.front() == leader);
+
+  size_t size = leader->batch->ApproximateSize();
+  size_t max_size = kMaxGroupBytes;
+  if (size <= (128 << 10)) {
+    max_size = size + (128 << 10);
+  }
+
+  group->writers.clear();
+  group->writers.push_back(leader);
+  leader->group = group;
+  // Followers leave the log queue now; the leader leaves it in
+  // ReleaseWalStage().
+  auto it = wal_queue_.begin() + 1;
+  while (it != wal_queue_.end()) {
+    Writer* w = *it;
+    if (w->sync && !leader->sync) {
+      break;  // Do not make a non-sync group wait for a sync
+    }
+    size += w->batch->ApproximateSize();
+    if (size > max_size) {
+      break;
+    }
+    w->group = group;
+    group->writers.push_back(w);
+    it = wal_queue_.erase(it);
+  }
+}
+
+void WriteThread::ReleaseWalStage(Writer* leader) {
+  assert(wal_queue_.front() == leader);
+  wal_queue_.pop_front();
+  if (!wal_queue_.empty()) {
+    Writer* next = wal_queue_.front();
+    next->state = kGroupLeader;
+    next->cv.notify_one();
+  }
+}
+
+bool WriteThread::ExitWalStage(WriteGroup* group, const Status& status) {
+  std::unique_lock<std::mutex> l(mu_);
+  Writer* leader = group->writers.front();
+  group->status = status;
+  memtable_queue_.push_back(group);
+  if (pipelined_) {
+    ReleaseWalStage(leader);
+  }
+  while (memtable_queue_.front() != group) {
+    leader->cv.wait(l);
+  }
+
+  group->parallel = concurrent_memtable_ && status.ok() &&
+                    group->writers.size() > 1;
+  if (!group->parallel) {
+    return false;
+  }
+  group->running = group->writers.size();
+  for (size_t i = 1; i < group->writers.size(); i++) {
+    Writer* w = group->writers[i];
+    w->state = kParallelMemtableWriter;
+    w->cv.notify_one();
+  }
+  return true;
+}
+
+bool WriteThread::CompleteParallelMemtableWriter(Writer* w) {
+  std::unique_lock<std::mutex> l(mu_);
+  WriteGroup* group = w->group;
+  if (!w->status.ok() && group->status.ok()) {
+    group->status = w->status;
+  }
+  assert(group->running > 0);
+  if (--group->running == 0) {
+    return true;
+  }
+  WaitForState(w, &l);
+  return false;
+}
+
+void WriteThread::ExitMemtableStage(WriteGroup* group, Writer* self) {
+  std::lock_guard<std::mutex> l(mu_);
+  assert(memtable_queue_.front() == group);
+  memtable_queue_.pop_front();
+  if (!memtable_queue_.empty()) {
+    memtable_queue_.front()->writers.front()->cv.notify_one();
+  }
+
+  Writer* leader = group->writers.front();
+  if (!pipelined_) {
+    ReleaseWalStage(leader);
+  }
+
+  // "group" lives on the leader's stack, and each writer may return as
+  // soon as it is marked completed, so nothing may touch them after the
+  // lock is released.
+  for (Writer* w : group->writers) {
+    w->status = group->status;
+    w->state = kCompleted;
+    if (w != self) {
+      w->cv.notify_one();
+    }
+  }
+}
+
+}  // namespace czy_leveldb
@@ -0,0 +1,142 @@
+#pragma once
+// Coordinates concurrent DB::Write() calls.  Writers queue up; the one at
+// the head becomes the leader of a write group, appends the group's
+// batches to the log as one record, and then the group's batches are
+// inserted into the memtable and its last sequence number published.
+//
+// Two options relax the strictly serial leader:
+//
+//  - enable_pipelined_write: once a group's log write is done, the next
+//    group may form and write the log while the first one is still
+//    inserting into the memtable.  Groups still enter and leave the
+//    memtable stage in log order, so sequence numbers are published in
+//    order and a reader never sees a later write without an earlier one.
+//
+//  - allow_concurrent_memtable_write: every writer of a group inserts its
+//    own batch into the memtable, in parallel; the last one to finish
+//    publishes the group.
+//
+// Usage from DBImpl::Write():
+//
+//   WriteThread::Writer w(batch, options.sync);
+//   write_thread_.JoinBatchGroup(&w);
+//   if (w.state == WriteThread::kParallelMemtableWriter) {
+//     insert *w.batch at w.sequence;
+//     if (write_thread_.CompleteParallelMemtableWriter(&w)) {
+//       publish w.group->last_sequence;
+//       write_thread_.ExitMemtableStage(w.group, &w);
+//     }
+//     return w.status;
+//   }
+//   if (w.state == WriteThread::kCompleted) return w.status;
+//   // Leader.
+//   WriteThread::WriteGroup group;
+//   write_thread_.EnterAsBatchGroupLeader(&w, &group);
+//   assign sequences, write the log;
+//   if (write_thread_.ExitWalStage(&group, status)) {
+//     insert w's batch ... (parallel, as above)
+//   } else {
+//     insert every batch of the group; publish; ExitMemtableStage().
+//   }
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "leveldb/status.h"
+#include "leveldb/write_batch.h"
+
+namespace czy_leveldb {
+
+class WriteThread {
+ public:
+  enum State {
+    kInit,                    // Waiting in the queue
+    kGroupLeader,             // Must lead a group through the log write
+    kParallelMemtableWriter,  // Must insert its own batch
+    kCompleted,               // Done; "status" holds the result
+  };
+
+  struct WriteGroup;
+
+  struct Writer {
+    Writer(WriteBatch* b, bool s)
+        : batch(b), sync(s), state(kInit), group(nullptr), sequence(0) {}
+
+    WriteBatch* batch;
+    bool sync;
+    Status status;
+    State state;
+    WriteGroup* group;
+    // First sequence number of "batch", set by the leader.
+    uint64_t sequence;
+    std::condition_variable cv;
+  };
+
+  struct WriteGroup {
+    std::vector<Writer*> writers;  // Leader first, in queue order
+    uint64_t last_sequence = 0;    // Set by the leader
+    Status status;                 // Log or memtable failure, if any
+    size_t running = 0;            // Parallel writers not yet finished
+    bool parallel = false;
+  };
+
+  WriteThread(bool enable_pipelined_write,
+              bool allow_concurrent_memtable_write);
+
+  WriteThread(const WriteThread&) = delete;
+  WriteThread& operator=(const WriteThread&) = delete;
+
+  // Queue "w" and wait until it has something to do: lead a group,
+  // insert its batch as a parallel memtable writer, or nothing because
+  // its group has completed.  The result is in w->state.
+  void JoinBatchGroup(Writer* w);
+
+  // Form the group led by "leader" from the writers queued behind it.
+  // The group is capped at about 1MB of batches (less when the leader's
+  // batch is small, to keep small writes fast) and never adds a sync
+  // write to a group led by a non-sync one.
+  // REQUIRES: leader->state == kGroupLeader
+  void EnterAsBatchGroupLeader(Writer* leader, WriteGroup* group);
+
+  // Called by the leader once the group's log write finished with
+  // "status".  With pipelined writes, hands the log over to the next
+  // group right away.  Then waits for every earlier group to leave the
+  // memtable stage.  Returns true if the group's writers, the leader
+  // included, should now insert their own batches in parallel and
+  // finish with CompleteParallelMemtableWriter(); false if the leader
+  // must insert all of them and call ExitMemtableStage().  A failed
+  // group always returns false and inserts nothing.
+  bool ExitWalStage(WriteGroup* group, const Status& status);
+
+  // Called by each parallel writer after inserting its batch.  Returns
+  // true for the last writer of the group to finish, which must publish
+  // the group's last sequence and call ExitMemtableStage(); the others
+  // wait here until then.
+  bool CompleteParallelMemtableWriter(Writer* w);
+
+  // Finish the memtable stage of "group": let the next group in, mark
+  // every writer of the group completed with group->status and wake
+  // them.  "self" is the calling writer.
+  void ExitMemtableStage(WriteGroup* group, Writer* self);
+
+ private:
+  static const size_t kMaxGroupBytes = 1 << 20;
+
+  void WaitForState(Writer* w, std::unique_lock<std::mutex>* l);
+  // Pop the log stage's leader and promote the next queued writer.
+  void ReleaseWalStage(Writer* leader);
+
+  const bool pipelined_;
+  const bool concurrent_memtable_;
+
+  std::mutex mu_;
+  // Writers waiting for, or holding (at the front), the log stage.
+  std::deque<Writer*> wal_queue_;
+  // Groups in or waiting for the memtable stage, in log order.
+  std::deque<WriteGroup*> memtable_queue_;
+};
+
+}  // namespace czy_leveldb
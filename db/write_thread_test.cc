@@ -0,0 +1,172 @@
+#include "db/write_thread.h"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "db/write_batch_internal.h"
+#include "gtest/gtest.h"
+
+namespace czy_leveldb {
+
+namespace {
+
+// A stand-in for DBImpl::Write(), following the protocol documented in
+// write_thread.h, that checks the ordering guarantees as it goes.
+class FakeDB {
+ public:
+  FakeDB(bool pipelined, bool concurrent)
+      : write_thread_(pipelined, concurrent),
+        next_sequence_(1),
+        published_(0),
+        in_wal_(false),
+        inserted_(0),
+        groups_(0),
+        failed_groups_(0) {}
+
+  Status Write(WriteBatch* batch, bool sync) {
+    WriteThread::Writer w(batch, sync);
+    write_thread_.JoinBatchGroup(&w);
+    if (w.state == WriteThread::kParallelMemtableWriter) {
+      Insert(&w);
+      if (write_thread_.CompleteParallelMemtableWriter(&w)) {
+        Publish(w.group);
+        write_thread_.ExitMemtableStage(w.group, &w);
+      }
+      return w.status;
+    }
+    if (w.state == WriteThread::kCompleted) {
+      return w.status;
+    }
+
+    EXPECT_EQ(WriteThread::kGroupLeader, w.state);
+    WriteThread::WriteGroup group;
+    write_thread_.EnterAsBatchGroupLeader(&w, &group);
+    EXPECT_FALSE(in_wal_.exchange(true)) << "two groups writing the log";
+    for (WriteThread::Writer* follower : group.writers) {
+      EXPECT_FALSE(follower->sync && !w.sync) << "sync writer in async group";
+      follower->sequence = next_sequence_;
+      next_sequence_ += WriteBatchInternal::Count(follower->batch);
+    }
+    group.last_sequence = next_sequence_ - 1;
+    // Every seventh group fails its log write.
+    Status status;
+    if (++groups_ % 7 == 0) {
+      status = Status::IOError("injected log failure");
+      failed_groups_++;
+    }
+    in_wal_.store(false);
+
+    if (write_thread_.ExitWalStage(&group, status)) {
+      Insert(&w);
+      if (write_thread_.CompleteParallelMemtableWriter(&w)) {
+        Publish(&group);
+        write_thread_.ExitMemtableStage(&group, &w);
+      }
+    } else {
+      if (status.ok()) {
+        for (WriteThread::Writer* follower : group.writers) {
+          Insert(follower);
+        }
+      }
+      Publish(&group);
+      write_thread_.ExitMemtableStage(&group, &w);
+    }
+    return w.status;
+  }
+
+  uint64_t published() const { return published_.load(); }
+  int inserted() const { return inserted_.load(); }
+  int failed_groups() const { return failed_groups_; }
+
+ private:
+  void Insert(WriteThread::Writer* w) {
+    // Nothing at or above this writer's sequence may be visible yet.
+    EXPECT_LT(published_.load(), w->sequence);
+    inserted_.fetch_add(WriteBatchInternal::Count(w->batch));
+  }
+
+  void Publish(WriteThread::WriteGroup* group) {
+    // Groups are published in log order, each exactly once.
+    uint64_t last = published_.load();
+    EXPECT_LT(last, group->last_sequence);
+    const uint64_t first = group->writers.front()->sequence;
+    if (group->status.ok()) {
+      EXPECT_EQ(last + 1, first);
+    }
+    published_.store(group->last_sequence);
+  }
+
+  WriteThread write_thread_;
+  // Owned by whichever group is in the log stage.
+  uint64_t next_sequence_;
+  std::atomic<uint64_t> published_;
+  std::atomic<bool> in_wal_;
+  std::atomic<int> inserted_;
+  int groups_;
+  int failed_groups_;
+};
+
+void RunWriters(bool pipelined, bool concurrent) {
+  const int kThreads = 8;
+  const int kWritesPerThread = 200;
+  FakeDB db(pipelined, concurrent);
+  std::atomic<int> ok_writes(0);
+  std::atomic<int> failed_writes(0);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; t++) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < kWritesPerThread; i++) {
+        WriteBatch batch;
+        batch.Put("key" + std::to_string(t), std::to_string(i));
+        if (i % 3 == 0) {
+          batch.Delete("other");
+        }
+        Status s = db.Write(&batch, i % 5 == 0);
+        if (s.ok()) {
+          ok_writes++;
+        } else {
+          ASSERT_TRUE(s.IsIOError());
+          failed_writes++;
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(kThreads * kWritesPerThread, ok_writes + failed_writes);
+  ASSERT_GT(db.failed_groups(), 0);
+  ASSERT_GT(failed_writes, 0);
+  // One Put per write, plus a Delete in every third one, all sequenced.
+  const uint64_t records = kThreads * (kWritesPerThread +
+                                       (kWritesPerThread + 2) / 3);
+  ASSERT_EQ(records, db.published());
+  ASSERT_LT(db.inserted(), static_cast<int>(records));
+}
+
+}  // namespace
+
+TEST(WriteThreadTest, SingleWriterLeadsAlone) {
+  FakeDB db(false, false);
+  WriteBatch batch;
+  batch.Put("a", "1");
+  batch.Merge("a", "2");
+  ASSERT_TRUE(db.Write(&batch, false).ok());
+  ASSERT_EQ(2u, db.published());
+  ASSERT_EQ(2, db.inserted());
+}
+
+TEST(WriteThreadTest, Serial) { RunWriters(false, false); }
+
+TEST(WriteThreadTest, Pipelined) { RunWriters(true, false); }
+
+TEST(WriteThreadTest, ConcurrentMemtable) { RunWriters(false, true); }
+
+TEST(WriteThreadTest, PipelinedConcurrentMemtable) { RunWriters(true, true); }
+
+}  // namespace czy_leveldb
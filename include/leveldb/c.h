@@ -13,12 +13,14 @@ extern "C" {
 
 typedef struct leveldb_t leveldb_t;
 typedef struct leveldb_cache_t leveldb_cache_t;
+typedef struct leveldb_column_family_handle_t leveldb_column_family_handle_t;
 typedef struct leveldb_comparator_t leveldb_comparator_t;
 typedef struct leveldb_env_t leveldb_env_t;
 typedef struct leveldb_filelock_t leveldb_filelock_t;
 typedef struct leveldb_filterpolicy_t leveldb_filterpolicy_t;
 typedef struct leveldb_iterator_t leveldb_iterator_t;
 typedef struct leveldb_logger_t leveldb_logger_t;
+typedef struct leveldb_mergeoperator_t leveldb_mergeoperator_t;
 typedef struct leveldb_options_t leveldb_options_t;
 typedef struct leveldb_randomfile_t leveldb_randomfile_t;
 typedef struct leveldb_readoptions_t leveldb_readoptions_t;
@@ -35,6 +37,63 @@ LEVELDB_EXPORT leveldb_t* leveldb_open(const leveldb_options_t* options,
 
 LEVELDB_EXPORT void leveldb_close(leveldb_t* db);
 
+/* Column families */
+
+LEVELDB_EXPORT leveldb_t* leveldb_open_column_families(
+    const leveldb_options_t* options, const char* name, int num_column_families,
+    const char* const* column_family_names,
+    const leveldb_options_t* const* column_family_options,
+    leveldb_column_family_handle_t** column_family_handles, char** errptr);
+
+LEVELDB_EXPORT char** leveldb_list_column_families(
+    const leveldb_options_t* options, const char* name, size_t* lencf,
+    char** errptr);
+
+LEVELDB_EXPORT void leveldb_list_column_families_destroy(char** list,
+                                                         size_t len);
+
+LEVELDB_EXPORT leveldb_column_family_handle_t* leveldb_create_column_family(
+    leveldb_t* db, const leveldb_options_t* column_family_options,
+    const char* column_family_name, char** errptr);
+
+LEVELDB_EXPORT void leveldb_drop_column_family(
+    leveldb_t* db, leveldb_column_family_handle_t* handle, char** errptr);
+
+LEVELDB_EXPORT void leveldb_column_family_handle_destroy(
+    leveldb_t* db, leveldb_column_family_handle_t* handle);
+
+LEVELDB_EXPORT void leveldb_put_cf(leveldb_t* db,
+                                   const leveldb_writeoptions_t* options,
+                                   leveldb_column_family_handle_t* column_family,
+                                   const char* key, size_t keylen,
+                                   const char* val, size_t vallen,
+                                   char** errptr);
+
+LEVELDB_EXPORT void leveldb_delete_cf(
+    leveldb_t* db, const leveldb_writeoptions_t* options,
+    leveldb_column_family_handle_t* column_family, const char* key,
+    size_t keylen, char** errptr);
+
+LEVELDB_EXPORT void leveldb_delete_range_cf(
+    leveldb_t* db, const leveldb_writeoptions_t* options,
+    leveldb_column_family_handle_t* column_family, const char* begin_key,
+    size_t begin_keylen, const char* end_key, size_t end_keylen,
+    char** errptr);
+
+LEVELDB_EXPORT void leveldb_merge_cf(
+    leveldb_t* db, const leveldb_writeoptions_t* options,
+    leveldb_column_family_handle_t* column_family, const char* key,
+    size_t keylen, const char* val, size_t vallen, char** errptr);
+
+LEVELDB_EXPORT char* leveldb_get_cf(
+    leveldb_t* db, const leveldb_readoptions_t* options,
+    leveldb_column_family_handle_t* column_family, const char* key,
+    size_t keylen, size_t* vallen, char** errptr);
+
+LEVELDB_EXPORT leveldb_iterator_t* leveldb_create_iterator_cf(
+    leveldb_t* db, const leveldb_readoptions_t* options,
+    leveldb_column_family_handle_t* column_family);
+
 LEVELDB_EXPORT void leveldb_put(leveldb_t* db,
                                 const leveldb_writeoptions_t* options,
                                 const char* key, size_t keylen, const char* val,
@@ -45,6 +104,19 @@ LEVELDB_EXPORT void leveldb_delete(leveldb_t* db,
                                    const char* key, size_t keylen,
                                    char** errptr);
 
+LEVELDB_EXPORT void leveldb_delete_range(leveldb_t* db,
+                                         const leveldb_writeoptions_t* options,
+                                         const char* begin_key,
+                                         size_t begin_keylen,
+                                         const char* end_key,
+                                         size_t end_keylen, char** errptr);
+
+LEVELDB_EXPORT void leveldb_merge(leveldb_t* db,
+                                  const leveldb_writeoptions_t* options,
+                                  const char* key, size_t keylen,
+                                  const char* val, size_t vallen,
+                                  char** errptr);
+
 LEVELDB_EXPORT void leveldb_write(leveldb_t* db,
                                   const leveldb_writeoptions_t* options,
                                   leveldb_writebatch_t* batch, char** errptr);
@@ -56,6 +128,18 @@ LEVELDB_EXPORT char* leveldb_get(leveldb_t* db,
                                  const char* key, size_t keylen, size_t* vallen,
                                  char** errptr);
 
+/* Looks up num_keys keys with one call.  For each key i, sets
+   values_list[i] to a malloc()-ed copy of the value (or NULL if the key is
+   not found) with its length in values_list_sizes[i], and errs[i] to NULL
+   or a malloc()-ed error message. */
+LEVELDB_EXPORT void leveldb_multiget(leveldb_t* db,
+                                     const leveldb_readoptions_t* options,
+                                     size_t num_keys,
+                                     const char* const* keys_list,
+                                     const size_t* keys_list_sizes,
+                                     char** values_list,
+                                     size_t* values_list_sizes, char** errs);
+
 LEVELDB_EXPORT leveldb_iterator_t* leveldb_create_iterator(
     leveldb_t* db, const leveldb_readoptions_t* options);
 
@@ -114,6 +198,27 @@ LEVELDB_EXPORT void leveldb_writebatch_put(leveldb_writebatch_t*,
                                            const char* val, size_t vlen);
 LEVELDB_EXPORT void leveldb_writebatch_delete(leveldb_writebatch_t*,
                                               const char* key, size_t klen);
+LEVELDB_EXPORT void leveldb_writebatch_delete_range(leveldb_writebatch_t*,
+                                                    const char* begin_key,
+                                                    size_t begin_klen,
+                                                    const char* end_key,
+                                                    size_t end_klen);
+LEVELDB_EXPORT void leveldb_writebatch_merge(leveldb_writebatch_t*,
+                                             const char* key, size_t klen,
+                                             const char* val, size_t vlen);
+LEVELDB_EXPORT void leveldb_writebatch_put_cf(
+    leveldb_writebatch_t*, leveldb_column_family_handle_t* column_family,
+    const char* key, size_t klen, const char* val, size_t vlen);
+LEVELDB_EXPORT void leveldb_writebatch_delete_cf(
+    leveldb_writebatch_t*, leveldb_column_family_handle_t* column_family,
+    const char* key, size_t klen);
+LEVELDB_EXPORT void leveldb_writebatch_delete_range_cf(
+    leveldb_writebatch_t*, leveldb_column_family_handle_t* column_family,
+    const char* begin_key, size_t begin_klen, const char* end_key,
+    size_t end_klen);
+LEVELDB_EXPORT void leveldb_writebatch_merge_cf(
+    leveldb_writebatch_t*, leveldb_column_family_handle_t* column_family,
+    const char* key, size_t klen, const char* val, size_t vlen);
 LEVELDB_EXPORT void leveldb_writebatch_iterate(
     const leveldb_writebatch_t*, void* state,
     void (*put)(void*, const char* k, size_t klen, const char* v, size_t vlen),
@@ -129,6 +234,8 @@ LEVELDB_EXPORT void leveldb_options_set_comparator(leveldb_options_t*,
                                                    leveldb_comparator_t*);
 LEVELDB_EXPORT void leveldb_options_set_filter_policy(leveldb_options_t*,
                                                       leveldb_filterpolicy_t*);
+LEVELDB_EXPORT void leveldb_options_set_merge_operator(
+    leveldb_options_t*, leveldb_mergeoperator_t*);
 LEVELDB_EXPORT void leveldb_options_set_create_if_missing(leveldb_options_t*,
                                                           uint8_t);
 LEVELDB_EXPORT void leveldb_options_set_error_if_exists(leveldb_options_t*,
@@ -149,8 +256,24 @@ LEVELDB_EXPORT void leveldb_options_set_block_restart_interval(
 LEVELDB_EXPORT void leveldb_options_set_max_file_size(leveldb_options_t*,
                                                       size_t);
 
-enum { leveldb_no_compression = 0, leveldb_snappy_compression = 1 };
+enum {
+  leveldb_no_compression = 0,
+  leveldb_snappy_compression = 1,
+  leveldb_zstd_compression = 2,
+  leveldb_lz4_compression = 3
+};
 LEVELDB_EXPORT void leveldb_options_set_compression(leveldb_options_t*, int);
+LEVELDB_EXPORT void leveldb_options_set_zstd_compression_level(
+    leveldb_options_t*, int);
+LEVELDB_EXPORT void leveldb_options_set_zstd_max_dict_bytes(leveldb_options_t*,
+                                                            size_t);
+
+/* "level_values[i]" applies to level i and, for the last entry, to every
+   deeper level. */
+LEVELDB_EXPORT void leveldb_options_set_compression_per_level(
+    leveldb_options_t*, const int* level_values, size_t num_levels);
+LEVELDB_EXPORT void leveldb_options_set_block_size_per_level(
+    leveldb_options_t*, const size_t* level_values, size_t num_levels);
 
 /* Comparator */
 
@@ -176,6 +299,14 @@ LEVELDB_EXPORT void leveldb_filterpolicy_destroy(leveldb_filterpolicy_t*);
 LEVELDB_EXPORT leveldb_filterpolicy_t* leveldb_filterpolicy_create_bloom(
     int bits_per_key);
 
+/* Merge operator */
+
+LEVELDB_EXPORT leveldb_mergeoperator_t* leveldb_mergeoperator_create_uint64add(
+    void);
+LEVELDB_EXPORT leveldb_mergeoperator_t*
+leveldb_mergeoperator_create_string_append(char delimiter);
+LEVELDB_EXPORT void leveldb_mergeoperator_destroy(leveldb_mergeoperator_t*);
+
 /* Read options */
 
 LEVELDB_EXPORT leveldb_readoptions_t* leveldb_readoptions_create(void);
@@ -186,6 +317,8 @@ LEVELDB_EXPORT void leveldb_readoptions_set_fill_cache(leveldb_readoptions_t*,
                                                        uint8_t);
 LEVELDB_EXPORT void leveldb_readoptions_set_snapshot(leveldb_readoptions_t*,
                                                      const leveldb_snapshot_t*);
+LEVELDB_EXPORT void leveldb_readoptions_set_readahead_size(
+    leveldb_readoptions_t*, size_t);
 
 /* Write options */
 
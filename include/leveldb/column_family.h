@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+#include "leveldb/export.h"
+#include "leveldb/options.h"
+
+namespace czy_leveldb {
+
+// Name of the column family every DB has, which the DB::Put(), Get(),
+// Delete() etc. overloads without a handle operate on.  It can not be
+// dropped.
+LEVELDB_EXPORT extern const char kDefaultColumnFamilyName[];
+
+// A column family is an independent key space inside a DB.  Each one has
+// its own memtable, tables and compactions, and its own copy of the
+// options that describe its data: comparator, compression (and the per
+// level overrides), block_size, write_buffer_size, filter_policy,
+// merge_operator and the table format options.  The options that
+// describe the DB as a whole (env, info_log, the block cache, max_open_files,
+// paranoid_checks, reuse_logs) are taken from the Options passed to
+// DB::Open() and ignored here.
+//
+// All column families share the DB's write-ahead log, so one
+// WriteBatch can update several of them atomically and one group commit
+// (and one fsync) covers writes to all of them.
+struct LEVELDB_EXPORT ColumnFamilyDescriptor {
+  ColumnFamilyDescriptor() : name(kDefaultColumnFamilyName) {}
+  ColumnFamilyDescriptor(const std::string& n, const Options& o)
+      : name(n), options(o) {}
+
+  std::string name;
+  Options options;
+};
+
+// Refers to one open column family.  Handles are returned by DB::Open()
+// and DB::CreateColumnFamily(), and must be released with
+// DB::DestroyColumnFamilyHandle() before the DB is closed.
+class LEVELDB_EXPORT ColumnFamilyHandle {
+ public:
+  virtual ~ColumnFamilyHandle();
+
+  virtual const std::string& GetName() const = 0;
+
+  // Identifier of the family inside the DB.  Stable for the family's life
+  // and never reused after it is dropped.
+  virtual uint32_t GetID() const = 0;
+
+  // The comparator the family's keys are ordered by.
+  virtual const Comparator* GetComparator() const = 0;
+};
+
+}  // namespace czy_leveldb
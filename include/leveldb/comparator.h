@@ -3,6 +3,7 @@
 #include"leveldb/export.h"
 
 namespace czy_leveldb{
+class Slice;
 class LEVELDB_EXPORT Comparator{
 public:
     virtual ~Comparator();
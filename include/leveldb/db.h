@@ -1,10 +1,15 @@
 #pragma once
 #include<stdint.h>
 #include<cstdio>
+#include<string>
+#include<vector>
 
+#include"leveldb/column_family.h"
 #include"leveldb/export.h"
 #include"leveldb/iterator.h"
 #include"leveldb/options.h"
+#include"leveldb/pinnable_slice.h"
+#include"leveldb/table_properties.h"
 
 namespace czy_leveldb{
 
@@ -36,21 +41,170 @@ struct LEVELDB_EXPORT Range{
 class LEVELDB_EXPORT DB{
 public:
     static Status Open(const Options &options,const std::string&name,DB ** dbptr);
+
+    // Open the DB with the column families listed in "column_families".
+    // Every family the DB already holds must be listed (see
+    // ListColumnFamilies()), and kDefaultColumnFamilyName may be; if
+    // options.create_if_missing is set, listed families that do not exist
+    // yet are created.  On success *handles holds one handle per
+    // descriptor, in order, and the default family is also reachable via
+    // DefaultColumnFamily().
+    static Status Open(const Options& options, const std::string& name,
+                       const std::vector<ColumnFamilyDescriptor>& column_families,
+                       std::vector<ColumnFamilyHandle*>* handles,
+                       DB** dbptr);
+
+    // Set *column_families to the names of the column families in the DB
+    // "name", without opening it.
+    static Status ListColumnFamilies(const Options& options,
+                                     const std::string& name,
+                                     std::vector<std::string>* column_families);
     DB() = default;
     DB(const DB&) =  delete;
     DB& operator=(const DB &) = delete;
     virtual ~DB();
     virtual Status Put(const WriteOptions & options,const Slice & key,const Slice &value) = 0;
     virtual Status Delete(const WriteOptions &options,const Slice& key) = 0;
+
+    // Remove the database entries (if any) for every key in
+    // ["begin_key", "end_key").  Writes a single range tombstone, so the
+    // cost does not depend on how many keys the range holds.  Tables that
+    // the tombstone covers completely are dropped by compaction without
+    // being read.  Returns OK on success, and a non-OK status on error.
+    // It is not an error if the range holds no keys, and begin_key ==
+    // end_key deletes nothing.
+    // Note: consider setting options.sync = true.
+    virtual Status DeleteRange(const WriteOptions& options,
+                               const Slice& begin_key,
+                               const Slice& end_key) = 0;
+
+    // Merge "value" into the database entry for "key" using
+    // Options::merge_operator, without reading the current value: the
+    // operand is stored and folded in lazily when the key is read or
+    // compacted.  Returns InvalidArgument if the DB has no merge operator.
+    // Note: consider setting options.sync = true.
+    virtual Status Merge(const WriteOptions& options, const Slice& key,
+                         const Slice& value) = 0;
+
+    // Create a new, empty column family named "name" configured by
+    // "options" (see ColumnFamilyDescriptor for the fields that apply) and
+    // return a handle to it in *handle.
+    virtual Status CreateColumnFamily(const Options& options,
+                                      const std::string& name,
+                                      ColumnFamilyHandle** handle) = 0;
+
+    // Drop the column family: its data becomes unreachable and its files
+    // are deleted once no iterator or snapshot reads them.  The handle must
+    // still be released with DestroyColumnFamilyHandle().
+    virtual Status DropColumnFamily(ColumnFamilyHandle* column_family) = 0;
+
+    // Release a handle returned by Open() or CreateColumnFamily().
+    virtual Status DestroyColumnFamilyHandle(
+        ColumnFamilyHandle* column_family) = 0;
+
+    // Handle of the default column family, owned by the DB.
+    virtual ColumnFamilyHandle* DefaultColumnFamily() const = 0;
+
+    // Column family aware variants of the operations above.
+    virtual Status Put(const WriteOptions& options,
+                       ColumnFamilyHandle* column_family, const Slice& key,
+                       const Slice& value) = 0;
+    virtual Status Delete(const WriteOptions& options,
+                          ColumnFamilyHandle* column_family,
+                          const Slice& key) = 0;
+    virtual Status DeleteRange(const WriteOptions& options,
+                               ColumnFamilyHandle* column_family,
+                               const Slice& begin_key,
+                               const Slice& end_key) = 0;
+    virtual Status Merge(const WriteOptions& options,
+                         ColumnFamilyHandle* column_family, const Slice& key,
+                         const Slice& value) = 0;
+    virtual Status Get(const ReadOptions& options,
+                       ColumnFamilyHandle* column_family, const Slice& key,
+                       std::string* value) = 0;
+    virtual Iterator* NewIterator(const ReadOptions& options,
+                                  ColumnFamilyHandle* column_family) = 0;
     virtual Status Write(const WriteOptions &options,WriteBeatch *update) = 0;
     virtual Status Get(const Readoptions & options,const Slice &key,std::string* value ) = 0;
+
+    // Same as above, but avoids copying the value when possible: on
+    // success "*value" either refers directly to the block that holds it,
+    // which stays pinned in the block cache until value->Reset() or its
+    // destruction, or holds its own copy (e.g. for values found in the
+    // memtable or resolved from a blob file).
+    virtual Status Get(const ReadOptions& options, const Slice& key,
+                       PinnableSlice* value) = 0;
+
+    // Look up "num_keys" keys at once, setting values[i] and statuses[i]
+    // as a separate Get() of keys[i] would (NotFound for missing keys).
+    // All keys are read from one snapshot, the memtables are probed once
+    // for the whole batch, and lookups that land in the same table share
+    // one index probe and issue their data block reads together through
+    // RandomAccessFile::MultiRead().  "keys" need not be sorted.
+    virtual void MultiGet(const ReadOptions& options, size_t num_keys,
+                          const Slice* keys, PinnableSlice* values,
+                          Status* statuses) = 0;
+    virtual void MultiGet(const ReadOptions& options, size_t num_keys,
+                          const Slice* keys, std::string* values,
+                          Status* statuses) = 0;
+
+    // Non-blocking Get(), for callers on an event loop.  Calls
+    // (*callback)(arg, status, value) exactly once with the result of
+    // looking up "key"; "value" is only valid during the call.  If the
+    // value is in a memtable or the block cache, the callback runs inline
+    // before GetAsync() returns.  Otherwise the lookup continues on an I/O
+    // completion thread (see Options::async_io_threads) and the callback
+    // runs there, so it must be thread-safe and should not block.
+    // "key" need not outlive the call.
+    using GetCallback = void (*)(void* arg, const Status& status,
+                                 const Slice& value);
+    virtual void GetAsync(const ReadOptions& options, const Slice& key,
+                          GetCallback callback, void* arg) = 0;
     virtual Iterator * NewIterator(const ReadOptions & options) = 0;
     virtual const Snapshot * GetSnapshot() = 0;
     virtual void ReleaseSnapshot(const Snapshot* snapshot) = 0;
+    // DB implementations can export properties about their state via this
+    // method.  If "property" is a valid property understood by this DB
+    // implementation, fills "*value" with its current value and returns
+    // true.  Otherwise returns false.
+    //
+    // Valid property names include:
+    //
+    //  "leveldb.aggregated-table-properties" - returns the TableProperties
+    //     of every live table summed together, as name=value lines.
+    //  "leveldb.memtable-arena-usage" - returns the bytes of arena memory
+    //     held by the mutable and immutable memtables.
+    //  "leveldb.memtable-huge-page-usage" - returns the part of the above
+    //     backed by huge pages (see Options::memtable_huge_page_size).
     virtual bool GetProperty(const Slice& property, std::string* value) = 0;
+
+    // Fill "*props" with the properties of every live table, keyed by
+    // table file name.  The properties come from each table's properties
+    // meta block, so they are read through the table cache and cost no
+    // extra I/O for tables that are already open.
+    virtual Status GetPropertiesOfAllTables(TablePropertiesCollection* props) = 0;
     virtual void GetApproximateSizes(const Range* range, int n,
                                    uint64_t* sizes) = 0;
     virtual void CompactRange(const Slice* begin, const Slice* end) = 0;
+
+    // Apply the fields of "options" that are documented as changeable
+    // dynamically (e.g. compression, block_size, compression_per_level and
+    // block_size_per_level).  New values take effect for tables created
+    // after the call; existing tables are not rewritten.  Returns
+    // InvalidArgument, without changing anything, if a field that cannot
+    // change differs from the value the DB was opened with.
+    virtual Status ChangeOptions(const Options& options) = 0;
+
+    // Atomically add the tables at "paths", which must hold internal keys
+    // with sequence number zero, sorted by this DB's comparator, and must
+    // not overlap each other, to the DB.  Each file is placed on the deepest level that has
+    // no overlapping file, bypassing the log, the memtable and compaction.
+    // If its keys overlap data already in the DB, the file is assigned a
+    // sequence number newer than every existing write, so its contents
+    // take precedence; otherwise it keeps sequence number zero.
+    // On failure no file is added.
+    virtual Status IngestExternalFile(const std::vector<std::string>& paths,
+                                      const IngestExternalFileOptions& options) = 0;
 };
 LEVELDB_EXPORT Status DestroyDB(const std::string& name,
                                 const Options& options);
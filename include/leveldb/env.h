@@ -153,6 +153,12 @@ class LEVELDB_EXPORT Env {
   virtual Status RenameFile(const std::string& src,
                             const std::string& target) = 0;
 
+  // Create "target" as a hard link to the existing file "src".
+  //
+  // The default implementation returns NotSupported; callers must be
+  // prepared to fall back to copying the file.
+  virtual Status LinkFile(const std::string& src, const std::string& target);
+
   // Lock the specified file.  Used to prevent concurrent access to
   // the same db by multiple processes.  On failure, stores nullptr in
   // *lock and returns non-OK.
@@ -233,6 +239,19 @@ class LEVELDB_EXPORT SequentialFile {
   virtual Status Skip(uint64_t n) = 0;
 };
 
+// One read of a RandomAccessFile::MultiRead() batch.
+struct ReadRequest {
+  // Set by the caller: read "len" bytes at "offset" into "scratch".
+  uint64_t offset = 0;
+  size_t len = 0;
+  char* scratch = nullptr;
+
+  // Set by MultiRead(), with the same meaning as the result and return
+  // value of RandomAccessFile::Read().
+  Slice result;
+  Status status;
+};
+
 // A file abstraction for randomly reading the contents of a file.
 class LEVELDB_EXPORT RandomAccessFile {
  public:
@@ -254,6 +273,27 @@ class LEVELDB_EXPORT RandomAccessFile {
   // Safe for concurrent use by multiple threads.
   virtual Status Read(uint64_t offset, size_t n, Slice* result,
                       char* scratch) const = 0;
+
+  // Perform the "num_reqs" reads described by "reqs", which may overlap
+  // and be in any order, setting each request's result and status.
+  // Implementations may issue the reads concurrently; the default
+  // implementation calls Read() for each request in turn.  Returns a
+  // non-OK status only for errors that affect the whole batch.
+  //
+  // Safe for concurrent use by multiple threads.
+  virtual Status MultiRead(ReadRequest* reqs, size_t num_reqs) const;
+
+  // Start reading "req" without waiting for it, and call
+  // (*callback)(arg, req) from some other thread once req->result and
+  // req->status are set.  "req" and its scratch buffer must stay live
+  // until then.
+  //
+  // Files without native asynchronous reads keep the default, which
+  // returns NotSupported without calling "callback"; callers then run
+  // Read() on a thread of their own (see IOCompletionEngine).
+  using ReadCallback = void (*)(void* arg, ReadRequest* req);
+  virtual Status ReadAsync(ReadRequest* req, ReadCallback callback,
+                           void* arg) const;
 };
 
 // A file abstraction for sequential writing.  The implementation
@@ -362,6 +402,9 @@ class LEVELDB_EXPORT EnvWrapper : public Env {
   Status RenameFile(const std::string& s, const std::string& t) override {
     return target_->RenameFile(s, t);
   }
+  Status LinkFile(const std::string& s, const std::string& t) override {
+    return target_->LinkFile(s, t);
+  }
   Status LockFile(const std::string& f, FileLock** l) override {
     return target_->LockFile(f, l);
   }
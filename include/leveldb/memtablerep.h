@@ -0,0 +1,151 @@
+#pragma once
+// Pluggable in-memory representation of the memtable.
+//
+// The memtable encodes every entry into a single buffer: the internal key
+// and the value, each prefixed with its length as a varint32.  A MemTableRep only stores and
+// orders these buffers; it allocates them itself, so it can place them
+// next to its own index nodes.
+
+#include <cstddef>
+
+#include "leveldb/export.h"
+#include "leveldb/slice.h"
+
+namespace czy_leveldb {
+
+struct Options;
+class SliceTransform;
+
+class LEVELDB_EXPORT MemTableRep {
+ public:
+  // Orders encoded entries.  Supplied by the memtable.
+  class KeyComparator {
+   public:
+    virtual ~KeyComparator() = default;
+
+    // Three-way comparison of two encoded entries.
+    virtual int operator()(const char* a, const char* b) const = 0;
+
+    // Three-way comparison of an encoded entry with an internal key.
+    virtual int operator()(const char* entry, const Slice& key) const = 0;
+  };
+
+  // Opaque handle to an entry allocated by Allocate().
+  typedef void* KeyHandle;
+
+  MemTableRep() = default;
+
+  MemTableRep(const MemTableRep&) = delete;
+  MemTableRep& operator=(const MemTableRep&) = delete;
+
+  virtual ~MemTableRep();
+
+  // Allocate "len" bytes for an entry and set *buf to them.  The caller
+  // fills in the entry and then passes the handle to Insert() or
+  // InsertConcurrently().  Thread-safe if IsInsertConcurrentlySupported().
+  virtual KeyHandle Allocate(size_t len, char** buf) = 0;
+
+  // Insert the entry of "handle".
+  // REQUIRES: nothing that compares equal to the entry is in the rep.
+  // REQUIRES: external synchronization with other inserts.
+  virtual void Insert(KeyHandle handle) = 0;
+
+  // Like Insert(), but safe to call from several threads at once.  Only
+  // available if the factory's IsInsertConcurrentlySupported() is true.
+  virtual void InsertConcurrently(KeyHandle handle);
+
+  // Returns true iff an entry that compares equal to "entry" is in the rep.
+  virtual bool Contains(const char* entry) const = 0;
+
+  // Approximate number of bytes of memory used by the rep, including the
+  // entries.  Safe to call concurrently with inserts.
+  virtual size_t ApproximateMemoryUsage() = 0;
+
+  // The part of ApproximateMemoryUsage() backed by huge pages (see
+  // Options::memtable_huge_page_size).
+  virtual size_t ApproximateHugePageUsage() { return 0; }
+
+  // Called once the memtable has become immutable and will only be read
+  // (and flushed) from now on.  Reps that defer work, like sorting, can do
+  // it here.
+  virtual void MarkReadOnly() {}
+
+  // The user key of an encoded entry.
+  static Slice UserKey(const char* entry);
+
+  // Iteration over the encoded entries.  Safe to use concurrently with
+  // inserts, which an iterator may or may not observe.
+  class Iterator {
+   public:
+    virtual ~Iterator() = default;
+    virtual bool Valid() const = 0;
+    // REQUIRES: Valid()
+    virtual const char* key() const = 0;
+    virtual void Next() = 0;
+    virtual void Prev() = 0;
+    // Position at the first entry at or past internal key "target".
+    virtual void Seek(const Slice& target) = 0;
+    virtual void SeekToFirst() = 0;
+    virtual void SeekToLast() = 0;
+  };
+
+  // Return a new iterator over every entry in order, which the caller must
+  // delete.
+  virtual Iterator* GetIterator() = 0;
+
+  // Return a new iterator for Seek()s within the prefix (see
+  // Options::prefix_extractor) of the target.  It may skip entries of
+  // other prefixes, so the caller must stop once the prefix changes.  The
+  // default returns GetIterator().
+  virtual Iterator* GetPrefixIterator() { return GetIterator(); }
+};
+
+class LEVELDB_EXPORT MemTableRepFactory {
+ public:
+  virtual ~MemTableRepFactory();
+
+  // Return a new, empty rep ordering entries with "cmp", which outlives
+  // the rep.  "options" are the DB's options; reps size and back their
+  // arena according to them (e.g. memtable_huge_page_size).
+  virtual MemTableRep* CreateMemTableRep(const MemTableRep::KeyComparator& cmp,
+                                         const Options& options) = 0;
+
+  virtual const char* Name() const = 0;
+
+  // Whether reps from this factory implement InsertConcurrently().
+  // Options::allow_concurrent_memtable_write requires it.
+  virtual bool IsInsertConcurrentlySupported() const { return false; }
+};
+
+// Return a factory for skip list reps, the default.  Inserts are lock-free
+// (compare-and-swap on each level's links), so many writers can insert at
+// once, and entries are allocated from per-core arena blocks inline with
+// their skip list node.
+//
+// Callers must delete the result after any database that is using the
+// result has been closed.
+LEVELDB_EXPORT MemTableRepFactory* NewSkipListRepFactory();
+
+// Return a factory for vector reps, meant for write-only bulk loads.
+// Inserts append to an unsorted vector; the entries are sorted once, when
+// the memtable becomes read-only before its flush.  Reads before then sort
+// a copy and are slow.  "reserved" entries are preallocated.
+//
+// Callers must delete the result after any database that is using the
+// result has been closed.
+LEVELDB_EXPORT MemTableRepFactory* NewVectorRepFactory(size_t reserved = 0);
+
+// Return a factory for hash skip list reps, meant for prefix point lookups
+// and scans.  Entries are hashed by the prefix "prefix_extractor" gives
+// their user key into "bucket_count" buckets, each a skip list, so a Get or
+// prefix Seek only searches the small list of its prefix.  Iterating over
+// all entries (as the flush does) merges the buckets and is slower than
+// with a single skip list.
+//
+// "prefix_extractor" must outlive the factory and should be the DB's
+// Options::prefix_extractor.  Callers must delete the result after any
+// database that is using the result has been closed.
+LEVELDB_EXPORT MemTableRepFactory* NewHashSkipListRepFactory(
+    const SliceTransform* prefix_extractor, size_t bucket_count = 65536);
+
+}  // namespace czy_leveldb
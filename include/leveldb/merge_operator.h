@@ -0,0 +1,56 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "leveldb/export.h"
+
+namespace czy_leveldb {
+class Slice;
+
+// A MergeOperator turns read-modify-write into a blind write: DB::Merge()
+// records an operand for a key, and the operands are combined with the
+// key's base value only when the key is read or compacted.
+//
+// Operands are folded newest-over-oldest, so an operator must be
+// associative for PartialMerge() results to match the full fold.
+class LEVELDB_EXPORT MergeOperator {
+ public:
+  virtual ~MergeOperator();
+
+  // The name of the operator.  Stored with the DB and checked on open, like
+  // the comparator name, since operands are unreadable by any other
+  // operator.
+  virtual const char* Name() const = 0;
+
+  // Combine "operands", oldest first, with "existing_value", which is
+  // nullptr if the key had no value (never written, or deleted), and store
+  // the result in *new_value.  Returns false if the operands or the value
+  // are malformed; the read or compaction then fails with Corruption.
+  virtual bool FullMerge(const Slice& key, const Slice* existing_value,
+                         const std::vector<Slice>& operands,
+                         std::string* new_value) const = 0;
+
+  // Combine two operands, "left" older than "right", into one operand
+  // with the same effect, so compactions that do not reach the base value
+  // can still shrink long operand chains.  Returns false if the operands
+  // cannot be combined without the base value, in which case both are
+  // kept.  The default implementation never combines.
+  virtual bool PartialMerge(const Slice& key, const Slice& left,
+                            const Slice& right, std::string* new_value) const;
+};
+
+// Return a merge operator that treats values and operands as unsigned
+// 64-bit integers in little-endian fixed64 encoding and adds them, for
+// counters.  A missing base value counts as zero.
+//
+// Callers must delete the result after any database that is using the
+// result has been closed.
+LEVELDB_EXPORT const MergeOperator* NewUInt64AddOperator();
+
+// Return a merge operator that appends each operand to the value,
+// separated by "delimiter", for append-only lists.
+//
+// Callers must delete the result after any database that is using the
+// result has been closed.
+LEVELDB_EXPORT const MergeOperator* NewStringAppendOperator(char delimiter);
+}  // namespace czy_leveldb
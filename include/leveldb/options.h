@@ -1,5 +1,8 @@
 #pragma once
+#include<climits>
 #include<cstddef>
+#include<cstdint>
+#include<vector>
 #include"leveldb/export.h"
 
 namespace czy_leveldb{
@@ -8,6 +11,10 @@ class Comparator;
 class Env;
 class FilterPolicy;
 class Logger;
+class SliceTransform;
+class MemTableRepFactory;
+class MergeOperator;
+class Slice;
 class Snapshot;
 
 // DB contents are stored in a set of blocks, each of which holds a
@@ -18,7 +25,74 @@ enum class CompressionType {
   // NOTE: do not change the values of existing entries, as these are
   // part of the persistent format on disk.
   kNoCompression = 0x0,
-  kSnappyCompression = 0x1
+  kSnappyCompression = 0x1,
+  kZstdCompression = 0x2,
+  kLZ4Compression = 0x3
+};
+
+// Checksum stored in the trailer of every block.  The type is recorded in
+// the trailer itself, so tables written with different types can coexist.
+enum class ChecksumType {
+  kCRC32c = 0x0,
+  // Faster than crc32c where the CPU lacks SSE4.2.  Requires leveldb to be
+  // built with xxHash; otherwise blocks are written with kCRC32c.
+  kXXH3 = 0x1
+};
+
+// Selects the lookup structure stored at the end of each data block.
+enum class DataBlockIndexType {
+  // Only the restart array: point lookups binary-search the restart
+  // points and then scan the restart interval linearly.
+  kDataBlockBinarySearch = 0,
+  // Restart array plus a hash index mapping each user key to the restart
+  // interval containing it.  Blocks with this index are flagged in their
+  // trailer, so readers fall back to binary search for blocks without it.
+  kDataBlockBinaryAndHash = 1
+};
+
+// Format of the table files the DB writes.
+enum class TableFormat {
+  // Compressed, prefix-encoded blocks read through the block cache.
+  kBlockBased = 0,
+  // Uncompressed records with a hash index and a sparse sorted index, for
+  // data that is fully memory resident (see table/plain_table.h).
+  kPlain = 1
+};
+
+// How the DB merges tables in the background.
+enum class CompactionStyle {
+  // Each level is a sorted run about ten times the size of the previous
+  // one.  Lowest space and read amplification, highest write
+  // amplification, since a key is rewritten once per level.
+  kLevel = 0,
+  // Tiered: sorted runs of similar size are merged together (see
+  // CompactionOptionsUniversal).  Far lower write amplification, at the
+  // cost of more sorted runs per read and up to
+  // max_size_amplification_percent extra space.
+  kUniversal = 1
+};
+
+// Tuning of CompactionStyle::kUniversal.  Sorted runs are each level-0
+// table and each non-empty deeper level, ordered from newest to oldest.
+struct LEVELDB_EXPORT CompactionOptionsUniversal {
+  // A compaction is considered once there are at least this many sorted
+  // runs.  If neither of the rules below picks one and there are more,
+  // the newest runs are merged to get back to this number.
+  int num_sorted_runs_trigger = 4;
+
+  // Percentage flexibility when comparing run sizes: a run joins the
+  // runs newer than it if it is at most (100 + size_ratio)% of their
+  // total size.
+  unsigned int size_ratio = 1;
+
+  // Fewest and most sorted runs merged by one size ratio compaction.
+  unsigned int min_merge_width = 2;
+  unsigned int max_merge_width = UINT_MAX;
+
+  // If every run but the oldest together exceed this percentage of the
+  // oldest run, all runs are merged into one.  200 bounds the space used
+  // to about three times the live data.
+  unsigned int max_size_amplification_percent = 200;
 };
 
 // Options to control the behavior of a database (passed to DB::Open)
@@ -73,6 +147,40 @@ struct LEVELDB_EXPORT Options {
   // the next time the database is opened.
   size_t write_buffer_size = 4 * 1024 * 1024;
 
+  // Factory for the memtable's in-memory representation.  If null, a skip
+  // list rep (NewSkipListRepFactory()) is used; it supports concurrent
+  // inserts, as allow_concurrent_memtable_write requires.
+  MemTableRepFactory* memtable_factory = nullptr;
+
+  // If non-zero, memtables allocate their arena blocks from huge pages of
+  // this size (e.g. 2 * 1024 * 1024), bound to the NUMA node of the core
+  // that writes them, which saves TLB misses when searching a large
+  // memtable.  The OS must have huge pages reserved (vm.nr_hugepages);
+  // otherwise ordinary pages are used.  A memtable that once fails to map
+  // a huge page uses ordinary pages until it is flushed, even if huge
+  // pages are freed meanwhile; the next memtable tries again.  Every core
+  // that writes reserves at least one huge page per memtable, so keep
+  // write_buffer_size well above huge page size times the number of cores.
+  size_t memtable_huge_page_size = 0;
+
+  // If non-null, groups user keys by the prefix this transform returns.
+  // Memtable reps such as NewHashSkipListRepFactory() use it to bucket
+  // keys, so Get()s and Seek()s only search keys of the same prefix.
+  const SliceTransform* prefix_extractor = nullptr;
+
+  // If positive, each memtable keeps a Bloom filter of this fraction of
+  // write_buffer_size (capped at 0.25) that Get() checks before searching
+  // the memtable, which saves the search for keys the memtable does not
+  // hold.  The filter holds the prefix (see prefix_extractor) of every
+  // key, and the whole key too if memtable_whole_key_filtering is set.
+  // 0.02 to 0.1 is a reasonable range.
+  double memtable_prefix_bloom_size_ratio = 0;
+
+  // If true, the memtable Bloom filter also holds whole keys, so it can
+  // serve Get()s without a prefix_extractor, and with one, filters keys
+  // that share a prefix with keys in the memtable.
+  bool memtable_whole_key_filtering = false;
+
   // Number of open files that can be used by the DB.  You may need to
   // increase this if your database has a large working set (budget
   // one open file per 2MB of working set).
@@ -85,6 +193,25 @@ struct LEVELDB_EXPORT Options {
   // If null, leveldb will automatically create and use an 8MB internal cache.
   Cache* block_cache = nullptr;
 
+  // If true, index and filter blocks are read through block_cache, are
+  // charged against its capacity and are evicted like data blocks,
+  // instead of being held by every open table for its whole lifetime.
+  // Bounds and shares metadata memory at the cost of an extra cache lookup
+  // per table access.
+  bool cache_index_and_filter_blocks = false;
+
+  // If true and cache_index_and_filter_blocks is set, the index and filter
+  // blocks of level-0 tables, which every read consults, keep a handle in
+  // the cache for as long as the table is open so they are never evicted.
+  // Their charge still counts against block_cache's capacity.
+  bool pin_l0_filter_and_index_blocks_in_cache = false;
+
+  // If true, Table::Open() only records the file and defers reading the
+  // footer, index and filter until the first lookup or iterator on the
+  // table.  Speeds up opening a DB with many files; the first read of each
+  // table pays for the deferred I/O instead.
+  bool lazy_table_open = false;
+
   // Approximate size of user data packed per block.  Note that the
   // block size specified here corresponds to uncompressed data.  The
   // actual size of the unit read from disk may be smaller if
@@ -96,6 +223,38 @@ struct LEVELDB_EXPORT Options {
   // leave this parameter alone.
   int block_restart_interval = 16;
 
+  // Lookup structure written into each data block.  kDataBlockBinaryAndHash
+  // lets a point Get() jump straight to the restart interval holding the
+  // key, at the cost of roughly one byte per key per block.  Blocks with
+  // more than 253 restart points are written without the hash index.
+  // This parameter can be changed dynamically.
+  DataBlockIndexType data_block_index_type =
+      DataBlockIndexType::kDataBlockBinarySearch;
+
+  // Ratio of keys to hash buckets when data_block_index_type is
+  // kDataBlockBinaryAndHash.  Lower values mean fewer collisions and a
+  // bigger index.  Most clients should leave this parameter alone.
+  double data_block_hash_table_util_ratio = 0.75;
+
+  // If true, store the first 8 bytes of every restart key's user key next
+  // to the restart array so block seeks can narrow down the restart interval with
+  // integer (SIMD where available) comparisons before calling the
+  // comparator.  Costs 8 bytes per restart point.  Ignored unless
+  // comparator is BytewiseComparator().
+  // This parameter can be changed dynamically.
+  bool block_restart_key_prefixes = false;
+
+  // Checksum written into new blocks.  Reads verify whichever checksum a
+  // block was written with.  This parameter can be changed dynamically.
+  ChecksumType checksum_type = ChecksumType::kCRC32c;
+
+  // Format used for new table files.  kPlain is meant for datasets that
+  // fit in memory and are read through mmap: Get() returns slices straight
+  // into the mapping and bypasses block_cache, compression and
+  // filter_policy.  Tables already on disk are read in whatever format
+  // they were written with.
+  TableFormat table_format = TableFormat::kBlockBased;
+
   // Leveldb will write up to this amount of bytes to a file before
   // switching to a new one.
   // Most clients should leave this parameter alone.  However if your
@@ -106,6 +265,11 @@ struct LEVELDB_EXPORT Options {
   // initially populating a large database.
   size_t max_file_size = 2 * 1024 * 1024;
 
+  // Compaction strategy, and its tuning when it is kUniversal.  Changing
+  // the style of an existing DB is not supported.
+  CompactionStyle compaction_style = CompactionStyle::kLevel;
+  CompactionOptionsUniversal compaction_options_universal;
+
   // Compress blocks using the specified compression algorithm.  This
   // parameter can be changed dynamically.
   //
@@ -122,6 +286,46 @@ struct LEVELDB_EXPORT Options {
   // efficiently detect that and will switch to uncompressed mode.
   CompressionType compression = CompressionType::kSnappyCompression;
 
+  // Compression level for kZstdCompression.  Higher levels compress better
+  // and run slower; -5 through 22 are accepted.  This parameter can be
+  // changed dynamically.
+  int zstd_compression_level = 1;
+
+  // If non-zero and compression is kZstdCompression, each table trains a
+  // zstd dictionary of up to this many bytes from a sample of its data
+  // blocks, stores it in a meta block and compresses every data block with
+  // it.  Helps most with small, similar values (e.g. JSON documents) that
+  // compress poorly one block at a time.  Data blocks are buffered
+  // uncompressed until the dictionary is trained in TableBuilder::Finish().
+  // This parameter can be changed dynamically.
+  size_t zstd_max_dict_bytes = 0;
+
+  // Upper bound on the block bytes sampled to train the dictionary.  Zero
+  // means 100 times zstd_max_dict_bytes.
+  size_t zstd_max_train_bytes = 0;
+
+  // Number of threads each TableBuilder uses to compress data blocks.  With
+  // more than one, finished blocks are compressed in the background while
+  // the builder keeps accepting keys, and are written to the file in order.
+  // Worth raising when flushes and compactions are bound by compression
+  // CPU, e.g. with kZstdCompression at a high zstd_compression_level.
+  int parallel_compression_threads = 1;
+
+  // Per-level overrides of compression and block_size.  Entry i applies to
+  // tables written to level i, and the last entry also applies to every
+  // deeper level; an empty vector means compression / block_size is used
+  // everywhere.  Typical use is cheap or no compression on the upper
+  // levels, where write amplification dominates, and kZstdCompression with
+  // bigger blocks on the bottommost level, where most of the data lives.
+  // These parameters can be changed dynamically; the new values apply to
+  // tables created afterwards.
+  std::vector<CompressionType> compression_per_level;
+  std::vector<size_t> block_size_per_level;
+
+  // Return the compression / block size for tables written to "level".
+  CompressionType CompressionForLevel(int level) const;
+  size_t BlockSizeForLevel(int level) const;
+
   // EXPERIMENTAL: If true, append to existing MANIFEST and log files
   // when a database is opened.  This can significantly speed up open.
   //
@@ -132,6 +336,54 @@ struct LEVELDB_EXPORT Options {
   // Many applications will benefit from passing the result of
   // NewBloomFilterPolicy() here.
   const FilterPolicy* filter_policy = nullptr;
+
+  // If non-null, enables DB::Merge() and WriteBatch::Merge(): operands are
+  // stored as entries of their own and folded into the key's value by
+  // this operator during Get(), iteration and compaction.  A DB that
+  // holds merge operands must always be opened with an operator of the
+  // same name.
+  const MergeOperator* merge_operator = nullptr;
+
+  // If true, values of at least min_blob_size bytes are written to
+  // separate append-only blob files when memtables are flushed, and the
+  // tables hold only a small reference to them.  Compactions then move
+  // references instead of rewriting large values on every level.  Reads
+  // resolve references transparently, at the cost of one extra read per
+  // blob value.  Blob files written while this was true stay readable
+  // after it is turned off.
+  bool enable_blob_files = false;
+
+  // Values smaller than this stay inline in the tables.
+  size_t min_blob_size = 4 * 1024;
+
+  // A new blob file is started once the current one reaches this size.
+  uint64_t blob_file_size = 256 * 1024 * 1024;
+
+  // Compression applied to each blob value individually.
+  CompressionType blob_compression = CompressionType::kNoCompression;
+
+  // If true, compactions relocate the live values of blob files whose
+  // garbage ratio (bytes of overwritten or deleted values over the file
+  // size) has reached blob_garbage_collection_ratio, and the old files are
+  // deleted once no table refers to them.
+  bool enable_blob_garbage_collection = true;
+  double blob_garbage_collection_ratio = 0.5;
+
+  // Number of threads DB::GetAsync() uses to wait for reads of files that
+  // do not support RandomAccessFile::ReadAsync().  Lookups answered from
+  // the memtables or the block cache never use them.
+  int async_io_threads = 4;
+
+  // If true, a write group's log write can overlap the memtable insertion
+  // of the group before it, so with many concurrent writers the log
+  // device and the memtable are kept busy at the same time.  Writes still
+  // become visible in log order.
+  bool enable_pipelined_write = false;
+
+  // If true, the writers of a write group insert their own batches into
+  // the memtable in parallel instead of the group's leader inserting all
+  // of them.  Requires a memtable that supports concurrent inserts.
+  bool allow_concurrent_memtable_write = false;
 };
 
 // Options that control read operations
@@ -149,6 +401,28 @@ struct LEVELDB_EXPORT ReadOptions {
   // not have been released).  If "snapshot" is null, use an implicit
   // snapshot of the state at the beginning of this read operation.
   const Snapshot* snapshot = nullptr;
+
+  // If non-zero, iterators read this many bytes ahead of every data block
+  // read that misses their readahead buffer, starting with the first one.
+  // If zero, iterators switch readahead on by themselves once they see
+  // sequential block reads, growing it from 8KB to 256KB as the scan
+  // continues.  Point lookups never read ahead.
+  size_t readahead_size = 0;
+
+  // If non-null, iterators only return keys at or after
+  // *iterate_lower_bound: Seek() and SeekToFirst() start there and Prev()
+  // stops there.  Tables and blocks wholly before the bound are not read.
+  // The bound must stay live while any iterator created with these
+  // options is in use.
+  const Slice* iterate_lower_bound = nullptr;
+
+  // If non-null, iterators only return keys strictly before
+  // *iterate_upper_bound: Next() makes the iterator invalid at the bound
+  // instead of reading on, and SeekToLast() starts just before it.
+  // Tables and blocks wholly at or after the bound are not read.  The
+  // bound must stay live while any iterator created with these options is
+  // in use.
+  const Slice* iterate_upper_bound = nullptr;
 };
 
 // Options that control write operations
@@ -172,4 +446,22 @@ struct LEVELDB_EXPORT WriteOptions {
   bool sync = false;
 };
 
+// Options that control DB::IngestExternalFile()
+struct LEVELDB_EXPORT IngestExternalFileOptions {
+  // If true, the files are hard-linked into the DB directory and the
+  // originals removed, instead of being copied.  Falls back to copying if
+  // the Env does not support LinkFile() or the files are on another
+  // filesystem.
+  bool move_files = false;
+
+  // If true, the files are ingested only if they do not overlap any key
+  // in the memtables; otherwise the memtables are flushed first so the
+  // files can be given sequence numbers newer than every existing write.
+  bool fail_if_memtable_overlaps = false;
+
+  // If true, every block of the files is read and its checksum verified
+  // before the files are added to the DB.
+  bool verify_checksums_before_ingest = false;
+};
+
 }
\ No newline at end of file
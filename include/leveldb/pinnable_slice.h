@@ -0,0 +1,92 @@
+#pragma once
+#include <cassert>
+#include <string>
+
+#include "leveldb/export.h"
+#include "leveldb/slice.h"
+
+namespace czy_leveldb {
+
+// A Slice that can keep the memory it refers to alive.  DB::Get() either
+// pins the value in place, typically inside a block held by the block
+// cache, registering a cleanup that releases the block when the
+// PinnableSlice is reset or destroyed; or it copies the value into a
+// buffer owned by the PinnableSlice ("self").  Either way the caller reads
+// it through the Slice interface, and the pinned path involves no
+// allocation or copy.
+//
+// Pinned memory is held until Reset() or destruction, so callers should
+// not keep a PinnableSlice around longer than they need the value.
+class LEVELDB_EXPORT PinnableSlice : public Slice {
+ public:
+  using CleanupFunction = void (*)(void* arg1, void* arg2);
+
+  PinnableSlice() : buf_(&self_space_) { ClearCleanup(); }
+
+  // Use "*buf" rather than an internal string for values copied into
+  // self, e.g. so a caller can reuse one buffer across many lookups.
+  // "*buf" must outlive this PinnableSlice.
+  explicit PinnableSlice(std::string* buf) : buf_(buf) { ClearCleanup(); }
+
+  PinnableSlice(const PinnableSlice&) = delete;
+  PinnableSlice& operator=(const PinnableSlice&) = delete;
+
+  ~PinnableSlice() { Reset(); }
+
+  // Refer to "s" and call (*function)(arg1, arg2) once it is no longer
+  // needed.
+  // REQUIRES: !IsPinned()
+  void PinSlice(const Slice& s, CleanupFunction function, void* arg1,
+                void* arg2) {
+    assert(!IsPinned());
+    assert(function != nullptr);
+    Slice::operator=(s);
+    function_ = function;
+    arg1_ = arg1;
+    arg2_ = arg2;
+  }
+
+  // Copy "s" into the self buffer and refer to the copy.
+  // REQUIRES: !IsPinned()
+  void PinSelf(const Slice& s) {
+    assert(!IsPinned());
+    buf_->assign(s.data(), s.size());
+    Slice::operator=(*buf_);
+  }
+
+  // Refer to the self buffer after the caller filled it via GetSelf().
+  // REQUIRES: !IsPinned()
+  void PinSelf() {
+    assert(!IsPinned());
+    Slice::operator=(*buf_);
+  }
+
+  std::string* GetSelf() { return buf_; }
+
+  // True if the value refers to memory this PinnableSlice does not own.
+  bool IsPinned() const { return function_ != nullptr; }
+
+  // Release any pinned memory and make the slice empty.
+  void Reset() {
+    if (function_ != nullptr) {
+      (*function_)(arg1_, arg2_);
+      ClearCleanup();
+    }
+    Slice::clear();
+  }
+
+ private:
+  void ClearCleanup() {
+    function_ = nullptr;
+    arg1_ = nullptr;
+    arg2_ = nullptr;
+  }
+
+  std::string self_space_;
+  std::string* buf_;
+  CleanupFunction function_;
+  void* arg1_;
+  void* arg2_;
+};
+
+}  // namespace czy_leveldb
@@ -0,0 +1,44 @@
+#pragma once
+#include <string>
+
+#include "leveldb/export.h"
+#include "leveldb/slice.h"
+
+namespace czy_leveldb {
+
+// Maps a key to a part of it, typically a prefix, that groups keys which
+// are looked up together.  Used as Options::prefix_extractor, e.g. by the
+// hash skip list memtable to bucket keys by prefix.
+class LEVELDB_EXPORT SliceTransform {
+ public:
+  virtual ~SliceTransform();
+
+  // The name of the transformation.  Changing the transformation of an
+  // existing DB requires changing the name.
+  virtual const char* Name() const = 0;
+
+  // Return the transformed key.
+  // REQUIRES: InDomain(key)
+  virtual Slice Transform(const Slice& key) const = 0;
+
+  // Returns true if Transform() can be applied to "key".  Keys outside the
+  // domain are handled as if each had a group of its own.
+  virtual bool InDomain(const Slice& key) const = 0;
+};
+
+// Return a transform that maps a key to its first "prefix_len" bytes.  Keys
+// shorter than that are outside the domain.
+//
+// Callers must delete the result after any database that is using the
+// result has been closed.
+LEVELDB_EXPORT const SliceTransform* NewFixedPrefixTransform(
+    size_t prefix_len);
+
+// Return a transform that maps a key to its first "cap_len" bytes, or the
+// whole key if it is shorter.  Every key is in the domain.
+//
+// Callers must delete the result after any database that is using the
+// result has been closed.
+LEVELDB_EXPORT const SliceTransform* NewCappedPrefixTransform(size_t cap_len);
+
+}  // namespace czy_leveldb
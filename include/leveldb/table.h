@@ -1,6 +1,7 @@
 #pragma once
 #include <cstdint>
 
+#include "leveldb/cache.h"
 #include "leveldb/export.h"
 #include "leveldb/iterator.h"
 
@@ -34,6 +35,12 @@ class LEVELDB_EXPORT Table {
   static Status Open(const Options& options, RandomAccessFile* file,
                      uint64_t file_size, Table** table);
 
+  // Same as above for a table that lives on "level" of the DB.  The level
+  // decides whether the table's index and filter blocks are pinned in the
+  // block cache (see Options::pin_l0_filter_and_index_blocks_in_cache).
+  static Status Open(const Options& options, RandomAccessFile* file,
+                     uint64_t file_size, int level, Table** table);
+
   Table(const Table&) = delete;
   Table& operator=(const Table&) = delete;
 
@@ -44,6 +51,11 @@ class LEVELDB_EXPORT Table {
   // call one of the Seek methods on the iterator before using it).
   Iterator* NewIterator(const ReadOptions&) const;
 
+  // Returns a new iterator over the table's range tombstones, keyed by the
+  // internal start key with the end key as value, or nullptr if the table
+  // has none.
+  Iterator* NewRangeTombstoneIterator(const ReadOptions&) const;
+
   // Given a key, return an approximate byte offset in the file where
   // the data for that key begins (or would begin if the key were
   // present in the file).  The returned value is in terms of file
@@ -67,6 +79,18 @@ class LEVELDB_EXPORT Table {
                      void (*handle_result)(void* arg, const Slice& k,
                                            const Slice& v));
 
+  // Read the footer, index and filter if Open() deferred them
+  // (Options::lazy_table_open).  Safe to call concurrently; only the first
+  // call does any I/O, and its status is returned by every later call.
+  Status EnsureMetaLoaded() const;
+
+  // Return the index block, either owned by the table or looked up in the
+  // block cache when Options::cache_index_and_filter_blocks is set.  In the
+  // latter case *cache_handle is set and must be released by the caller
+  // unless the block is pinned.
+  Status GetIndexBlock(const ReadOptions&, Block** index_block,
+                       Cache::Handle** cache_handle) const;
+
   void ReadMeta(const Footer& footer);
   void ReadFilter(const Slice& filter_handle_value);
 
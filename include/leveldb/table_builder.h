@@ -37,6 +37,13 @@ class LEVELDB_EXPORT TableBuilder {
   // REQUIRES: Finish(), Abandon() have not been called
   void Add(const Slice& key, const Slice& value);
 
+  // Add a range tombstone to the table's range deletion meta block.
+  // "start_key" is an internal key of type kTypeRangeDeletion and
+  // "end_key" the exclusive user key end of the range.  Tombstones may be
+  // added in any order, interleaved with Add().
+  // REQUIRES: Finish(), Abandon() have not been called
+  void AddRangeTombstone(const Slice& start_key, const Slice& end_key);
+
   // Advanced operation: flush any buffered key/value pairs to file.
   // Can be used to ensure that two adjacent entries never live in
   // the same data block.  Most clients should not need to use this method.
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "leveldb/export.h"
+#include "leveldb/slice.h"
+#include "leveldb/status.h"
+
+namespace czy_leveldb {
+
+// Name of the meta block that holds a table's properties.  Tables written
+// before properties were recorded simply have no such block.
+extern const char kPropertiesBlockName[];
+
+// Summary statistics recorded by TableBuilder::Finish() for one table.
+struct LEVELDB_EXPORT TableProperties {
+  uint64_t num_entries = 0;     // Entries added, including deletions
+  uint64_t num_deletions = 0;   // Deletion markers among num_entries
+  uint64_t num_range_deletions = 0;  // Range tombstones, not in num_entries
+  uint64_t raw_key_size = 0;    // Sum of user key sizes, before compression
+  uint64_t raw_value_size = 0;  // Sum of value sizes, before compression
+  uint64_t data_size = 0;       // Bytes of data blocks, including trailers
+  uint64_t index_size = 0;      // Bytes of the index block
+  uint64_t filter_size = 0;     // Bytes of the filter block, 0 if none
+  uint64_t num_data_blocks = 0;
+  uint64_t smallest_seqno = 0;  // Smallest sequence number of any entry
+  uint64_t largest_seqno = 0;   // Largest sequence number of any entry
+  uint64_t creation_time = 0;   // Seconds since the epoch, 0 if unknown
+
+  // Accumulate the counters of "other" into this.  Sizes and counts are
+  // summed, sequence numbers widened, and creation_time keeps the oldest
+  // known value.  Used to aggregate over all tables of a DB.
+  void Add(const TableProperties& other);
+
+  // Serialize into *dst, the contents of the properties meta block.
+  void EncodeTo(std::string* dst) const;
+
+  // Parse the contents of a properties meta block.  Properties this
+  // version does not know about are skipped, and ones missing from the
+  // block keep their default value.
+  Status DecodeFrom(const Slice& input);
+
+  // Human readable "name=value" lines, as returned by
+  // DB::GetProperty("leveldb.aggregated-table-properties").
+  std::string ToString() const;
+};
+
+// Table file name -> properties of that table.
+typedef std::map<std::string, TableProperties> TablePropertiesCollection;
+
+}  // namespace czy_leveldb
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <string>
 
 #include "leveldb/export.h"
@@ -6,6 +7,7 @@
 
 namespace czy_leveldb {
 
+class ColumnFamilyHandle;
 class Slice;
 
 class LEVELDB_EXPORT WriteBatch {
@@ -15,6 +17,31 @@ class LEVELDB_EXPORT WriteBatch {
     virtual ~Handler();
     virtual void Put(const Slice& key, const Slice& value) = 0;
     virtual void Delete(const Slice& key) = 0;
+    // Handlers written before range deletions existed ignore them.
+    virtual void DeleteRange(const Slice& /*begin_key*/,
+                             const Slice& /*end_key*/) {}
+    // Handlers written before merge operands existed ignore them.
+    virtual void Merge(const Slice& /*key*/, const Slice& /*value*/) {}
+
+    // Column family aware variants.  The defaults pass operations on the
+    // default column family (id 0) to Put() / Delete() / DeleteRange() /
+    // Merge() and ignore the rest, so handlers unaware of column families
+    // see what they did before.
+    virtual void PutCF(uint32_t column_family_id, const Slice& key,
+                       const Slice& value) {
+      if (column_family_id == 0) Put(key, value);
+    }
+    virtual void DeleteCF(uint32_t column_family_id, const Slice& key) {
+      if (column_family_id == 0) Delete(key);
+    }
+    virtual void DeleteRangeCF(uint32_t column_family_id,
+                               const Slice& begin_key, const Slice& end_key) {
+      if (column_family_id == 0) DeleteRange(begin_key, end_key);
+    }
+    virtual void MergeCF(uint32_t column_family_id, const Slice& key,
+                         const Slice& value) {
+      if (column_family_id == 0) Merge(key, value);
+    }
   };
 
   WriteBatch();
@@ -31,6 +58,27 @@ class LEVELDB_EXPORT WriteBatch {
   // If the database contains a mapping for "key", erase it.  Else do nothing.
   void Delete(const Slice& key);
 
+  // Erase every mapping whose key is in ["begin_key", "end_key"), as one
+  // range tombstone rather than a deletion per key.
+  // REQUIRES: begin_key <= end_key according to the DB's comparator.
+  void DeleteRange(const Slice& begin_key, const Slice& end_key);
+
+  // Record "value" as a merge operand for "key", to be combined with the
+  // key's existing value by the DB's Options::merge_operator.
+  void Merge(const Slice& key, const Slice& value);
+
+  // Same as Put() / Delete() / DeleteRange() / Merge() for
+  // "column_family".  One batch may update several column families of the
+  // same DB, atomically.  Range bounds and merge operands are interpreted
+  // with the family's comparator and merge operator.
+  void Put(ColumnFamilyHandle* column_family, const Slice& key,
+           const Slice& value);
+  void Delete(ColumnFamilyHandle* column_family, const Slice& key);
+  void DeleteRange(ColumnFamilyHandle* column_family, const Slice& begin_key,
+                   const Slice& end_key);
+  void Merge(ColumnFamilyHandle* column_family, const Slice& key,
+             const Slice& value);
+
   // Clear all updates buffered in this batch.
   void Clear();
 
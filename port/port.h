@@ -1,12 +1,28 @@
 #pragma once
 #include<string.h>
 #include<pthread.h>
+
+#include "port/port_config.h"
+
 #if HAVE_CRC32C
 #include <crc32c/crc32c.h>
 #endif  // HAVE_CRC32C
 #if HAVE_SNAPPY
 #include <snappy.h>
 #endif  // HAVE_SNAPPY
+#if HAVE_ZSTD
+#include <zdict.h>
+#include <zstd.h>
+#endif  // HAVE_ZSTD
+#if HAVE_LZ4
+#include <lz4.h>
+#endif  // HAVE_LZ4
+#if HAVE_XXHASH
+#include <xxhash.h>
+#endif  // HAVE_XXHASH
+#if HAVE_NUMA
+#include <numa.h>
+#endif  // HAVE_NUMA
 
 #include <cassert>
 #include <condition_variable>  // NOLINT
@@ -16,18 +32,18 @@
 #include <string>
 
 #include "port/thread_annotations.h"
-//c++17 style namespace
-namespace czy_leveldb :: port{
+namespace czy_leveldb {
+namespace port {
 class CondVar;
 
 class LOCKABLE Mutex{
 public: 
     Mutex(){
         pthread_mutex_init(&mutex_,nullptr);
-    };
-    ~Mutex(
+    }
+    ~Mutex(){
         pthread_mutex_destroy(&mutex_);
-    )
+    }
     Mutex(const Mutex &) = delete;
     Mutex& operator=(const Mutex & ) = delete;
     void Lock() EXCLUSIVE_LOCK_FUNCTION() {pthread_mutex_lock(&mutex_);}
@@ -40,23 +56,27 @@ public:
 private:
     friend class CondVar;
     pthread_mutex_t mutex_;
-}
+};
 class CondVar{
 public:
-    explicit CondVar(Mutex mu):mu_(mu),{
+    explicit CondVar(Mutex* mu):mu_(mu){
         assert(mu != nullptr) ;
         pthread_cond_init(&cond_,nullptr);
     }
-    ~CondVar() = default;
+    ~CondVar(){
+        pthread_cond_destroy(&cond_);
+    }
     CondVar(const CondVar &) = delete;
     CondVar & operator= (const CondVar &) = delete;
     void Wait(){
-        pthread_cond_wait(&cond_,&mu_.get());       
+        pthread_cond_wait(&cond_,&mu_->get());
     }
+    void Signal(){ pthread_cond_signal(&cond_);}
+    void SignalAll(){ pthread_cond_broadcast(&cond_);}
 
 private:
     pthread_cond_t cond_;
-    Mutex& const mu_;
+    Mutex* const mu_;
 };
 
 inline bool Snappy_Compress(const char* input, size_t length,
@@ -90,6 +110,293 @@ inline bool Snappy_GetUncompressedLength(const char* input, size_t length,
 #endif  // HAVE_SNAPPY
 }
 
+inline bool Snappy_Uncompress(const char* input, size_t length, char* output) {
+#if HAVE_SNAPPY
+  return snappy::RawUncompress(input, length, output);
+#else
+  // Silence compiler warnings about unused arguments.
+  (void)input;
+  (void)length;
+  (void)output;
+  return false;
+#endif  // HAVE_SNAPPY
+}
+
+// A zstd dictionary digested once for compression at one level, so that
+// blocks compressed with it do not each pay for loading the raw
+// dictionary.  Returns nullptr if zstd is not available or "dict" is not
+// usable.  Free the result with Zstd_DeleteCompressionDict().
+inline void* Zstd_NewCompressionDict(int level, const char* dict,
+                                     size_t dict_length) {
+#if HAVE_ZSTD
+  return ZSTD_createCDict(dict, dict_length, level);
+#else
+  // Silence compiler warnings about unused arguments.
+  (void)level;
+  (void)dict;
+  (void)dict_length;
+  return nullptr;
+#endif  // HAVE_ZSTD
+}
+
+inline void Zstd_DeleteCompressionDict(void* cdict) {
+#if HAVE_ZSTD
+  ZSTD_freeCDict(static_cast<ZSTD_CDict*>(cdict));
+#else
+  // Silence compiler warnings about unused arguments.
+  (void)cdict;
+#endif  // HAVE_ZSTD
+}
+
+// The decompression side of Zstd_NewCompressionDict().  Free the result
+// with Zstd_DeleteDecompressionDict().
+inline void* Zstd_NewDecompressionDict(const char* dict, size_t dict_length) {
+#if HAVE_ZSTD
+  return ZSTD_createDDict(dict, dict_length);
+#else
+  // Silence compiler warnings about unused arguments.
+  (void)dict;
+  (void)dict_length;
+  return nullptr;
+#endif  // HAVE_ZSTD
+}
+
+inline void Zstd_DeleteDecompressionDict(void* ddict) {
+#if HAVE_ZSTD
+  ZSTD_freeDDict(static_cast<ZSTD_DDict*>(ddict));
+#else
+  // Silence compiler warnings about unused arguments.
+  (void)ddict;
+#endif  // HAVE_ZSTD
+}
+
+#if HAVE_ZSTD
+// Blocks are compressed and uncompressed one at a time per thread, so each
+// thread keeps one context of each kind for its lifetime instead of paying
+// for a context allocation (several hundred KB for compression) per block.
+// Returns nullptr if the context could not be allocated.
+inline ZSTD_CCtx* Zstd_ThreadCompressionContext() {
+  struct Holder {
+    ZSTD_CCtx* ctx = ZSTD_createCCtx();
+    ~Holder() { ZSTD_freeCCtx(ctx); }
+  };
+  static thread_local Holder holder;
+  return holder.ctx;
+}
+
+inline ZSTD_DCtx* Zstd_ThreadDecompressionContext() {
+  struct Holder {
+    ZSTD_DCtx* ctx = ZSTD_createDCtx();
+    ~Holder() { ZSTD_freeDCtx(ctx); }
+  };
+  static thread_local Holder holder;
+  return holder.ctx;
+}
+#endif  // HAVE_ZSTD
+
+// Compress "input" with zstd at "level", using "cdict" (from
+// Zstd_NewCompressionDict() at the same level) if it is non-null.
+// Returns false if zstd is not available.
+inline bool Zstd_Compress(int level, const void* cdict, const char* input,
+                          size_t length, std::string* output) {
+#if HAVE_ZSTD
+  size_t outlen = ZSTD_compressBound(length);
+  if (ZSTD_isError(outlen)) {
+    return false;
+  }
+  output->resize(outlen);
+  ZSTD_CCtx* ctx = Zstd_ThreadCompressionContext();
+  if (ctx == nullptr) {
+    return false;
+  }
+  if (cdict == nullptr) {
+    outlen = ZSTD_compressCCtx(ctx, &(*output)[0], output->size(), input,
+                               length, level);
+  } else {
+    outlen = ZSTD_compress_usingCDict(ctx, &(*output)[0], output->size(),
+                                      input, length,
+                                      static_cast<const ZSTD_CDict*>(cdict));
+  }
+  if (ZSTD_isError(outlen)) {
+    return false;
+  }
+  output->resize(outlen);
+  return true;
+#else
+  // Silence compiler warnings about unused arguments.
+  (void)level;
+  (void)cdict;
+  (void)input;
+  (void)length;
+  (void)output;
+  return false;
+#endif  // HAVE_ZSTD
+}
+
+// Upper bound on how many times larger than its frame zstd content can be.
+constexpr unsigned long long kZstdMaxExpansion = (128 << 10) / 4;
+
+inline bool Zstd_GetUncompressedLength(const char* input, size_t length,
+                                       size_t* result) {
+#if HAVE_ZSTD
+  unsigned long long size = ZSTD_getFrameContentSize(input, length);
+  if (size == ZSTD_CONTENTSIZE_UNKNOWN || size == ZSTD_CONTENTSIZE_ERROR) {
+    return false;
+  }
+  // The content size comes from the (possibly corrupt) frame header, and
+  // callers size their output buffer from it.  Every zstd block of at most
+  // 128KB of content costs at least 4 bytes of input, so a larger claim
+  // cannot be a frame we wrote.
+  if (size / kZstdMaxExpansion > length) {
+    return false;
+  }
+  *result = static_cast<size_t>(size);
+  return true;
+#else
+  // Silence compiler warnings about unused arguments.
+  (void)input;
+  (void)length;
+  (void)result;
+  return false;
+#endif  // HAVE_ZSTD
+}
+
+// REQUIRES: "output" has room for Zstd_GetUncompressedLength() bytes, and
+// "ddict" is the dictionary the input was compressed with, if any.
+inline bool Zstd_Uncompress(const void* ddict, const char* input,
+                            size_t length, char* output) {
+#if HAVE_ZSTD
+  size_t outlen;
+  if (!Zstd_GetUncompressedLength(input, length, &outlen)) {
+    return false;
+  }
+  ZSTD_DCtx* ctx = Zstd_ThreadDecompressionContext();
+  if (ctx == nullptr) {
+    return false;
+  }
+  if (ddict == nullptr) {
+    outlen = ZSTD_decompressDCtx(ctx, output, outlen, input, length);
+  } else {
+    outlen = ZSTD_decompress_usingDDict(ctx, output, outlen, input, length,
+                                        static_cast<const ZSTD_DDict*>(ddict));
+  }
+  return !ZSTD_isError(outlen);
+#else
+  // Silence compiler warnings about unused arguments.
+  (void)ddict;
+  (void)input;
+  (void)length;
+  (void)output;
+  return false;
+#endif  // HAVE_ZSTD
+}
+
+// Train a zstd dictionary of at most "max_dict_bytes" from the
+// concatenated "samples", whose individual sizes are in sample_sizes.
+inline bool Zstd_TrainDictionary(const std::string& samples,
+                                 const size_t* sample_sizes,
+                                 size_t num_samples, size_t max_dict_bytes,
+                                 std::string* dict) {
+#if HAVE_ZSTD
+  dict->resize(max_dict_bytes);
+  size_t dict_length = ZDICT_trainFromBuffer(
+      &(*dict)[0], max_dict_bytes, samples.data(), sample_sizes,
+      static_cast<unsigned>(num_samples));
+  if (ZDICT_isError(dict_length)) {
+    dict->clear();
+    return false;
+  }
+  dict->resize(dict_length);
+  return true;
+#else
+  // Silence compiler warnings about unused arguments.
+  (void)samples;
+  (void)sample_sizes;
+  (void)num_samples;
+  (void)max_dict_bytes;
+  (void)dict;
+  return false;
+#endif  // HAVE_ZSTD
+}
+
+// The LZ4 block format does not record the uncompressed length, so the
+// output is prefixed with it as a little-endian fixed32.
+inline bool LZ4_Compress(const char* input, size_t length,
+                         std::string* output) {
+#if HAVE_LZ4
+  if (length > static_cast<size_t>(LZ4_MAX_INPUT_SIZE)) {
+    return false;
+  }
+  const int bound = LZ4_compressBound(static_cast<int>(length));
+  output->resize(4 + bound);
+  for (int i = 0; i < 4; i++) {
+    (*output)[i] = static_cast<char>((length >> (8 * i)) & 0xff);
+  }
+  int outlen = LZ4_compress_default(input, &(*output)[4],
+                                    static_cast<int>(length), bound);
+  if (outlen <= 0) {
+    return false;
+  }
+  output->resize(4 + outlen);
+  return true;
+#else
+  // Silence compiler warnings about unused arguments.
+  (void)input;
+  (void)length;
+  (void)output;
+  return false;
+#endif  // HAVE_LZ4
+}
+
+// Upper bound on how many times larger than its input an LZ4 block can be.
+constexpr size_t kLZ4MaxExpansion = 255;
+
+inline bool LZ4_GetUncompressedLength(const char* input, size_t length,
+                                      size_t* result) {
+#if HAVE_LZ4
+  if (length < 4) {
+    return false;
+  }
+  const uint8_t* p = reinterpret_cast<const uint8_t*>(input);
+  *result = static_cast<size_t>(p[0]) | (static_cast<size_t>(p[1]) << 8) |
+            (static_cast<size_t>(p[2]) << 16) |
+            (static_cast<size_t>(p[3]) << 24);
+  // The prefix is untrusted and callers size their output buffer from it.
+  // An LZ4 block cannot expand by more than 255x, so reject anything
+  // claiming more than that.
+  if (*result / kLZ4MaxExpansion > length - 4) {
+    return false;
+  }
+  return true;
+#else
+  // Silence compiler warnings about unused arguments.
+  (void)input;
+  (void)length;
+  (void)result;
+  return false;
+#endif  // HAVE_LZ4
+}
+
+// REQUIRES: "output" has room for LZ4_GetUncompressedLength() bytes.
+inline bool LZ4_Uncompress(const char* input, size_t length, char* output) {
+#if HAVE_LZ4
+  size_t outlen;
+  if (!LZ4_GetUncompressedLength(input, length, &outlen)) {
+    return false;
+  }
+  int result = LZ4_decompress_safe(input + 4, output,
+                                   static_cast<int>(length - 4),
+                                   static_cast<int>(outlen));
+  return result >= 0 && static_cast<size_t>(result) == outlen;
+#else
+  // Silence compiler warnings about unused arguments.
+  (void)input;
+  (void)length;
+  (void)output;
+  return false;
+#endif  // HAVE_LZ4
+}
+
 inline bool GetHeapProfile(void (*func)(void*, const char*, int), void* arg) {
   // Silence compiler warnings about unused arguments.
   (void)func;
@@ -97,6 +404,44 @@ inline bool GetHeapProfile(void (*func)(void*, const char*, int), void* arg) {
   return false;
 }
 
+// Store the 64-bit XXH3 hash of input[0,length-1] in *result.  Returns
+// false if leveldb was built without xxHash.
+inline bool XXH3_64(const char* input, size_t length, uint64_t* result) {
+#if HAVE_XXHASH
+  *result = XXH3_64bits(input, length);
+  return true;
+#else
+  // Silence compiler warnings about unused arguments.
+  (void)input;
+  (void)length;
+  (void)result;
+  return false;
+#endif  // HAVE_XXHASH
+}
+
+// Bind the pages of [addr, addr+size) to the NUMA node of "cpu".  Returns
+// false if NUMA support is not available, leaving the pages to the
+// kernel's default (first-touch) placement.
+inline bool BindToNumaNodeOfCpu(void* addr, size_t size, int cpu) {
+#if HAVE_NUMA
+  if (numa_available() < 0 || cpu < 0) {
+    return false;
+  }
+  const int node = numa_node_of_cpu(cpu);
+  if (node < 0) {
+    return false;
+  }
+  numa_tonode_memory(addr, size, node);
+  return true;
+#else
+  // Silence compiler warnings about unused arguments.
+  (void)addr;
+  (void)size;
+  (void)cpu;
+  return false;
+#endif  // HAVE_NUMA
+}
+
 inline uint32_t AcceleratedCRC32C(uint32_t crc, const char* buf, size_t size) {
 #if HAVE_CRC32C
   return ::crc32c::Extend(crc, reinterpret_cast<const uint8_t*>(buf), size);
@@ -108,4 +453,6 @@ inline uint32_t AcceleratedCRC32C(uint32_t crc, const char* buf, size_t size) {
   return 0;
 #endif  // HAVE_CRC32C
 }
-}
\ No newline at end of file
+
+}  // namespace port
+}  // namespace czy_leveldb
@@ -0,0 +1,33 @@
+#include "table/block_checksum.h"
+
+#include "port/port.h"
+#include "util/crc32c.h"
+
+namespace czy_leveldb {
+
+bool ComputeBlockChecksum(ChecksumType type, const char* data, size_t n,
+                          char trailer_type, uint32_t* checksum) {
+  switch (type) {
+    case ChecksumType::kCRC32c: {
+      uint32_t crc = crc32c::Value(data, n);
+      crc = crc32c::Extend(crc, &trailer_type, 1);  // Extend to cover type
+      *checksum = crc32c::Mask(crc);
+      return true;
+    }
+    case ChecksumType::kXXH3: {
+      uint64_t h;
+      if (!port::XXH3_64(data, n, &h)) {
+        return false;
+      }
+      // Fold the type byte in without hashing it separately; the constant
+      // is an arbitrary odd number so every type byte changes the result.
+      const uint32_t kTypeMultiplier = 0x6b9083d9;
+      *checksum = static_cast<uint32_t>(h) ^
+                  (static_cast<uint8_t>(trailer_type) * kTypeMultiplier);
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace czy_leveldb
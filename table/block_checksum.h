@@ -0,0 +1,47 @@
+#pragma once
+// Every block is followed by a 5-byte trailer:
+//
+//    type:      uint8   low 7 bits: CompressionType
+//                       top bit:    set if the checksum is XXH3
+//    checksum:  fixed32 over the block contents and the type byte
+//
+// Blocks written before XXH3 support always have the top bit clear and a
+// masked crc32c checksum, so they verify unchanged.
+
+#include <cstddef>
+#include <cstdint>
+
+#include "leveldb/options.h"
+
+namespace czy_leveldb {
+
+// 1-byte type + 32-bit checksum
+static const size_t kBlockTrailerSize = 5;
+
+const uint8_t kXXH3ChecksumFlag = 0x80;
+
+inline char EncodeTrailerType(CompressionType compression,
+                              ChecksumType checksum) {
+  uint8_t type = static_cast<uint8_t>(compression);
+  if (checksum == ChecksumType::kXXH3) {
+    type |= kXXH3ChecksumFlag;
+  }
+  return static_cast<char>(type);
+}
+
+inline void DecodeTrailerType(char trailer_type, CompressionType* compression,
+                              ChecksumType* checksum) {
+  const uint8_t type = static_cast<uint8_t>(trailer_type);
+  *compression = static_cast<CompressionType>(type & ~kXXH3ChecksumFlag);
+  *checksum = (type & kXXH3ChecksumFlag) ? ChecksumType::kXXH3
+                                         : ChecksumType::kCRC32c;
+}
+
+// Compute the trailer checksum of data[0,n-1] followed by "trailer_type".
+// Returns false if "type" is not available in this build (XXH3 without
+// xxHash); writers then fall back to kCRC32c and readers report the block
+// as unverifiable.
+bool ComputeBlockChecksum(ChecksumType type, const char* data, size_t n,
+                          char trailer_type, uint32_t* checksum);
+
+}  // namespace czy_leveldb
@@ -0,0 +1,59 @@
+#include "table/block_checksum.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "util/crc32c.h"
+
+namespace czy_leveldb {
+
+TEST(BlockChecksum, TrailerTypeRoundTrip) {
+  const CompressionType compressions[] = {
+      CompressionType::kNoCompression, CompressionType::kSnappyCompression,
+      CompressionType::kZstdCompression, CompressionType::kLZ4Compression};
+  const ChecksumType checksums[] = {ChecksumType::kCRC32c,
+                                    ChecksumType::kXXH3};
+  for (CompressionType compression : compressions) {
+    for (ChecksumType checksum : checksums) {
+      CompressionType decoded_compression;
+      ChecksumType decoded_checksum;
+      DecodeTrailerType(EncodeTrailerType(compression, checksum),
+                        &decoded_compression, &decoded_checksum);
+      ASSERT_EQ(compression, decoded_compression);
+      ASSERT_EQ(checksum, decoded_checksum);
+    }
+  }
+}
+
+TEST(BlockChecksum, CRC32cMatchesLegacyTrailer) {
+  // Blocks written before XXH3 existed must verify unchanged.
+  const std::string block = "some block contents";
+  const char type =
+      EncodeTrailerType(CompressionType::kNoCompression, ChecksumType::kCRC32c);
+  uint32_t checksum;
+  ASSERT_TRUE(ComputeBlockChecksum(ChecksumType::kCRC32c, block.data(),
+                                   block.size(), type, &checksum));
+  const std::string with_type = block + type;
+  ASSERT_EQ(crc32c::Mask(crc32c::Value(with_type.data(), with_type.size())),
+            checksum);
+}
+
+TEST(BlockChecksum, TypeByteIsCovered) {
+  const std::string block = "some block contents";
+  const ChecksumType checksums[] = {ChecksumType::kCRC32c,
+                                    ChecksumType::kXXH3};
+  for (ChecksumType checksum_type : checksums) {
+    uint32_t a, b;
+    if (!ComputeBlockChecksum(checksum_type, block.data(), block.size(), 0,
+                              &a)) {
+      // XXH3 without xxHash.
+      ASSERT_EQ(ChecksumType::kXXH3, checksum_type);
+      continue;
+    }
+    ASSERT_TRUE(ComputeBlockChecksum(checksum_type, block.data(),
+                                     block.size(), 1, &b));
+    ASSERT_NE(a, b);
+  }
+}
+
+}  // namespace czy_leveldb
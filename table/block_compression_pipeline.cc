@@ -0,0 +1,107 @@
+#include "table/block_compression_pipeline.h"
+
+#include <cassert>
+
+#include "table/compression.h"
+
+namespace czy_leveldb {
+
+BlockCompressionPipeline::BlockCompressionPipeline(int num_workers,
+                                                   CompressionType type,
+                                                   int zstd_level)
+    : type_(type),
+      zstd_level_(zstd_level),
+      max_outstanding_(2 * static_cast<size_t>(num_workers)),
+      work_cv_(&mu_),
+      done_cv_(&mu_),
+      shutting_down_(false) {
+  assert(num_workers > 0);
+  for (int i = 0; i < num_workers; i++) {
+    workers_.emplace_back(&BlockCompressionPipeline::WorkerMain, this);
+  }
+}
+
+BlockCompressionPipeline::~BlockCompressionPipeline() {
+  mu_.Lock();
+  shutting_down_ = true;
+  work_cv_.SignalAll();
+  mu_.UnLock();
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+  for (PipelinedBlock* block : in_order_) {
+    delete block;
+  }
+}
+
+void BlockCompressionPipeline::SetDictionary(const Slice& dict) {
+  mu_.Lock();
+  assert(in_order_.empty());
+  dict_.reset(new CompressionDict(dict, zstd_level_));
+  mu_.UnLock();
+}
+
+void BlockCompressionPipeline::Submit(PipelinedBlock* block) {
+  mu_.Lock();
+  block->done = false;
+  in_order_.push_back(block);
+  queue_.push_back(block);
+  work_cv_.Signal();
+  mu_.UnLock();
+}
+
+PipelinedBlock* BlockCompressionPipeline::Next(bool wait) {
+  PipelinedBlock* block = nullptr;
+  mu_.Lock();
+  if (wait || in_order_.size() > max_outstanding_) {
+    while (!in_order_.empty() && !in_order_.front()->done) {
+      done_cv_.Wait();
+    }
+  }
+  if (!in_order_.empty() && in_order_.front()->done) {
+    block = in_order_.front();
+    in_order_.pop_front();
+  }
+  mu_.UnLock();
+  return block;
+}
+
+size_t BlockCompressionPipeline::outstanding() const {
+  mu_.Lock();
+  const size_t result = in_order_.size();
+  mu_.UnLock();
+  return result;
+}
+
+void BlockCompressionPipeline::WorkerMain() {
+  mu_.Lock();
+  while (true) {
+    while (!shutting_down_ && queue_.empty()) {
+      work_cv_.Wait();
+    }
+    if (shutting_down_) {
+      break;
+    }
+    PipelinedBlock* block = queue_.front();
+    queue_.pop_front();
+    // dict_ only changes while nothing is outstanding, so it can be read
+    // without the lock for the duration of this block.
+    const CompressionDict* dict = dict_.get();
+    mu_.UnLock();
+
+    if (CompressBlock(type_, zstd_level_, dict, block->raw,
+                      &block->compressed)) {
+      block->type = type_;
+    } else {
+      block->type = CompressionType::kNoCompression;
+      block->compressed.clear();
+    }
+
+    mu_.Lock();
+    block->done = true;
+    done_cv_.SignalAll();
+  }
+  mu_.UnLock();
+}
+
+}  // namespace czy_leveldb
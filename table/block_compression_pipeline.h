@@ -0,0 +1,98 @@
+#pragma once
+// Compresses finished data blocks on a pool of worker threads while the
+// table builder keeps adding keys, and hands them back in the order they
+// were submitted so the builder can write them, and assign file offsets
+// and index entries, exactly as the single-threaded path would.
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "leveldb/options.h"
+#include "leveldb/slice.h"
+#include "port/port.h"
+#include "port/thread_annotations.h"
+
+namespace czy_leveldb {
+
+class CompressionDict;
+
+struct PipelinedBlock {
+  // Filled in by the builder before Submit().
+  std::string raw;
+  // Index key for this block (already shortened with
+  // FindShortestSeparator against the first key of the next block).
+  std::string index_key;
+  // Keys to hand to the filter block once this block's offset is known.
+  // The filter block is keyed by file offset, so keys must not be added to
+  // it until every earlier block has been written.
+  std::vector<std::string> filter_keys;
+
+  // Filled in by the workers.  If compression failed or did not pay off,
+  // "type" is kNoCompression and "raw" should be written instead.
+  std::string compressed;
+  CompressionType type = CompressionType::kNoCompression;
+  bool done = false;
+
+  Slice contents() const {
+    return type == CompressionType::kNoCompression ? Slice(raw)
+                                                   : Slice(compressed);
+  }
+};
+
+class BlockCompressionPipeline {
+ public:
+  // Start "num_workers" threads compressing with "type".
+  BlockCompressionPipeline(int num_workers, CompressionType type,
+                           int zstd_level);
+
+  BlockCompressionPipeline(const BlockCompressionPipeline&) = delete;
+  BlockCompressionPipeline& operator=(const BlockCompressionPipeline&) =
+      delete;
+
+  // Stops the workers and deletes any blocks not yet returned by Next().
+  ~BlockCompressionPipeline();
+
+  // Set the dictionary used for kZstdCompression.  It is digested here,
+  // once, and shared by every worker.
+  // REQUIRES: no blocks are outstanding.
+  void SetDictionary(const Slice& dict);
+
+  // Hand a raw block to the workers.  Takes ownership of "block".
+  void Submit(PipelinedBlock* block);
+
+  // Return the oldest outstanding block if it has been compressed, else
+  // nullptr.  If "wait" is true, or more than 2 * num_workers blocks are
+  // outstanding, waits for it instead, returning nullptr only when nothing
+  // is outstanding.  The caller owns the result.
+  //
+  // The builder calls Next(false) in a loop after every Submit() so that
+  // buffered raw blocks stay bounded, and Next(true) from Finish().
+  PipelinedBlock* Next(bool wait);
+
+  // Number of blocks submitted but not yet returned by Next().
+  size_t outstanding() const;
+
+ private:
+  void WorkerMain();
+
+  const CompressionType type_;
+  const int zstd_level_;
+  const size_t max_outstanding_;
+  std::unique_ptr<const CompressionDict> dict_;
+
+  mutable port::Mutex mu_;
+  port::CondVar work_cv_ GUARDED_BY(mu_);
+  port::CondVar done_cv_ GUARDED_BY(mu_);
+  bool shutting_down_ GUARDED_BY(mu_);
+  // Every outstanding block in submission order.
+  std::deque<PipelinedBlock*> in_order_ GUARDED_BY(mu_);
+  // Blocks not yet picked up by a worker.
+  std::deque<PipelinedBlock*> queue_ GUARDED_BY(mu_);
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace czy_leveldb
@@ -0,0 +1,118 @@
+#include "table/block_compression_pipeline.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "table/compression.h"
+
+namespace czy_leveldb {
+
+namespace {
+
+PipelinedBlock* NewBlock(int i) {
+  PipelinedBlock* block = new PipelinedBlock;
+  block->raw = "block" + std::to_string(i);
+  block->raw.append(1000, static_cast<char>('a' + i % 26));
+  block->index_key = "k" + std::to_string(i);
+  return block;
+}
+
+// The first codec compiled into this build, or kNoCompression if none is.
+CompressionType AvailableCompression() {
+  const CompressionType types[] = {CompressionType::kSnappyCompression,
+                                   CompressionType::kZstdCompression,
+                                   CompressionType::kLZ4Compression};
+  std::unique_ptr<PipelinedBlock> probe(NewBlock(0));
+  for (CompressionType type : types) {
+    std::string output;
+    if (CompressBlock(type, 3, nullptr, probe->raw, &output)) {
+      return type;
+    }
+  }
+  return CompressionType::kNoCompression;
+}
+
+}  // namespace
+
+TEST(BlockCompressionPipeline, ReturnsBlocksInSubmissionOrder) {
+  // Ordering does not depend on the codec; with none compiled in the
+  // workers still hand every block back, uncompressed.
+  BlockCompressionPipeline pipeline(4, AvailableCompression(), 3);
+  const int kBlocks = 200;
+  std::vector<std::string> returned;
+  for (int i = 0; i < kBlocks; i++) {
+    pipeline.Submit(NewBlock(i));
+    while (PipelinedBlock* block = pipeline.Next(false)) {
+      returned.push_back(block->index_key);
+      delete block;
+    }
+    // Next(false) waits once too many blocks are buffered.
+    ASSERT_LE(pipeline.outstanding(), 2u * 4 + 1);
+  }
+  while (PipelinedBlock* block = pipeline.Next(true)) {
+    returned.push_back(block->index_key);
+    delete block;
+  }
+  ASSERT_EQ(0u, pipeline.outstanding());
+  ASSERT_EQ(static_cast<size_t>(kBlocks), returned.size());
+  for (int i = 0; i < kBlocks; i++) {
+    ASSERT_EQ("k" + std::to_string(i), returned[i]);
+  }
+}
+
+TEST(BlockCompressionPipeline, CompressesBlocks) {
+  const CompressionType type = AvailableCompression();
+  if (type == CompressionType::kNoCompression) {
+    GTEST_SKIP() << "no compression library compiled in";
+  }
+  BlockCompressionPipeline pipeline(3, type, 3);
+  const int kBlocks = 20;
+  for (int i = 0; i < kBlocks; i++) {
+    pipeline.Submit(NewBlock(i));
+  }
+  int blocks = 0;
+  while (PipelinedBlock* block = pipeline.Next(true)) {
+    std::unique_ptr<PipelinedBlock> owned(block);
+    ASSERT_EQ(type, block->type);
+    ASSERT_LT(block->contents().size(), block->raw.size());
+    std::string uncompressed;
+    ASSERT_TRUE(
+        UncompressBlock(type, nullptr, block->contents(), &uncompressed).ok());
+    ASSERT_EQ(block->raw, uncompressed);
+    blocks++;
+  }
+  ASSERT_EQ(kBlocks, blocks);
+}
+
+TEST(BlockCompressionPipeline, ContentsFallBackToRaw) {
+  BlockCompressionPipeline pipeline(2, CompressionType::kNoCompression, 3);
+  pipeline.Submit(NewBlock(7));
+  PipelinedBlock* block = pipeline.Next(true);
+  ASSERT_TRUE(block != nullptr);
+  ASSERT_EQ(CompressionType::kNoCompression, block->type);
+  ASSERT_EQ(block->raw, block->contents().ToString());
+  delete block;
+  ASSERT_EQ(nullptr, pipeline.Next(true));
+}
+
+TEST(BlockCompressionPipeline, DictionaryBetweenBatches) {
+  BlockCompressionPipeline pipeline(2, CompressionType::kZstdCompression, 3);
+  pipeline.SetDictionary("some dictionary bytes");
+  pipeline.Submit(NewBlock(1));
+  PipelinedBlock* block = pipeline.Next(true);
+  ASSERT_TRUE(block != nullptr);
+  ASSERT_TRUE(block->done);
+  delete block;
+  pipeline.SetDictionary(Slice(""));
+}
+
+TEST(BlockCompressionPipeline, DestructorDropsOutstandingBlocks) {
+  BlockCompressionPipeline pipeline(3, AvailableCompression(), 3);
+  for (int i = 0; i < 5; i++) {
+    pipeline.Submit(NewBlock(i));
+  }
+}
+
+}  // namespace czy_leveldb
@@ -0,0 +1,151 @@
+#include "table/bounded_iterator.h"
+
+#include <string>
+
+#include "db/dbformat.h"
+
+namespace czy_leveldb {
+
+bool KeyRangeOverlapsBounds(const ReadOptions& options,
+                            const Comparator* user_comparator,
+                            const Slice& smallest, const Slice& largest) {
+  if (options.iterate_lower_bound != nullptr &&
+      user_comparator->Compare(largest, *options.iterate_lower_bound) < 0) {
+    return false;
+  }
+  if (options.iterate_upper_bound != nullptr &&
+      user_comparator->Compare(smallest, *options.iterate_upper_bound) >= 0) {
+    return false;
+  }
+  return true;
+}
+
+namespace {
+
+class BoundedIterator : public Iterator {
+ public:
+  BoundedIterator(Iterator* base, const Slice* lower, const Slice* upper,
+                  const Comparator* user_comparator, bool internal_keys)
+      : base_(base),
+        lower_(lower),
+        upper_(upper),
+        cmp_(user_comparator),
+        internal_keys_(internal_keys),
+        valid_(false) {}
+
+  ~BoundedIterator() override { delete base_; }
+
+  bool Valid() const override { return valid_; }
+
+  void SeekToFirst() override {
+    if (lower_ != nullptr) {
+      SeekToUserKey(*lower_);
+    } else {
+      base_->SeekToFirst();
+    }
+    CheckBounds();
+  }
+
+  void SeekToLast() override {
+    if (upper_ != nullptr) {
+      // Position at the first entry at or past the bound, then step back
+      // to the last entry before it.
+      SeekToUserKey(*upper_);
+      if (base_->Valid()) {
+        base_->Prev();
+      } else {
+        base_->SeekToLast();
+      }
+    } else {
+      base_->SeekToLast();
+    }
+    CheckBounds();
+  }
+
+  void Seek(const Slice& target) override {
+    if (lower_ != nullptr && cmp_->Compare(UserKey(target), *lower_) < 0) {
+      SeekToUserKey(*lower_);
+    } else {
+      base_->Seek(target);
+    }
+    CheckBounds();
+  }
+
+  void Next() override {
+    assert(valid_);
+    base_->Next();
+    CheckBounds();
+  }
+
+  void Prev() override {
+    assert(valid_);
+    base_->Prev();
+    CheckBounds();
+  }
+
+  Slice key() const override {
+    assert(valid_);
+    return base_->key();
+  }
+
+  Slice value() const override {
+    assert(valid_);
+    return base_->value();
+  }
+
+  Status status() const override { return base_->status(); }
+
+ private:
+  Slice UserKey(const Slice& key) const {
+    return internal_keys_ ? ExtractUserKey(key) : key;
+  }
+
+  // Seek "base_" to the first entry whose user key is >= "user_key".
+  void SeekToUserKey(const Slice& user_key) {
+    if (internal_keys_) {
+      seek_key_.clear();
+      AppendInternalKey(&seek_key_, ParsedInternalKey(user_key,
+                                                      kMaxSequenceNumber,
+                                                      kValueTypeForSeek));
+      base_->Seek(seek_key_);
+    } else {
+      base_->Seek(user_key);
+    }
+  }
+
+  void CheckBounds() {
+    valid_ = base_->Valid();
+    if (!valid_) {
+      return;
+    }
+    const Slice user_key = UserKey(base_->key());
+    if ((upper_ != nullptr && cmp_->Compare(user_key, *upper_) >= 0) ||
+        (lower_ != nullptr && cmp_->Compare(user_key, *lower_) < 0)) {
+      valid_ = false;
+    }
+  }
+
+  Iterator* const base_;
+  const Slice* const lower_;
+  const Slice* const upper_;
+  const Comparator* const cmp_;
+  const bool internal_keys_;
+  bool valid_;
+  std::string seek_key_;
+};
+
+}  // namespace
+
+Iterator* NewBoundedIterator(Iterator* base, const ReadOptions& options,
+                             const Comparator* user_comparator,
+                             bool internal_keys) {
+  if (options.iterate_lower_bound == nullptr &&
+      options.iterate_upper_bound == nullptr) {
+    return base;
+  }
+  return new BoundedIterator(base, options.iterate_lower_bound,
+                             options.iterate_upper_bound, user_comparator,
+                             internal_keys);
+}
+
+}  // namespace czy_leveldb
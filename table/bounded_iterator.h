@@ -0,0 +1,30 @@
+#pragma once
+// Enforcement of ReadOptions::iterate_lower_bound / iterate_upper_bound.
+// The merging iterator wraps its result with NewBoundedIterator(), and the
+// level iterators use KeyRangeOverlapsBounds() to skip whole tables (by
+// their smallest/largest keys) and blocks (by their index keys) that lie
+// outside the bounds without opening them.
+
+#include "leveldb/comparator.h"
+#include "leveldb/iterator.h"
+#include "leveldb/options.h"
+#include "leveldb/slice.h"
+
+namespace czy_leveldb {
+
+// Return true if some user key in [smallest, largest] lies within the
+// bounds of "options".  Bounds that are not set never exclude anything.
+bool KeyRangeOverlapsBounds(const ReadOptions& options,
+                            const Comparator* user_comparator,
+                            const Slice& smallest, const Slice& largest);
+
+// Return an iterator over the entries of "base" whose user keys lie
+// within the bounds of "options".  If "internal_keys" is true, "base"
+// yields internal keys (db/dbformat.h) and the bounds are compared with
+// their user key portion.  Returns "base" itself if no bound is set;
+// otherwise the result owns "base".
+Iterator* NewBoundedIterator(Iterator* base, const ReadOptions& options,
+                             const Comparator* user_comparator,
+                             bool internal_keys);
+
+}  // namespace czy_leveldb
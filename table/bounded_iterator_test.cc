@@ -0,0 +1,148 @@
+#include "table/bounded_iterator.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "db/dbformat.h"
+#include "gtest/gtest.h"
+
+namespace czy_leveldb {
+
+namespace {
+
+// Iterates over keys already sorted by "cmp".
+class VectorIterator : public Iterator {
+ public:
+  VectorIterator(std::vector<std::string> keys, const Comparator* cmp)
+      : keys_(std::move(keys)), cmp_(cmp), pos_(keys_.size()) {}
+
+  bool Valid() const override { return pos_ < keys_.size(); }
+  void SeekToFirst() override { pos_ = 0; }
+  void SeekToLast() override {
+    pos_ = keys_.empty() ? keys_.size() : keys_.size() - 1;
+  }
+  void Seek(const Slice& target) override {
+    const Comparator* cmp = cmp_;
+    pos_ = std::lower_bound(keys_.begin(), keys_.end(), target,
+                            [cmp](const std::string& k, const Slice& t) {
+                              return cmp->Compare(k, t) < 0;
+                            }) -
+           keys_.begin();
+  }
+  void Next() override { pos_++; }
+  void Prev() override { pos_ = (pos_ == 0) ? keys_.size() : pos_ - 1; }
+  Slice key() const override { return keys_[pos_]; }
+  Slice value() const override { return Slice(); }
+  Status status() const override { return Status::OK(); }
+
+ private:
+  const std::vector<std::string> keys_;
+  const Comparator* const cmp_;
+  size_t pos_;
+};
+
+std::string IKey(const std::string& user_key, uint64_t seq) {
+  std::string encoded;
+  AppendInternalKey(&encoded, ParsedInternalKey(user_key, seq, kTypeValue));
+  return encoded;
+}
+
+std::vector<std::string> Forward(Iterator* iter, bool internal_keys) {
+  std::vector<std::string> keys;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    keys.push_back(internal_keys ? ExtractUserKey(iter->key()).ToString()
+                                 : iter->key().ToString());
+  }
+  return keys;
+}
+
+std::vector<std::string> Backward(Iterator* iter, bool internal_keys) {
+  std::vector<std::string> keys;
+  for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+    keys.push_back(internal_keys ? ExtractUserKey(iter->key()).ToString()
+                                 : iter->key().ToString());
+  }
+  return keys;
+}
+
+typedef std::vector<std::string> Keys;
+
+}  // namespace
+
+TEST(BoundedIterator, NoBoundsReturnsBase) {
+  Iterator* base = new VectorIterator({"a", "b"}, BytewiseComparator());
+  ReadOptions options;
+  Iterator* iter = NewBoundedIterator(base, options, BytewiseComparator(),
+                                      false);
+  ASSERT_EQ(base, iter);
+  delete iter;
+}
+
+TEST(BoundedIterator, UserKeys) {
+  const Slice lower("b"), upper("d");
+  ReadOptions options;
+  options.iterate_lower_bound = &lower;
+  options.iterate_upper_bound = &upper;
+  std::unique_ptr<Iterator> iter(NewBoundedIterator(
+      new VectorIterator({"a", "b", "c", "d", "e"}, BytewiseComparator()),
+      options, BytewiseComparator(), false));
+  ASSERT_EQ(Keys({"b", "c"}), Forward(iter.get(), false));
+  ASSERT_EQ(Keys({"c", "b"}), Backward(iter.get(), false));
+
+  // Seeks below the lower bound start at it; at or past the upper bound
+  // the iterator is invalid.
+  iter->Seek("a");
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ("b", iter->key().ToString());
+  iter->Seek("d");
+  ASSERT_FALSE(iter->Valid());
+}
+
+TEST(BoundedIterator, UpperBoundPastEnd) {
+  const Slice upper("z");
+  ReadOptions options;
+  options.iterate_upper_bound = &upper;
+  std::unique_ptr<Iterator> iter(NewBoundedIterator(
+      new VectorIterator({"a", "b"}, BytewiseComparator()), options,
+      BytewiseComparator(), false));
+  iter->SeekToLast();
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ("b", iter->key().ToString());
+}
+
+TEST(BoundedIterator, InternalKeysCompareUserKeyOnly) {
+  InternalKeyComparator icmp(BytewiseComparator());
+  // Bounds are user keys, so every version of "b" is in range.
+  const Keys ikeys = {IKey("a", 9), IKey("b", 7), IKey("b", 3), IKey("c", 5),
+                      IKey("d", 1)};
+  const Slice lower("b"), upper("d");
+  ReadOptions options;
+  options.iterate_lower_bound = &lower;
+  options.iterate_upper_bound = &upper;
+  std::unique_ptr<Iterator> iter(NewBoundedIterator(
+      new VectorIterator(ikeys, &icmp), options, BytewiseComparator(), true));
+  ASSERT_EQ(Keys({"b", "b", "c"}), Forward(iter.get(), true));
+  ASSERT_EQ(Keys({"c", "b", "b"}), Backward(iter.get(), true));
+  iter->Seek(IKey("a", 100));
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(IKey("b", 7), iter->key().ToString());
+}
+
+TEST(BoundedIterator, KeyRangeOverlapsBounds) {
+  const Comparator* cmp = BytewiseComparator();
+  const Slice lower("f"), upper("m");
+  ReadOptions options;
+  ASSERT_TRUE(KeyRangeOverlapsBounds(options, cmp, "a", "c"));
+  options.iterate_lower_bound = &lower;
+  options.iterate_upper_bound = &upper;
+  ASSERT_FALSE(KeyRangeOverlapsBounds(options, cmp, "a", "e"));
+  ASSERT_TRUE(KeyRangeOverlapsBounds(options, cmp, "a", "f"));
+  ASSERT_TRUE(KeyRangeOverlapsBounds(options, cmp, "l", "z"));
+  // The upper bound is exclusive.
+  ASSERT_FALSE(KeyRangeOverlapsBounds(options, cmp, "m", "z"));
+  ASSERT_TRUE(KeyRangeOverlapsBounds(options, cmp, "a", "z"));
+}
+
+}  // namespace czy_leveldb
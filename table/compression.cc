@@ -0,0 +1,162 @@
+#include "table/compression.h"
+
+#include "port/port.h"
+
+namespace czy_leveldb {
+
+const char kCompressionDictBlockName[] = "leveldb.compression_dict";
+
+namespace {
+
+// zstd refuses to train from fewer samples than this.
+const size_t kMinDictSamples = 8;
+
+}  // namespace
+
+CompressionDict::CompressionDict(const Slice& dict, int zstd_level)
+    : raw_(dict.data(), dict.size()),
+      zstd_cdict_(raw_.empty() ? nullptr
+                               : port::Zstd_NewCompressionDict(
+                                     zstd_level, raw_.data(), raw_.size())) {}
+
+CompressionDict::~CompressionDict() {
+  if (zstd_cdict_ != nullptr) {
+    port::Zstd_DeleteCompressionDict(zstd_cdict_);
+  }
+}
+
+UncompressionDict::UncompressionDict(const Slice& dict)
+    : raw_(dict.data(), dict.size()),
+      zstd_ddict_(raw_.empty() ? nullptr
+                               : port::Zstd_NewDecompressionDict(
+                                     raw_.data(), raw_.size())) {}
+
+UncompressionDict::~UncompressionDict() {
+  if (zstd_ddict_ != nullptr) {
+    port::Zstd_DeleteDecompressionDict(zstd_ddict_);
+  }
+}
+
+bool CompressBlock(CompressionType type, int zstd_level,
+                   const CompressionDict* dict, const Slice& raw,
+                   std::string* output) {
+  bool ok = false;
+  switch (type) {
+    case CompressionType::kNoCompression:
+      return false;
+    case CompressionType::kSnappyCompression:
+      ok = port::Snappy_Compress(raw.data(), raw.size(), output);
+      break;
+    case CompressionType::kZstdCompression:
+      ok = port::Zstd_Compress(
+          zstd_level, dict != nullptr ? dict->zstd_cdict() : nullptr,
+          raw.data(), raw.size(), output);
+      break;
+    case CompressionType::kLZ4Compression:
+      ok = port::LZ4_Compress(raw.data(), raw.size(), output);
+      break;
+  }
+  // Store uncompressed unless we save at least 12.5%.
+  return ok && output->size() < raw.size() - (raw.size() / 8u);
+}
+
+Status UncompressBlock(CompressionType type, const UncompressionDict* dict,
+                       const Slice& input, std::string* output) {
+  size_t ulength = 0;
+  bool ok = false;
+  switch (type) {
+    case CompressionType::kNoCompression:
+      output->assign(input.data(), input.size());
+      return Status::OK();
+    case CompressionType::kSnappyCompression:
+      if (!port::Snappy_GetUncompressedLength(input.data(), input.size(),
+                                              &ulength)) {
+        return Status::Corruption("corrupted snappy compressed block length");
+      }
+      output->resize(ulength);
+      ok = port::Snappy_Uncompress(input.data(), input.size(), &(*output)[0]);
+      break;
+    case CompressionType::kZstdCompression:
+      if (!port::Zstd_GetUncompressedLength(input.data(), input.size(),
+                                            &ulength)) {
+        return Status::Corruption("corrupted zstd compressed block length");
+      }
+      output->resize(ulength);
+      ok = port::Zstd_Uncompress(
+          dict != nullptr ? dict->zstd_ddict() : nullptr, input.data(),
+          input.size(), &(*output)[0]);
+      break;
+    case CompressionType::kLZ4Compression:
+      if (!port::LZ4_GetUncompressedLength(input.data(), input.size(),
+                                           &ulength)) {
+        return Status::Corruption("corrupted lz4 compressed block length");
+      }
+      output->resize(ulength);
+      ok = port::LZ4_Uncompress(input.data(), input.size(), &(*output)[0]);
+      break;
+    default:
+      return Status::Corruption("bad block type");
+  }
+  if (!ok) {
+    output->clear();
+    return Status::Corruption("corrupted compressed block contents");
+  }
+  return Status::OK();
+}
+
+CompressionDictBuilder::CompressionDictBuilder(size_t max_dict_bytes,
+                                               size_t max_train_bytes)
+    : max_dict_bytes_(max_dict_bytes),
+      max_train_bytes_(max_train_bytes != 0 ? max_train_bytes
+                                            : 100 * max_dict_bytes),
+      sampled_bytes_(0),
+      blocks_seen_(0),
+      seed_(0x2545f491) {}
+
+uint32_t CompressionDictBuilder::NextRandom() {
+  // xorshift32; sampling only needs to be cheap, not strong.
+  seed_ ^= seed_ << 13;
+  seed_ ^= seed_ >> 17;
+  seed_ ^= seed_ << 5;
+  return seed_;
+}
+
+void CompressionDictBuilder::AddBlock(const Slice& raw_block) {
+  blocks_seen_++;
+  if (sampled_bytes_ + raw_block.size() <= max_train_bytes_) {
+    samples_.push_back(raw_block.ToString());
+    sampled_bytes_ += raw_block.size();
+    return;
+  }
+  if (samples_.empty()) {
+    return;
+  }
+  const uint64_t slot = NextRandom() % blocks_seen_;
+  if (slot < samples_.size()) {
+    std::string& victim = samples_[slot];
+    if (sampled_bytes_ - victim.size() + raw_block.size() <=
+        max_train_bytes_) {
+      sampled_bytes_ = sampled_bytes_ - victim.size() + raw_block.size();
+      victim.assign(raw_block.data(), raw_block.size());
+    }
+  }
+}
+
+void CompressionDictBuilder::Finish(std::string* dict) {
+  dict->clear();
+  if (max_dict_bytes_ == 0 || samples_.size() < kMinDictSamples) {
+    return;
+  }
+  std::string concatenated;
+  concatenated.reserve(sampled_bytes_);
+  std::vector<size_t> sample_sizes;
+  sample_sizes.reserve(samples_.size());
+  for (const std::string& sample : samples_) {
+    concatenated.append(sample);
+    sample_sizes.push_back(sample.size());
+  }
+  port::Zstd_TrainDictionary(concatenated, sample_sizes.data(),
+                             sample_sizes.size(), max_dict_bytes_, dict);
+}
+
+}  // namespace czy_leveldb
@@ -0,0 +1,101 @@
+#pragma once
+// Block compression shared by TableBuilder (writing) and the block reader.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "leveldb/options.h"
+#include "leveldb/slice.h"
+#include "leveldb/status.h"
+
+namespace czy_leveldb {
+
+// Name of the meta block holding a table's zstd dictionary, if any.
+extern const char kCompressionDictBlockName[];
+
+// A table's zstd dictionary, digested once when the table builder learns
+// it so that each block compressed with it does not reload the raw bytes.
+class CompressionDict {
+ public:
+  // "dict" may be empty, in which case blocks are compressed without one.
+  CompressionDict(const Slice& dict, int zstd_level);
+  ~CompressionDict();
+
+  CompressionDict(const CompressionDict&) = delete;
+  CompressionDict& operator=(const CompressionDict&) = delete;
+
+  // The raw dictionary, as stored in the kCompressionDictBlockName block.
+  Slice raw() const { return Slice(raw_); }
+
+  // The digested dictionary, or nullptr if there is none (or no zstd).
+  const void* zstd_cdict() const { return zstd_cdict_; }
+
+ private:
+  const std::string raw_;
+  void* zstd_cdict_;
+};
+
+// The reader side of CompressionDict.  An open table digests its
+// dictionary block once and keeps the result alongside its other meta
+// blocks for as long as the table stays open.
+class UncompressionDict {
+ public:
+  explicit UncompressionDict(const Slice& dict);
+  ~UncompressionDict();
+
+  UncompressionDict(const UncompressionDict&) = delete;
+  UncompressionDict& operator=(const UncompressionDict&) = delete;
+
+  const void* zstd_ddict() const { return zstd_ddict_; }
+
+ private:
+  const std::string raw_;
+  void* zstd_ddict_;
+};
+
+// Compress "raw" with "type" into *output.  "dict" is the table's zstd
+// dictionary and may be null.  Returns false, leaving the block to be
+// stored as kNoCompression, if the codec is not compiled in or the result
+// is not at least 12.5% smaller than the input.
+bool CompressBlock(CompressionType type, int zstd_level,
+                   const CompressionDict* dict, const Slice& raw,
+                   std::string* output);
+
+// Uncompress the "type"-compressed block "input" into *output.  "dict"
+// must be the dictionary the block was compressed with, or null.
+Status UncompressBlock(CompressionType type, const UncompressionDict* dict,
+                       const Slice& input, std::string* output);
+
+// Collects a sample of a table's raw data blocks and trains the zstd
+// dictionary from them once the table is finished.
+class CompressionDictBuilder {
+ public:
+  // "max_train_bytes" of zero means 100 * max_dict_bytes.
+  CompressionDictBuilder(size_t max_dict_bytes, size_t max_train_bytes);
+
+  CompressionDictBuilder(const CompressionDictBuilder&) = delete;
+  CompressionDictBuilder& operator=(const CompressionDictBuilder&) = delete;
+
+  // Offer a raw data block for sampling.  Blocks are kept until the
+  // training budget is full, after which new blocks replace kept ones
+  // with reservoir sampling so the sample spans the whole table.
+  void AddBlock(const Slice& raw_block);
+
+  // Train the dictionary into *dict.  Leaves *dict empty if there is too
+  // little data or zstd is not available; blocks are then compressed
+  // without a dictionary.
+  void Finish(std::string* dict);
+
+ private:
+  uint32_t NextRandom();
+
+  const size_t max_dict_bytes_;
+  const size_t max_train_bytes_;
+  size_t sampled_bytes_;
+  uint64_t blocks_seen_;
+  uint32_t seed_;
+  std::vector<std::string> samples_;
+};
+
+}  // namespace czy_leveldb
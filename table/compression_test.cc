@@ -0,0 +1,147 @@
+#include "table/compression.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace czy_leveldb {
+
+namespace {
+
+// A block that compresses well: a few short records, repeated.
+std::string CompressibleBlock(int seed) {
+  std::string block;
+  for (int i = 0; i < 200; i++) {
+    block.append("key");
+    block.append(std::to_string((seed + i) % 17));
+    block.append("value-value-value;");
+  }
+  return block;
+}
+
+}  // namespace
+
+TEST(Compression, NoCompressionIsNeverChosen) {
+  std::string output;
+  ASSERT_FALSE(CompressBlock(CompressionType::kNoCompression, 3, nullptr,
+                             CompressibleBlock(0), &output));
+}
+
+TEST(Compression, RoundTrip) {
+  const CompressionType types[] = {CompressionType::kSnappyCompression,
+                                   CompressionType::kZstdCompression,
+                                   CompressionType::kLZ4Compression};
+  const std::string raw = CompressibleBlock(0);
+  for (CompressionType type : types) {
+    std::string compressed;
+    if (!CompressBlock(type, 3, nullptr, raw, &compressed)) {
+      // Codec not compiled in.
+      continue;
+    }
+    ASSERT_LT(compressed.size(), raw.size());
+    std::string uncompressed;
+    ASSERT_TRUE(UncompressBlock(type, nullptr, compressed, &uncompressed).ok());
+    ASSERT_EQ(raw, uncompressed);
+  }
+}
+
+TEST(Compression, RoundTripWithDictionary) {
+  CompressionDictBuilder dict_builder(4096, 0);
+  for (int i = 0; i < 64; i++) {
+    dict_builder.AddBlock(CompressibleBlock(i));
+  }
+  std::string raw_dict;
+  dict_builder.Finish(&raw_dict);
+
+  CompressionDict dict(raw_dict, 3);
+  UncompressionDict udict(raw_dict);
+  ASSERT_EQ(raw_dict, dict.raw().ToString());
+  if (raw_dict.empty()) {
+    // zstd not compiled in: nothing is digested and blocks are compressed
+    // without a dictionary.
+    ASSERT_EQ(nullptr, dict.zstd_cdict());
+    ASSERT_EQ(nullptr, udict.zstd_ddict());
+  }
+
+  // The same digested dictionaries serve every block of the table.
+  for (int i = 0; i < 8; i++) {
+    const std::string raw = CompressibleBlock(100 + i);
+    std::string compressed;
+    if (!CompressBlock(CompressionType::kZstdCompression, 3, &dict, raw,
+                       &compressed)) {
+      continue;
+    }
+    std::string uncompressed;
+    ASSERT_TRUE(UncompressBlock(CompressionType::kZstdCompression, &udict,
+                                compressed, &uncompressed)
+                    .ok());
+    ASSERT_EQ(raw, uncompressed);
+  }
+}
+
+TEST(Compression, EmptyDictionary) {
+  CompressionDict dict(Slice(""), 3);
+  UncompressionDict udict(Slice(""));
+  ASSERT_EQ(nullptr, dict.zstd_cdict());
+  ASSERT_EQ(nullptr, udict.zstd_ddict());
+  ASSERT_TRUE(dict.raw().empty());
+}
+
+TEST(Compression, DictBuilderNeedsSamples) {
+  CompressionDictBuilder dict_builder(4096, 0);
+  dict_builder.AddBlock(CompressibleBlock(0));
+  std::string dict = "stale";
+  dict_builder.Finish(&dict);
+  ASSERT_TRUE(dict.empty());
+}
+
+TEST(Compression, CorruptInput) {
+  const CompressionType types[] = {CompressionType::kSnappyCompression,
+                                   CompressionType::kZstdCompression,
+                                   CompressionType::kLZ4Compression};
+  for (CompressionType type : types) {
+    std::string output;
+    ASSERT_FALSE(UncompressBlock(type, nullptr, "\xff\xff\xff\xff\xff junk",
+                                 &output)
+                     .ok());
+  }
+}
+
+TEST(Compression, RejectsOversizedLZ4Length) {
+  const std::string raw = CompressibleBlock(0);
+  std::string compressed;
+  if (!CompressBlock(CompressionType::kLZ4Compression, 3, nullptr, raw,
+                     &compressed)) {
+    GTEST_SKIP() << "LZ4 not compiled in";
+  }
+  // Claim a 4GB-1 block in the length prefix.
+  for (int i = 0; i < 4; i++) {
+    compressed[i] = '\xff';
+  }
+  std::string output;
+  ASSERT_TRUE(UncompressBlock(CompressionType::kLZ4Compression, nullptr,
+                              compressed, &output)
+                  .IsCorruption());
+  ASSERT_TRUE(output.empty());
+}
+
+TEST(Compression, RejectsOversizedZstdLength) {
+  std::string compressed;
+  if (!CompressBlock(CompressionType::kZstdCompression, 3, nullptr,
+                     CompressibleBlock(0), &compressed)) {
+    GTEST_SKIP() << "zstd not compiled in";
+  }
+  // A single-segment frame header claiming 1TB of content, with no blocks.
+  std::string frame("\x28\xb5\x2f\xfd\xe0", 5);
+  const uint64_t content_size = uint64_t{1} << 40;
+  for (int i = 0; i < 8; i++) {
+    frame.push_back(static_cast<char>(content_size >> (8 * i)));
+  }
+  std::string output;
+  ASSERT_TRUE(UncompressBlock(CompressionType::kZstdCompression, nullptr,
+                              frame, &output)
+                  .IsCorruption());
+  ASSERT_TRUE(output.empty());
+}
+
+}  // namespace czy_leveldb
@@ -0,0 +1,128 @@
+#include "table/data_block_hash_index.h"
+
+#include <cassert>
+
+#include "util/coding.h"
+#include "util/hash.h"
+
+namespace czy_leveldb {
+
+namespace {
+
+const uint32_t kHashSeed = 0x6e5a4c3b;
+const uint32_t kIndexTypeBit = 31;
+
+inline uint32_t HashUserKey(const Slice& user_key) {
+  return Hash(user_key.data(), user_key.size(), kHashSeed);
+}
+
+}  // namespace
+
+uint32_t PackIndexTypeAndNumRestarts(DataBlockIndexType index_type,
+                                     uint32_t num_restarts) {
+  assert(num_restarts <= kMaxNumRestarts);
+  uint32_t block_footer = num_restarts;
+  if (index_type == DataBlockIndexType::kDataBlockBinaryAndHash) {
+    block_footer |= 1u << kIndexTypeBit;
+  }
+  return block_footer;
+}
+
+void UnPackIndexTypeAndNumRestarts(uint32_t block_footer,
+                                   DataBlockIndexType* index_type,
+                                   uint32_t* num_restarts) {
+  if (block_footer & (1u << kIndexTypeBit)) {
+    *index_type = DataBlockIndexType::kDataBlockBinaryAndHash;
+  } else {
+    *index_type = DataBlockIndexType::kDataBlockBinarySearch;
+  }
+  *num_restarts = block_footer & kMaxNumRestarts;
+}
+
+void DataBlockHashIndexBuilder::Initialize(double util_ratio) {
+  if (util_ratio <= 0) {
+    util_ratio = 0.75;  // sanity check
+  }
+  bucket_per_key_ = 1 / util_ratio;
+  valid_ = true;
+}
+
+void DataBlockHashIndexBuilder::Add(const Slice& user_key,
+                                    uint32_t restart_index) {
+  assert(Valid());
+  if (restart_index > kMaxRestartSupportedByHashIndex) {
+    valid_ = false;
+    return;
+  }
+  hash_and_restart_pairs_.emplace_back(HashUserKey(user_key),
+                                       static_cast<uint8_t>(restart_index));
+  estimated_num_buckets_ += bucket_per_key_;
+}
+
+void DataBlockHashIndexBuilder::Finish(std::string* buffer) {
+  assert(Valid());
+  uint32_t num_buckets = static_cast<uint32_t>(estimated_num_buckets_);
+  if (num_buckets == 0) {
+    num_buckets = 1;  // sanity check
+  }
+  // An odd bucket count spreads hash values better under modulo.
+  num_buckets |= 1;
+  if (num_buckets > 0xffff) {
+    num_buckets = 0xffff;
+  }
+
+  std::vector<uint8_t> buckets(num_buckets, kNoEntry);
+  for (const auto& entry : hash_and_restart_pairs_) {
+    const uint32_t bucket_index = entry.first % num_buckets;
+    const uint8_t restart_index = entry.second;
+    if (buckets[bucket_index] == kNoEntry) {
+      buckets[bucket_index] = restart_index;
+    } else if (buckets[bucket_index] != restart_index) {
+      buckets[bucket_index] = kCollision;
+    }
+  }
+
+  buffer->append(reinterpret_cast<const char*>(buckets.data()),
+                 buckets.size());
+  PutFixed16(buffer, static_cast<uint16_t>(num_buckets));
+}
+
+size_t DataBlockHashIndexBuilder::EstimateSize() const {
+  uint32_t estimated_num_buckets =
+      static_cast<uint32_t>(estimated_num_buckets_) | 1;
+  return sizeof(uint16_t) + estimated_num_buckets * sizeof(uint8_t);
+}
+
+void DataBlockHashIndexBuilder::Reset() {
+  estimated_num_buckets_ = 0;
+  valid_ = true;
+  hash_and_restart_pairs_.clear();
+}
+
+bool DataBlockHashIndex::Initialize(const char* data, uint32_t size,
+                                    uint32_t num_restarts,
+                                    uint32_t* map_offset) {
+  num_buckets_ = 0;
+  if (size < sizeof(uint16_t)) {
+    return false;
+  }
+  const uint16_t num_buckets = DecodeFixed16(data + size - sizeof(uint16_t));
+  // The bucket array and the restart array in front of it must both fit.
+  const uint64_t needed = sizeof(uint16_t) + num_buckets * sizeof(uint8_t) +
+                          static_cast<uint64_t>(num_restarts) * sizeof(uint32_t);
+  if (num_buckets == 0 || needed > size) {
+    return false;
+  }
+  num_buckets_ = num_buckets;
+  *map_offset = size - sizeof(uint16_t) - num_buckets_ * sizeof(uint8_t);
+  return true;
+}
+
+uint8_t DataBlockHashIndex::Lookup(const char* data, uint32_t map_offset,
+                                   const Slice& user_key) const {
+  assert(Valid());
+  const uint32_t bucket_index = HashUserKey(user_key) % num_buckets_;
+  return static_cast<uint8_t>(data[map_offset + bucket_index]);
+}
+
+}  // namespace czy_leveldb
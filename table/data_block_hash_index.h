@@ -0,0 +1,107 @@
+#pragma once
+// Optional hash index appended to a data block, used to short-cut point
+// lookups.  A data block with the index looks like:
+//
+//    entries...
+//    restarts:     uint32[num_restarts]
+//    buckets:      uint8[num_buckets]
+//    num_buckets:  uint16
+//    footer:       uint32 (num_restarts | index_type << 31)
+//
+// Each bucket holds the index of the restart interval that contains every
+// user key hashing to it, kNoEntry if no key hashes to it, or kCollision
+// if keys from different restart intervals do.  Blocks written without the
+// index have the top bit of the footer clear, which is true of every block
+// written by earlier versions, so old tables stay readable unchanged.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "leveldb/options.h"
+#include "leveldb/slice.h"
+
+namespace czy_leveldb {
+
+const uint8_t kNoEntry = 255;
+const uint8_t kCollision = 254;
+const uint8_t kMaxRestartSupportedByHashIndex = 253;
+
+// Largest restart count the block footer can hold.  Its top bit records
+// the DataBlockIndexType and bit 30 is reserved for block layout flags
+// (see table/restart_prefix_search.h).
+const uint32_t kMaxNumRestarts = (1u << 30) - 1;
+
+uint32_t PackIndexTypeAndNumRestarts(DataBlockIndexType index_type,
+                                     uint32_t num_restarts);
+
+void UnPackIndexTypeAndNumRestarts(uint32_t block_footer,
+                                   DataBlockIndexType* index_type,
+                                   uint32_t* num_restarts);
+
+class DataBlockHashIndexBuilder {
+ public:
+  DataBlockHashIndexBuilder()
+      : valid_(false), bucket_per_key_(-1), estimated_num_buckets_(0) {}
+
+  DataBlockHashIndexBuilder(const DataBlockHashIndexBuilder&) = delete;
+  DataBlockHashIndexBuilder& operator=(const DataBlockHashIndexBuilder&) =
+      delete;
+
+  void Initialize(double util_ratio);
+
+  // Return true iff the index can still be written for the current block.
+  // Becomes false once a key lands past kMaxRestartSupportedByHashIndex, in
+  // which case the block is written with the plain restart array only.
+  bool Valid() const { return valid_ && bucket_per_key_ > 0; }
+
+  // REQUIRES: "user_key" is the user portion of the internal key just added
+  // to the block, and "restart_index" the restart interval it belongs to.
+  void Add(const Slice& user_key, uint32_t restart_index);
+
+  // Append the bucket array and bucket count to *buffer.
+  // REQUIRES: Valid()
+  void Finish(std::string* buffer);
+
+  // Return an estimate of the bytes Finish() would append.
+  size_t EstimateSize() const;
+
+  // Prepare for the next block.
+  void Reset();
+
+ private:
+  bool valid_;
+  double bucket_per_key_;  // = 1 / util_ratio
+  double estimated_num_buckets_;
+
+  // Buckets are only laid out in Finish(), once the final count is known.
+  std::vector<std::pair<uint32_t, uint8_t>> hash_and_restart_pairs_;
+};
+
+class DataBlockHashIndex {
+ public:
+  DataBlockHashIndex() : num_buckets_(0) {}
+
+  // "data[0..size-1]" is the block contents without the packed footer,
+  // which records "num_restarts".  Sets *map_offset to the start of the
+  // bucket array, which is also where the restart array ends.
+  //
+  // Returns false, leaving the index !Valid(), if the bucket count does
+  // not fit in the block; the caller then uses binary search only.
+  bool Initialize(const char* data, uint32_t size, uint32_t num_restarts,
+                  uint32_t* map_offset);
+
+  // Return the restart interval that may hold "user_key", or kNoEntry /
+  // kCollision.  On kCollision the caller must fall back to binary search,
+  // as it must for an interval that is not below the block's restart
+  // count, which only a corrupt bucket can hold.
+  uint8_t Lookup(const char* data, uint32_t map_offset,
+                 const Slice& user_key) const;
+
+  bool Valid() const { return num_buckets_ != 0; }
+
+ private:
+  uint16_t num_buckets_;
+};
+
+}  // namespace czy_leveldb
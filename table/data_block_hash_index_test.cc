@@ -0,0 +1,134 @@
+#include "table/data_block_hash_index.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "util/coding.h"
+
+namespace czy_leveldb {
+
+namespace {
+
+// Lay out a block tail as the table builder does: a restart array
+// followed by the hash index.  Key i lands in restart interval i / 4.
+std::string BuildBlockTail(const std::vector<std::string>& keys,
+                           uint32_t* num_restarts) {
+  DataBlockHashIndexBuilder builder;
+  builder.Initialize(0.75);
+  std::string block;
+  *num_restarts = 0;
+  for (size_t i = 0; i < keys.size(); i++) {
+    if (i % 4 == 0) {
+      PutFixed32(&block, static_cast<uint32_t>(i));  // fake restart offset
+      (*num_restarts)++;
+    }
+    builder.Add(keys[i], static_cast<uint32_t>(i / 4));
+  }
+  EXPECT_TRUE(builder.Valid());
+  builder.Finish(&block);
+  return block;
+}
+
+}  // namespace
+
+TEST(DataBlockHashIndex, PackUnpackFooter) {
+  DataBlockIndexType type;
+  uint32_t num_restarts;
+  UnPackIndexTypeAndNumRestarts(
+      PackIndexTypeAndNumRestarts(DataBlockIndexType::kDataBlockBinaryAndHash,
+                                  1234),
+      &type, &num_restarts);
+  ASSERT_EQ(DataBlockIndexType::kDataBlockBinaryAndHash, type);
+  ASSERT_EQ(1234u, num_restarts);
+
+  UnPackIndexTypeAndNumRestarts(
+      PackIndexTypeAndNumRestarts(DataBlockIndexType::kDataBlockBinarySearch,
+                                  kMaxNumRestarts),
+      &type, &num_restarts);
+  ASSERT_EQ(DataBlockIndexType::kDataBlockBinarySearch, type);
+  ASSERT_EQ(kMaxNumRestarts, num_restarts);
+}
+
+TEST(DataBlockHashIndex, Lookup) {
+  std::vector<std::string> keys;
+  for (int i = 0; i < 200; i++) {
+    keys.push_back("key" + std::to_string(i));
+  }
+  uint32_t num_restarts;
+  const std::string block = BuildBlockTail(keys, &num_restarts);
+
+  DataBlockHashIndex index;
+  uint32_t map_offset;
+  ASSERT_TRUE(index.Initialize(block.data(),
+                               static_cast<uint32_t>(block.size()),
+                               num_restarts, &map_offset));
+  ASSERT_TRUE(index.Valid());
+  ASSERT_EQ(num_restarts * sizeof(uint32_t), map_offset);
+
+  for (size_t i = 0; i < keys.size(); i++) {
+    const uint8_t restart = index.Lookup(block.data(), map_offset, keys[i]);
+    if (restart != kCollision) {
+      ASSERT_EQ(i / 4, restart) << keys[i];
+    }
+  }
+
+  int no_entry = 0;
+  for (int i = 0; i < 1000; i++) {
+    const uint8_t restart =
+        index.Lookup(block.data(), map_offset, "missing" + std::to_string(i));
+    if (restart == kNoEntry) {
+      no_entry++;
+    }
+  }
+  // With a 0.75 utilization ratio most buckets of absent keys are empty.
+  ASSERT_GT(no_entry, 100);
+}
+
+TEST(DataBlockHashIndex, BuilderGivesUpPastMaxRestart) {
+  DataBlockHashIndexBuilder builder;
+  builder.Initialize(0.75);
+  builder.Add("a", kMaxRestartSupportedByHashIndex);
+  ASSERT_TRUE(builder.Valid());
+  builder.Add("b", kMaxRestartSupportedByHashIndex + 1);
+  ASSERT_FALSE(builder.Valid());
+  builder.Reset();
+  ASSERT_TRUE(builder.Valid());
+}
+
+TEST(DataBlockHashIndex, CorruptBucketCount) {
+  uint32_t num_restarts;
+  std::string block = BuildBlockTail({"a", "b", "c", "d", "e"}, &num_restarts);
+  DataBlockHashIndex index;
+  uint32_t map_offset;
+
+  // Too short to hold the bucket count.
+  ASSERT_FALSE(index.Initialize(block.data(), 1, num_restarts, &map_offset));
+  ASSERT_FALSE(index.Valid());
+
+  // Bucket count larger than the block.
+  std::string corrupt = block;
+  EncodeFixed16(&corrupt[corrupt.size() - 2], 0xffff);
+  ASSERT_FALSE(index.Initialize(corrupt.data(),
+                                static_cast<uint32_t>(corrupt.size()),
+                                num_restarts, &map_offset));
+  ASSERT_FALSE(index.Valid());
+
+  // Zero buckets.
+  EncodeFixed16(&corrupt[corrupt.size() - 2], 0);
+  ASSERT_FALSE(index.Initialize(corrupt.data(),
+                                static_cast<uint32_t>(corrupt.size()),
+                                num_restarts, &map_offset));
+
+  // Buckets that would overlap the restart array.
+  ASSERT_FALSE(index.Initialize(block.data(),
+                                static_cast<uint32_t>(block.size()),
+                                num_restarts + 100, &map_offset));
+  ASSERT_FALSE(index.Valid());
+
+  ASSERT_TRUE(index.Initialize(block.data(),
+                               static_cast<uint32_t>(block.size()),
+                               num_restarts, &map_offset));
+}
+
+}  // namespace czy_leveldb
@@ -0,0 +1,110 @@
+#include "table/meta_block_cache.h"
+
+#include <cassert>
+
+#include "util/coding.h"
+
+namespace czy_leveldb {
+
+MetaBlockCache::MetaBlockCache(const Options& options, int level)
+    : cache_(options.cache_index_and_filter_blocks ? options.block_cache
+                                                   : nullptr),
+      pinned_(cache_ != nullptr && level == 0 &&
+              options.pin_l0_filter_and_index_blocks_in_cache),
+      cache_id_(cache_ != nullptr ? cache_->NewId() : 0) {}
+
+MetaBlockCache::~MetaBlockCache() {
+  char key[kCacheKeySize];
+  for (auto& entry : held_) {
+    Held& held = entry.second;
+    if (held.handle == nullptr) {
+      (*held.deleter)(Slice(), held.value);
+    } else {
+      // Nothing else can look this table's blocks up once it is closed, so
+      // free them now instead of leaving them to age out of the cache.
+      cache_->Release(held.handle);
+      EncodeCacheKey(entry.first, key);
+      cache_->Erase(Slice(key, sizeof(key)));
+    }
+  }
+}
+
+void MetaBlockCache::EncodeCacheKey(uint64_t offset, char* key) const {
+  EncodeFixed64(key, cache_id_);
+  EncodeFixed64(key + 8, offset);
+}
+
+Status MetaBlockCache::Get(uint64_t offset, Loader loader, void* arg,
+                           Deleter deleter, void** value,
+                           Cache::Handle** cache_handle) {
+  *cache_handle = nullptr;
+
+  if (cache_ != nullptr && !pinned_) {
+    // Concurrent misses may both read the block; the later Insert()
+    // replaces the earlier entry, which is freed once released.
+    char key[kCacheKeySize];
+    EncodeCacheKey(offset, key);
+    const Slice cache_key(key, sizeof(key));
+    Cache::Handle* handle = cache_->Lookup(cache_key);
+    if (handle == nullptr) {
+      void* loaded;
+      size_t charge;
+      Status s = (*loader)(arg, &loaded, &charge);
+      if (!s.ok()) {
+        return s;
+      }
+      handle = cache_->Insert(cache_key, loaded, charge, deleter);
+    }
+    *value = cache_->Value(handle);
+    *cache_handle = handle;
+    return Status::OK();
+  }
+
+  // Owned or pinned: read each block at most once.  Holding mu_ across the
+  // read keeps concurrent first lookups from reading it twice.
+  mu_.Lock();
+  auto it = held_.find(offset);
+  if (it != held_.end()) {
+    *value = it->second.value;
+    mu_.UnLock();
+    return Status::OK();
+  }
+  void* loaded;
+  size_t charge;
+  Status s = (*loader)(arg, &loaded, &charge);
+  if (s.ok()) {
+    Held held;
+    held.value = loaded;
+    held.deleter = deleter;
+    held.handle = nullptr;
+    if (pinned_) {
+      char key[kCacheKeySize];
+      EncodeCacheKey(offset, key);
+      held.handle = cache_->Insert(Slice(key, sizeof(key)), loaded, charge,
+                                   deleter);
+      held.value = cache_->Value(held.handle);
+    }
+    held_.emplace(offset, held);
+    *value = held.value;
+  }
+  mu_.UnLock();
+  return s;
+}
+
+LazyMetaLoader::LazyMetaLoader(Loader loader, void* arg)
+    : loader_(loader), arg_(arg), done_(false) {}
+
+Status LazyMetaLoader::Load() {
+  if (done_.load(std::memory_order_acquire)) {
+    return status_;
+  }
+  mu_.Lock();
+  if (!done_.load(std::memory_order_relaxed)) {
+    status_ = (*loader_)(arg_);
+    done_.store(true, std::memory_order_release);
+  }
+  mu_.UnLock();
+  return status_;
+}
+
+}  // namespace czy_leveldb
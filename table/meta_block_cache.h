@@ -0,0 +1,118 @@
+#pragma once
+// How an open table holds its index and filter blocks, and when it reads
+// them.
+//
+// MetaBlockCache implements Options::cache_index_and_filter_blocks and
+// Options::pin_l0_filter_and_index_blocks_in_cache.  Without the former,
+// each meta block is read once and owned by the table until it is closed.
+// With it, meta blocks live in Options::block_cache, charged at the memory
+// they hold, under a key made of a cache id unique to the table and the
+// block's file offset, so that metadata shares the block cache's bound
+// and can be evicted like data blocks.  Level-0 tables with the pin option
+// keep their handles until they are closed, so their blocks stay resident.
+//
+// LazyMetaLoader implements Options::lazy_table_open by deferring the
+// footer, index and filter reads to the first lookup.
+//
+// Both are safe to use from multiple threads.
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+
+#include "leveldb/cache.h"
+#include "leveldb/options.h"
+#include "leveldb/slice.h"
+#include "leveldb/status.h"
+#include "port/port.h"
+#include "port/thread_annotations.h"
+
+namespace czy_leveldb {
+
+class MetaBlockCache {
+ public:
+  // Reads and parses a meta block.  On success sets *value to the parsed
+  // block and *charge to the bytes it holds in memory.
+  typedef Status (*Loader)(void* arg, void** value, size_t* charge);
+  // Frees a value produced by a Loader.  Matches Cache's deleter so that
+  // cached and owned blocks are freed the same way.
+  typedef void (*Deleter)(const Slice& key, void* value);
+
+  // "level" is the level of the table whose blocks this holds, or -1 if
+  // the table is not part of a DB.
+  MetaBlockCache(const Options& options, int level);
+
+  MetaBlockCache(const MetaBlockCache&) = delete;
+  MetaBlockCache& operator=(const MetaBlockCache&) = delete;
+
+  // Frees owned blocks and unpins (and drops from the cache) pinned ones.
+  // REQUIRES: every handle returned by Get() has been released.
+  ~MetaBlockCache();
+
+  // True if blocks go through Options::block_cache.
+  bool cached() const { return cache_ != nullptr; }
+
+  // True if blocks go through the cache and stay pinned there.
+  bool pinned() const { return pinned_; }
+
+  // Set *value to the meta block at file offset "offset", reading it with
+  // loader(arg, ...) if it is not held or cached yet.  If the block must be
+  // released after use, *cache_handle is set to the handle to pass to
+  // Release(); otherwise it is set to nullptr and *value stays valid until
+  // this object is destroyed.  Returns the loader's status on failure.
+  Status Get(uint64_t offset, Loader loader, void* arg, Deleter deleter,
+             void** value, Cache::Handle** cache_handle);
+
+  // Release a handle returned by Get().
+  void Release(Cache::Handle* cache_handle) { cache_->Release(cache_handle); }
+
+ private:
+  static const size_t kCacheKeySize = 16;
+
+  // A block owned by this object (cache_ == nullptr) or pinned in cache_.
+  struct Held {
+    void* value;
+    Deleter deleter;
+    Cache::Handle* handle;
+  };
+
+  void EncodeCacheKey(uint64_t offset, char* key) const;
+
+  Cache* const cache_;
+  const bool pinned_;
+  const uint64_t cache_id_;
+
+  port::Mutex mu_;
+  // Keyed by file offset.  Empty unless blocks are owned or pinned.
+  std::map<uint64_t, Held> held_ GUARDED_BY(mu_);
+};
+
+class LazyMetaLoader {
+ public:
+  // Reads the table's footer, index and filter.
+  typedef Status (*Loader)(void* arg);
+
+  LazyMetaLoader(Loader loader, void* arg);
+
+  LazyMetaLoader(const LazyMetaLoader&) = delete;
+  LazyMetaLoader& operator=(const LazyMetaLoader&) = delete;
+
+  // Run the loader if no call has yet, and return its status.  Concurrent
+  // first callers wait for a single run; a failed load is not retried, so
+  // every later call returns the same error.
+  Status Load();
+
+  bool loaded() const { return done_.load(std::memory_order_acquire); }
+
+ private:
+  const Loader loader_;
+  void* const arg_;
+
+  port::Mutex mu_;
+  // Set, with release ordering, once status_ is final; status_ is only
+  // written before that, so it may be read without mu_ afterwards.
+  std::atomic<bool> done_;
+  Status status_;
+};
+
+}  // namespace czy_leveldb
@@ -0,0 +1,310 @@
+#include "table/meta_block_cache.h"
+
+#include <atomic>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace czy_leveldb {
+
+namespace {
+
+// A Cache with reference counting and charge accounting but no capacity:
+// entries leave it only through Erase(), Insert() over the same key, or
+// Prune(), which evicts every entry nobody holds a handle to.
+class FakeCache : public Cache {
+ public:
+  FakeCache() : next_id_(1) {}
+
+  ~FakeCache() override {
+    for (auto& entry : table_) {
+      Unref(entry.second);
+    }
+  }
+
+  Handle* Insert(const Slice& key, void* value, size_t charge,
+                 void (*deleter)(const Slice& key, void* value)) override {
+    Entry* e = new Entry;
+    e->key = key.ToString();
+    e->value = value;
+    e->charge = charge;
+    e->deleter = deleter;
+    e->refs = 2;  // One for the table, one for the returned handle.
+    auto it = table_.find(e->key);
+    if (it != table_.end()) {
+      Unref(it->second);
+      it->second = e;
+    } else {
+      table_[e->key] = e;
+    }
+    return e;
+  }
+
+  Handle* Lookup(const Slice& key) override {
+    auto it = table_.find(key.ToString());
+    if (it == table_.end()) {
+      return nullptr;
+    }
+    it->second->refs++;
+    return it->second;
+  }
+
+  void Release(Handle* handle) override {
+    Unref(static_cast<Entry*>(handle));
+  }
+
+  void* Value(Handle* handle) override {
+    return static_cast<Entry*>(handle)->value;
+  }
+
+  void Erase(const Slice& key) override {
+    auto it = table_.find(key.ToString());
+    if (it != table_.end()) {
+      Unref(it->second);
+      table_.erase(it);
+    }
+  }
+
+  uint64_t NewId() override { return next_id_++; }
+
+  void Prune() override {
+    for (auto it = table_.begin(); it != table_.end();) {
+      if (it->second->refs == 1) {
+        Unref(it->second);
+        it = table_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  size_t TotalCharge() const override {
+    size_t total = 0;
+    for (const auto& entry : table_) {
+      total += entry.second->charge;
+    }
+    return total;
+  }
+
+  size_t size() const { return table_.size(); }
+
+ private:
+  struct Entry : public Handle {
+    std::string key;
+    void* value;
+    size_t charge;
+    void (*deleter)(const Slice& key, void* value);
+    int refs;
+  };
+
+  void Unref(Entry* e) {
+    if (--e->refs == 0) {
+      (*e->deleter)(e->key, e->value);
+      delete e;
+    }
+  }
+
+  uint64_t next_id_;
+  std::map<std::string, Entry*> table_;
+};
+
+// Counts loads and frees of fake meta blocks, which are heap strings.
+struct BlockSource {
+  std::atomic<int> loads{0};
+  std::atomic<int> deletes{0};
+  Status status;
+};
+
+BlockSource* deleted_source = nullptr;
+
+Status LoadBlock(void* arg, void** value, size_t* charge) {
+  BlockSource* source = static_cast<BlockSource*>(arg);
+  source->loads++;
+  if (!source->status.ok()) {
+    return source->status;
+  }
+  std::string* block = new std::string(1000, 'x');
+  *value = block;
+  *charge = block->size();
+  return Status::OK();
+}
+
+void DeleteBlock(const Slice& /*key*/, void* value) {
+  delete static_cast<std::string*>(value);
+  deleted_source->deletes++;
+}
+
+class MetaBlockCacheTest : public testing::Test {
+ public:
+  MetaBlockCacheTest() {
+    deleted_source = &source_;
+    options_.block_cache = &cache_;
+    options_.cache_index_and_filter_blocks = true;
+  }
+
+  std::string* Get(MetaBlockCache* meta, uint64_t offset,
+                   Cache::Handle** handle) {
+    void* value = nullptr;
+    EXPECT_TRUE(
+        meta->Get(offset, &LoadBlock, &source_, &DeleteBlock, &value, handle)
+            .ok());
+    return static_cast<std::string*>(value);
+  }
+
+ protected:
+  // Declared before anything that may hold blocks so it outlives them.
+  BlockSource source_;
+  FakeCache cache_;
+  Options options_;
+};
+
+}  // namespace
+
+TEST_F(MetaBlockCacheTest, OwnedWithoutCacheOption) {
+  options_.cache_index_and_filter_blocks = false;
+  {
+    MetaBlockCache meta(options_, 0);
+    ASSERT_FALSE(meta.cached());
+    Cache::Handle* handle;
+    std::string* index = Get(&meta, 100, &handle);
+    ASSERT_EQ(nullptr, handle);
+    ASSERT_EQ(index, Get(&meta, 100, &handle));
+    Get(&meta, 200, &handle);
+    ASSERT_EQ(2, source_.loads.load());
+    ASSERT_EQ(0u, cache_.TotalCharge());
+  }
+  ASSERT_EQ(2, source_.deletes.load());
+}
+
+TEST_F(MetaBlockCacheTest, CachedBlocksAreChargedAndEvictable) {
+  MetaBlockCache meta(options_, 1);
+  ASSERT_TRUE(meta.cached());
+  ASSERT_FALSE(meta.pinned());
+
+  Cache::Handle* handle;
+  Get(&meta, 100, &handle);
+  ASSERT_TRUE(handle != nullptr);
+  ASSERT_EQ(1000u, cache_.TotalCharge());
+
+  // In use: survives a prune.
+  cache_.Prune();
+  ASSERT_EQ(1000u, cache_.TotalCharge());
+  meta.Release(handle);
+
+  // Served from the cache while it is there.
+  Get(&meta, 100, &handle);
+  meta.Release(handle);
+  ASSERT_EQ(1, source_.loads.load());
+
+  // Evicted once released, and read again on the next use.
+  cache_.Prune();
+  ASSERT_EQ(0u, cache_.TotalCharge());
+  ASSERT_EQ(1, source_.deletes.load());
+  Get(&meta, 100, &handle);
+  meta.Release(handle);
+  ASSERT_EQ(2, source_.loads.load());
+}
+
+TEST_F(MetaBlockCacheTest, PinsLevelZeroBlocks) {
+  options_.pin_l0_filter_and_index_blocks_in_cache = true;
+  {
+    MetaBlockCache l0(options_, 0);
+    MetaBlockCache l1(options_, 1);
+    ASSERT_TRUE(l0.pinned());
+    ASSERT_FALSE(l1.pinned());
+
+    Cache::Handle* handle;
+    std::string* pinned = Get(&l0, 100, &handle);
+    ASSERT_EQ(nullptr, handle);
+    Get(&l1, 100, &handle);
+    l1.Release(handle);
+    // Pinned blocks still count against the cache.
+    ASSERT_EQ(2000u, cache_.TotalCharge());
+
+    cache_.Prune();
+    ASSERT_EQ(1000u, cache_.TotalCharge());
+    ASSERT_EQ(pinned, Get(&l0, 100, &handle));
+    ASSERT_EQ(1, source_.deletes.load());
+  }
+  // Closing the level-0 table drops its pinned block from the cache.
+  ASSERT_EQ(0u, cache_.size());
+  ASSERT_EQ(2, source_.deletes.load());
+}
+
+TEST_F(MetaBlockCacheTest, PinOptionNeedsCacheOption) {
+  options_.cache_index_and_filter_blocks = false;
+  options_.pin_l0_filter_and_index_blocks_in_cache = true;
+  MetaBlockCache meta(options_, 0);
+  ASSERT_FALSE(meta.cached());
+  ASSERT_FALSE(meta.pinned());
+}
+
+TEST_F(MetaBlockCacheTest, TablesUseDistinctKeys) {
+  MetaBlockCache a(options_, 1);
+  MetaBlockCache b(options_, 1);
+  Cache::Handle* ha;
+  Cache::Handle* hb;
+  std::string* block_a = Get(&a, 100, &ha);
+  std::string* block_b = Get(&b, 100, &hb);
+  ASSERT_NE(block_a, block_b);
+  a.Release(ha);
+  b.Release(hb);
+  ASSERT_EQ(2u, cache_.size());
+}
+
+TEST_F(MetaBlockCacheTest, LoadErrorIsReturned) {
+  source_.status = Status::IOError("read failed");
+  for (int level : {0, 1}) {
+    options_.pin_l0_filter_and_index_blocks_in_cache = level == 0;
+    MetaBlockCache meta(options_, level);
+    void* value = nullptr;
+    Cache::Handle* handle;
+    ASSERT_TRUE(
+        meta.Get(100, &LoadBlock, &source_, &DeleteBlock, &value, &handle)
+            .IsIOError());
+    ASSERT_EQ(nullptr, handle);
+    ASSERT_EQ(0u, cache_.size());
+  }
+}
+
+namespace {
+
+Status CountedLoad(void* arg) {
+  BlockSource* source = static_cast<BlockSource*>(arg);
+  source->loads++;
+  return source->status;
+}
+
+}  // namespace
+
+TEST(LazyMetaLoader, LoadsOnceOnFirstUse) {
+  BlockSource source;
+  LazyMetaLoader loader(&CountedLoad, &source);
+  ASSERT_FALSE(loader.loaded());
+  ASSERT_EQ(0, source.loads.load());
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; i++) {
+    threads.emplace_back([&loader] { ASSERT_TRUE(loader.Load().ok()); });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  ASSERT_TRUE(loader.loaded());
+  ASSERT_EQ(1, source.loads.load());
+}
+
+TEST(LazyMetaLoader, ErrorIsSticky) {
+  BlockSource source;
+  source.status = Status::Corruption("bad footer");
+  LazyMetaLoader loader(&CountedLoad, &source);
+  ASSERT_TRUE(loader.Load().IsCorruption());
+  source.status = Status::OK();
+  ASSERT_TRUE(loader.Load().IsCorruption());
+  ASSERT_EQ(1, source.loads.load());
+}
+
+}  // namespace czy_leveldb
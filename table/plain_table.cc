@@ -0,0 +1,373 @@
+#include "table/plain_table.h"
+
+#include <cassert>
+#include <limits>
+
+#include "leveldb/comparator.h"
+#include "leveldb/env.h"
+#include "util/coding.h"
+#include "util/hash.h"
+
+namespace czy_leveldb {
+
+namespace {
+
+const uint64_t kPlainTableMagicNumber = 0x706c61696e746162ull;  // "plaintab"
+const size_t kPlainTableFooterSize = 32;
+const uint32_t kIndexInterval = 16;
+const uint32_t kEmptyBucket = 0xffffffffu;
+const uint32_t kHashSeed = 0x3c9a5e17;
+
+inline Slice HashKey(const Slice& key, size_t suffix_len) {
+  assert(key.size() >= suffix_len);
+  return Slice(key.data(), key.size() - suffix_len);
+}
+
+inline uint32_t HashOf(const Slice& hash_key) {
+  return Hash(hash_key.data(), hash_key.size(), kHashSeed);
+}
+
+}  // namespace
+
+PlainTableBuilder::PlainTableBuilder(const Options& options,
+                                     WritableFile* file,
+                                     size_t hash_key_suffix_len)
+    : options_(options),
+      file_(file),
+      hash_key_suffix_len_(hash_key_suffix_len),
+      offset_(0),
+      num_entries_(0),
+      closed_(false) {}
+
+PlainTableBuilder::~PlainTableBuilder() {
+  assert(closed_);  // Catch errors where caller forgot to call Finish()
+}
+
+void PlainTableBuilder::Add(const Slice& key, const Slice& value) {
+  assert(!closed_);
+  if (!ok()) return;
+  if (num_entries_ > 0) {
+    assert(options_.comparator->Compare(key, Slice(last_key_)) > 0);
+  }
+  if (offset_ > std::numeric_limits<uint32_t>::max()) {
+    status_ = Status::InvalidArgument("plain table larger than 4GB");
+    return;
+  }
+
+  const uint32_t record_offset = static_cast<uint32_t>(offset_);
+  if (num_entries_ % kIndexInterval == 0) {
+    index_.push_back(record_offset);
+  }
+  const Slice hash_key = HashKey(key, hash_key_suffix_len_);
+  if (num_entries_ == 0 ||
+      hash_key != HashKey(Slice(last_key_), hash_key_suffix_len_)) {
+    hash_entries_.emplace_back(HashOf(hash_key), record_offset);
+  }
+
+  record_.clear();
+  PutVarint32(&record_, key.size());
+  PutVarint32(&record_, value.size());
+  record_.append(key.data(), key.size());
+  record_.append(value.data(), value.size());
+  status_ = file_->Append(record_);
+  if (ok()) {
+    offset_ += record_.size();
+    last_key_.assign(key.data(), key.size());
+    num_entries_++;
+  }
+}
+
+Status PlainTableBuilder::Finish() {
+  assert(!closed_);
+  closed_ = true;
+  if (!ok()) return status_;
+
+  // Open addressing with linear probing at a load factor of at most 3/4.
+  const uint64_t num_buckets64 = hash_entries_.size() * 4 / 3 + 1;
+  // Every offset in the footer, including the end of the hash table, must
+  // fit in 32 bits; Add() only checked where each record starts.
+  if (offset_ + 4 * (index_.size() + num_buckets64) + kPlainTableFooterSize >
+      std::numeric_limits<uint32_t>::max()) {
+    status_ = Status::InvalidArgument("plain table larger than 4GB");
+    return status_;
+  }
+
+  const uint32_t index_offset = static_cast<uint32_t>(offset_);
+  std::string tail;
+  for (uint32_t record_offset : index_) {
+    PutFixed32(&tail, record_offset);
+  }
+
+  const uint32_t num_buckets = static_cast<uint32_t>(num_buckets64);
+  std::vector<uint32_t> buckets(num_buckets, kEmptyBucket);
+  for (const auto& entry : hash_entries_) {
+    uint32_t b = entry.first % num_buckets;
+    while (buckets[b] != kEmptyBucket) {
+      b = (b + 1) % num_buckets;
+    }
+    buckets[b] = entry.second;
+  }
+  const uint32_t hash_offset =
+      index_offset + static_cast<uint32_t>(tail.size());
+  for (uint32_t bucket : buckets) {
+    PutFixed32(&tail, bucket);
+  }
+
+  PutFixed64(&tail, num_entries_);
+  PutFixed32(&tail, index_offset);
+  PutFixed32(&tail, static_cast<uint32_t>(index_.size()));
+  PutFixed32(&tail, hash_offset);
+  PutFixed32(&tail, num_buckets);
+  PutFixed64(&tail, kPlainTableMagicNumber);
+
+  status_ = file_->Append(tail);
+  if (ok()) {
+    offset_ += tail.size();
+  }
+  return status_;
+}
+
+void PlainTableBuilder::Abandon() {
+  assert(!closed_);
+  closed_ = true;
+}
+
+Status PlainTable::Open(const Options& options, RandomAccessFile* file,
+                        uint64_t file_size, size_t hash_key_suffix_len,
+                        PlainTable** table) {
+  *table = nullptr;
+  if (file_size < kPlainTableFooterSize ||
+      file_size > std::numeric_limits<uint32_t>::max()) {
+    return Status::Corruption("file is too short or too long to be a plain table");
+  }
+
+  // Probe with the footer: an mmap-backed file returns a pointer into the
+  // mapping rather than into the caller's scratch, and can then hand out
+  // the whole file without a copy.
+  char footer_scratch[kPlainTableFooterSize];
+  Slice footer_input;
+  Status s = file->Read(file_size - kPlainTableFooterSize,
+                        kPlainTableFooterSize, &footer_input, footer_scratch);
+  if (!s.ok()) {
+    return s;
+  }
+  const bool mmapped = (footer_input.data() != footer_scratch);
+
+  PlainTable* t = new PlainTable(options, hash_key_suffix_len);
+  if (mmapped) {
+    // Scratch is unused when the file serves reads from its mapping.
+    s = file->Read(0, file_size, &t->contents_, nullptr);
+  } else {
+    t->owned_contents_ = new char[file_size];
+    s = file->Read(0, file_size, &t->contents_, t->owned_contents_);
+  }
+  if (s.ok() && t->contents_.size() != file_size) {
+    s = Status::Corruption("truncated plain table read");
+  }
+  if (!s.ok()) {
+    delete t;
+    return s;
+  }
+
+  const char* footer = t->contents_.data() + file_size - kPlainTableFooterSize;
+  t->index_offset_ = DecodeFixed32(footer + 8);
+  t->num_index_entries_ = DecodeFixed32(footer + 12);
+  t->hash_offset_ = DecodeFixed32(footer + 16);
+  t->num_buckets_ = DecodeFixed32(footer + 20);
+  t->data_end_ = t->index_offset_;
+  const uint64_t magic = DecodeFixed64(footer + 24);
+  if (magic != kPlainTableMagicNumber ||
+      t->hash_offset_ !=
+          t->index_offset_ + 4ull * t->num_index_entries_ ||
+      t->hash_offset_ + 4ull * t->num_buckets_ !=
+          file_size - kPlainTableFooterSize ||
+      t->num_buckets_ == 0) {
+    delete t;
+    return Status::Corruption("not a plain table (bad footer)");
+  }
+
+  *table = t;
+  return Status::OK();
+}
+
+PlainTable::~PlainTable() { delete[] owned_contents_; }
+
+uint32_t PlainTable::IndexEntry(uint32_t i) const {
+  return DecodeFixed32(contents_.data() + index_offset_ + 4 * i);
+}
+
+uint32_t PlainTable::DecodeRecord(uint32_t offset, Slice* key,
+                                  Slice* value) const {
+  const char* p = contents_.data() + offset;
+  const char* limit = contents_.data() + data_end_;
+  uint32_t key_len, value_len;
+  if ((p = GetVarint32Ptr(p, limit, &key_len)) == nullptr) return 0;
+  if ((p = GetVarint32Ptr(p, limit, &value_len)) == nullptr) return 0;
+  if (static_cast<uint64_t>(limit - p) <
+      static_cast<uint64_t>(key_len) + value_len) {
+    return 0;
+  }
+  *key = Slice(p, key_len);
+  *value = Slice(p + key_len, value_len);
+  return static_cast<uint32_t>(p + key_len + value_len - contents_.data());
+}
+
+Status PlainTable::Get(const Slice& target, Slice* key, Slice* value,
+                       bool* found) const {
+  *found = false;
+  const Slice hash_key = HashKey(target, hash_key_suffix_len_);
+  const char* buckets = contents_.data() + hash_offset_;
+  uint32_t b = HashOf(hash_key) % num_buckets_;
+  for (uint32_t probes = 0; probes < num_buckets_; probes++) {
+    const uint32_t offset = DecodeFixed32(buckets + 4 * b);
+    if (offset == kEmptyBucket) {
+      return Status::OK();
+    }
+    Slice k, v;
+    uint32_t next = DecodeRecord(offset, &k, &v);
+    if (next == 0) {
+      return Status::Corruption("bad record in plain table");
+    }
+    if (HashKey(k, hash_key_suffix_len_) == hash_key) {
+      // Walk the versions of this hash key up to the target.
+      while (options_.comparator->Compare(k, target) < 0) {
+        if (next >= data_end_) return Status::OK();
+        next = DecodeRecord(next, &k, &v);
+        if (next == 0) {
+          return Status::Corruption("bad record in plain table");
+        }
+        if (HashKey(k, hash_key_suffix_len_) != hash_key) {
+          return Status::OK();
+        }
+      }
+      *key = k;
+      *value = v;
+      *found = true;
+      return Status::OK();
+    }
+    b = (b + 1) % num_buckets_;
+  }
+  return Status::OK();
+}
+
+class PlainTableIterator : public Iterator {
+ public:
+  explicit PlainTableIterator(const PlainTable* table)
+      : table_(table), offset_(0), next_offset_(0), valid_(false) {}
+
+  bool Valid() const override { return valid_; }
+  Slice key() const override {
+    assert(valid_);
+    return key_;
+  }
+  Slice value() const override {
+    assert(valid_);
+    return value_;
+  }
+  Status status() const override { return status_; }
+
+  void SeekToFirst() override { ParseAt(0); }
+
+  void SeekToLast() override {
+    if (table_->num_index_entries_ == 0) {
+      valid_ = false;
+      return;
+    }
+    ParseAt(table_->IndexEntry(table_->num_index_entries_ - 1));
+    while (valid_ && next_offset_ < table_->data_end_) {
+      ParseAt(next_offset_);
+    }
+  }
+
+  void Seek(const Slice& target) override {
+    // Binary search the sparse index for the last entry before "target",
+    // then scan forward.
+    uint32_t left = 0;
+    uint32_t right = table_->num_index_entries_;
+    while (left + 1 < right) {
+      const uint32_t mid = left + (right - left) / 2;
+      Slice k, v;
+      if (table_->DecodeRecord(table_->IndexEntry(mid), &k, &v) == 0) {
+        Corrupt();
+        return;
+      }
+      if (table_->options_.comparator->Compare(k, target) < 0) {
+        left = mid;
+      } else {
+        right = mid;
+      }
+    }
+    if (table_->num_index_entries_ == 0) {
+      valid_ = false;
+      return;
+    }
+    ParseAt(table_->IndexEntry(left));
+    while (valid_ && table_->options_.comparator->Compare(key_, target) < 0) {
+      Next();
+    }
+  }
+
+  void Next() override {
+    assert(valid_);
+    ParseAt(next_offset_);
+  }
+
+  void Prev() override {
+    assert(valid_);
+    const uint32_t current = offset_;
+    // Find the last index entry before the current record.
+    uint32_t left = 0;
+    uint32_t right = table_->num_index_entries_;
+    while (left < right) {
+      const uint32_t mid = left + (right - left) / 2;
+      if (table_->IndexEntry(mid) < current) {
+        left = mid + 1;
+      } else {
+        right = mid;
+      }
+    }
+    if (left == 0) {
+      valid_ = false;  // Already at the first record.
+      return;
+    }
+    ParseAt(table_->IndexEntry(left - 1));
+    while (valid_ && next_offset_ < current) {
+      ParseAt(next_offset_);
+    }
+  }
+
+ private:
+  void ParseAt(uint32_t offset) {
+    if (offset >= table_->data_end_) {
+      valid_ = false;
+      return;
+    }
+    const uint32_t next = table_->DecodeRecord(offset, &key_, &value_);
+    if (next == 0) {
+      Corrupt();
+      return;
+    }
+    offset_ = offset;
+    next_offset_ = next;
+    valid_ = true;
+  }
+
+  void Corrupt() {
+    valid_ = false;
+    status_ = Status::Corruption("bad record in plain table");
+  }
+
+  const PlainTable* const table_;
+  uint32_t offset_;
+  uint32_t next_offset_;
+  bool valid_;
+  Slice key_;
+  Slice value_;
+  Status status_;
+};
+
+Iterator* PlainTable::NewIterator() const {
+  return new PlainTableIterator(this);
+}
+
+}  // namespace czy_leveldb
@@ -0,0 +1,134 @@
+#pragma once
+// Plain table format, for tables served from memory through an mmap'd
+// RandomAccessFile.  Instead of compressed, restart-encoded blocks read
+// through the block cache, records are stored back to back and lookups
+// return Slices pointing straight into the file contents.
+//
+// File format:
+//
+//    records:  { varint32 key_len, varint32 value_len, key, value }*
+//    index:    fixed32[num_index_entries]  offset of every 16th record
+//    hash:     fixed32[num_buckets]        offset of the first record of
+//                                          each hash key, or kEmptyBucket
+//    footer:   fixed64 num_entries
+//              fixed32 index_offset
+//              fixed32 num_index_entries
+//              fixed32 hash_offset
+//              fixed32 num_buckets
+//              fixed64 kPlainTableMagicNumber
+//
+// The "hash key" of a record is its key without the trailing
+// hash_key_suffix_len bytes, so several versions of one user key (which
+// differ only in their 8-byte internal key tag) share one hash entry that
+// points at the first, i.e. newest, of them.  Offsets are 32 bits wide,
+// which limits a plain table to 4GB.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "leveldb/export.h"
+#include "leveldb/iterator.h"
+#include "leveldb/options.h"
+#include "leveldb/status.h"
+
+namespace czy_leveldb {
+
+class RandomAccessFile;
+class WritableFile;
+
+class PlainTableBuilder {
+ public:
+  // Create a builder that will store the contents of the table it is
+  // building in *file.  Does not close the file.
+  PlainTableBuilder(const Options& options, WritableFile* file,
+                    size_t hash_key_suffix_len);
+
+  PlainTableBuilder(const PlainTableBuilder&) = delete;
+  PlainTableBuilder& operator=(const PlainTableBuilder&) = delete;
+
+  // REQUIRES: Either Finish() or Abandon() has been called.
+  ~PlainTableBuilder();
+
+  // REQUIRES: key is after any previously added key according to comparator.
+  // REQUIRES: Finish(), Abandon() have not been called
+  void Add(const Slice& key, const Slice& value);
+
+  Status status() const { return status_; }
+
+  // Write the index, hash table and footer.
+  // REQUIRES: Finish(), Abandon() have not been called
+  Status Finish();
+
+  // REQUIRES: Finish(), Abandon() have not been called
+  void Abandon();
+
+  uint64_t NumEntries() const { return num_entries_; }
+  uint64_t FileSize() const { return offset_; }
+
+ private:
+  bool ok() const { return status_.ok(); }
+
+  const Options options_;
+  WritableFile* const file_;
+  const size_t hash_key_suffix_len_;
+  Status status_;
+  uint64_t offset_;
+  uint64_t num_entries_;
+  bool closed_;
+  std::string last_key_;
+  std::string record_;
+  std::vector<uint32_t> index_;
+  // (hash, record offset) of the first record of every hash key.
+  std::vector<std::pair<uint32_t, uint32_t>> hash_entries_;
+};
+
+class PlainTable {
+ public:
+  // Open the plain table stored in bytes [0..file_size) of "file".  With
+  // an mmap-backed file no data is copied; otherwise the whole file is
+  // read into memory owned by the table.
+  //
+  // *file must remain live while this table is in use.
+  static Status Open(const Options& options, RandomAccessFile* file,
+                     uint64_t file_size, size_t hash_key_suffix_len,
+                     PlainTable** table);
+
+  PlainTable(const PlainTable&) = delete;
+  PlainTable& operator=(const PlainTable&) = delete;
+
+  ~PlainTable();
+
+  // Find the first record at or after "target" that has the same hash key
+  // as "target".  On success sets *found and points *key and *value into
+  // the table; they remain valid while the table is open.
+  Status Get(const Slice& target, Slice* key, Slice* value,
+             bool* found) const;
+
+  Iterator* NewIterator() const;
+
+ private:
+  friend class PlainTableIterator;
+
+  PlainTable(const Options& options, size_t hash_key_suffix_len)
+      : options_(options),
+        hash_key_suffix_len_(hash_key_suffix_len),
+        owned_contents_(nullptr) {}
+
+  // Decode the record at "offset".  Returns the offset of the following
+  // record, or 0 if the record is corrupt.
+  uint32_t DecodeRecord(uint32_t offset, Slice* key, Slice* value) const;
+  uint32_t IndexEntry(uint32_t i) const;
+
+  const Options options_;
+  const size_t hash_key_suffix_len_;
+  char* owned_contents_;  // Only set if the file is not mmap-backed.
+  Slice contents_;
+  uint32_t data_end_;
+  uint32_t index_offset_;
+  uint32_t num_index_entries_;
+  uint32_t hash_offset_;
+  uint32_t num_buckets_;
+};
+
+}  // namespace czy_leveldb
@@ -0,0 +1,210 @@
+#include "table/plain_table.h"
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "leveldb/env.h"
+
+namespace czy_leveldb {
+
+namespace {
+
+class StringSink : public WritableFile {
+ public:
+  Status Append(const Slice& data) override {
+    contents_.append(data.data(), data.size());
+    return Status::OK();
+  }
+  Status Close() override { return Status::OK(); }
+  Status Flush() override { return Status::OK(); }
+  Status Sync() override { return Status::OK(); }
+
+  const std::string& contents() const { return contents_; }
+
+ private:
+  std::string contents_;
+};
+
+// Copies into the caller's scratch, like a pread()-backed file.
+class StringSource : public RandomAccessFile {
+ public:
+  explicit StringSource(const std::string& contents) : contents_(contents) {}
+
+  Status Read(uint64_t offset, size_t n, Slice* result,
+              char* scratch) const override {
+    if (offset + n > contents_.size()) {
+      return Status::InvalidArgument("read past end of file");
+    }
+    std::memcpy(scratch, contents_.data() + offset, n);
+    *result = Slice(scratch, n);
+    return Status::OK();
+  }
+
+ private:
+  const std::string contents_;
+};
+
+// Points into its own storage and never touches scratch, like an
+// mmap-backed file.
+class MappedSource : public RandomAccessFile {
+ public:
+  explicit MappedSource(const std::string& contents) : contents_(contents) {}
+
+  Status Read(uint64_t offset, size_t n, Slice* result,
+              char* /*scratch*/) const override {
+    if (offset + n > contents_.size()) {
+      return Status::InvalidArgument("read past end of file");
+    }
+    *result = Slice(contents_.data() + offset, n);
+    return Status::OK();
+  }
+
+  bool Contains(const char* p) const {
+    return p >= contents_.data() && p < contents_.data() + contents_.size();
+  }
+
+ private:
+  const std::string contents_;
+};
+
+std::string Key(int i) {
+  char buf[16];
+  std::snprintf(buf, sizeof(buf), "key%06d", i);
+  return buf;
+}
+
+std::string BuildTable(int n) {
+  Options options;
+  StringSink sink;
+  PlainTableBuilder builder(options, &sink, 0);
+  for (int i = 0; i < n; i++) {
+    builder.Add(Key(i), "value" + std::to_string(i));
+  }
+  EXPECT_TRUE(builder.Finish().ok());
+  EXPECT_EQ(static_cast<uint64_t>(n), builder.NumEntries());
+  EXPECT_EQ(sink.contents().size(), builder.FileSize());
+  return sink.contents();
+}
+
+void CheckTable(const PlainTable* table, int n) {
+  for (int i = 0; i < n; i++) {
+    Slice key, value;
+    bool found;
+    ASSERT_TRUE(table->Get(Key(i), &key, &value, &found).ok());
+    ASSERT_TRUE(found);
+    ASSERT_EQ(Key(i), key.ToString());
+    ASSERT_EQ("value" + std::to_string(i), value.ToString());
+  }
+  Slice key, value;
+  bool found;
+  ASSERT_TRUE(table->Get("missing", &key, &value, &found).ok());
+  ASSERT_FALSE(found);
+
+  std::unique_ptr<Iterator> iter(table->NewIterator());
+  int count = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    ASSERT_EQ(Key(count), iter->key().ToString());
+    count++;
+  }
+  ASSERT_EQ(n, count);
+  iter->Seek(Key(n / 2));
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(Key(n / 2), iter->key().ToString());
+  iter->Prev();
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(Key(n / 2 - 1), iter->key().ToString());
+  iter->SeekToLast();
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ(Key(n - 1), iter->key().ToString());
+  ASSERT_TRUE(iter->status().ok());
+}
+
+}  // namespace
+
+TEST(PlainTable, ReadIntoMemory) {
+  const std::string contents = BuildTable(1000);
+  StringSource source(contents);
+  PlainTable* table;
+  ASSERT_TRUE(
+      PlainTable::Open(Options(), &source, contents.size(), 0, &table).ok());
+  CheckTable(table, 1000);
+  delete table;
+}
+
+TEST(PlainTable, MmapBackedIsNotCopied) {
+  const std::string contents = BuildTable(1000);
+  MappedSource source(contents);
+  PlainTable* table;
+  ASSERT_TRUE(
+      PlainTable::Open(Options(), &source, contents.size(), 0, &table).ok());
+  CheckTable(table, 1000);
+  Slice key, value;
+  bool found;
+  ASSERT_TRUE(table->Get(Key(10), &key, &value, &found).ok());
+  ASSERT_TRUE(found);
+  ASSERT_TRUE(source.Contains(key.data()));
+  ASSERT_TRUE(source.Contains(value.data()));
+  delete table;
+}
+
+TEST(PlainTable, PosixFile) {
+  Env* env = Env::Default();
+  std::string fname;
+  ASSERT_TRUE(env->GetTestDirectory(&fname).ok());
+  fname += "/plain_table_test.tbl";
+  const std::string contents = BuildTable(500);
+  ASSERT_TRUE(WriteStringToFile(env, contents, fname).ok());
+  RandomAccessFile* file;
+  ASSERT_TRUE(env->NewRandomAccessFile(fname, &file).ok());
+  PlainTable* table;
+  ASSERT_TRUE(
+      PlainTable::Open(Options(), file, contents.size(), 0, &table).ok());
+  CheckTable(table, 500);
+  delete table;
+  delete file;
+  ASSERT_TRUE(env->RemoveFile(fname).ok());
+}
+
+TEST(PlainTable, BadFooter) {
+  std::string contents = BuildTable(10);
+  contents[contents.size() - 1] ^= 0x01;
+  StringSource source(contents);
+  PlainTable* table;
+  ASSERT_TRUE(PlainTable::Open(Options(), &source, contents.size(), 0, &table)
+                  .IsCorruption());
+  ASSERT_EQ(nullptr, table);
+
+  StringSource short_source("short");
+  ASSERT_TRUE(PlainTable::Open(Options(), &short_source, 5, 0, &table)
+                  .IsCorruption());
+}
+
+TEST(PlainTable, VersionsShareHashKey) {
+  // With an 8-byte suffix every key below is the same hash key, and Get()
+  // returns the first record at or after the target.
+  Options options;
+  StringSink sink;
+  PlainTableBuilder builder(options, &sink, 8);
+  builder.Add("apple-00000001", "v1");
+  builder.Add("apple-00000002", "v2");
+  builder.Add("apple-00000003", "v3");
+  ASSERT_TRUE(builder.Finish().ok());
+  StringSource source(sink.contents());
+  PlainTable* table;
+  ASSERT_TRUE(PlainTable::Open(options, &source, sink.contents().size(), 8,
+                               &table)
+                  .ok());
+  Slice key, value;
+  bool found;
+  ASSERT_TRUE(table->Get("apple-00000002", &key, &value, &found).ok());
+  ASSERT_TRUE(found);
+  ASSERT_EQ("v2", value.ToString());
+  ASSERT_TRUE(table->Get("apple-00000004", &key, &value, &found).ok());
+  ASSERT_FALSE(found);
+  delete table;
+}
+
+}  // namespace czy_leveldb
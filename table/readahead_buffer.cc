@@ -0,0 +1,73 @@
+#include "table/readahead_buffer.h"
+
+#include <algorithm>
+
+#include "leveldb/env.h"
+
+namespace czy_leveldb {
+
+const size_t ReadaheadBuffer::kInitialReadaheadSize;
+const size_t ReadaheadBuffer::kMaxReadaheadSize;
+
+ReadaheadBuffer::ReadaheadBuffer(RandomAccessFile* file, uint64_t file_size,
+                                 size_t fixed_readahead)
+    : file_(file),
+      file_size_(file_size),
+      fixed_readahead_(fixed_readahead),
+      readahead_size_(kInitialReadaheadSize),
+      num_sequential_reads_(0),
+      prev_read_end_(0),
+      buf_capacity_(0),
+      buffer_offset_(0) {}
+
+Status ReadaheadBuffer::Read(uint64_t offset, size_t n, Slice* result,
+                             char* scratch) {
+  const bool sequential = (offset == prev_read_end_);
+  prev_read_end_ = offset + n;
+
+  if (Buffered(offset, n)) {
+    *result = Slice(buffered_.data() + (offset - buffer_offset_), n);
+    return Status::OK();
+  }
+
+  size_t readahead = 0;
+  if (fixed_readahead_ > 0) {
+    readahead = fixed_readahead_;
+  } else if (sequential) {
+    if (++num_sequential_reads_ >= kSequentialReadsBeforeReadahead) {
+      readahead = readahead_size_;
+      readahead_size_ = std::min(readahead_size_ * 2, kMaxReadaheadSize);
+    }
+  } else {
+    // A seek elsewhere: start detecting from scratch.
+    num_sequential_reads_ = 0;
+    readahead_size_ = kInitialReadaheadSize;
+  }
+
+  if (readahead == 0) {
+    return file_->Read(offset, n, result, scratch);
+  }
+
+  // Reading past the end of an mmap-backed file is an error, so clamp the
+  // window to the file.
+  size_t len = n + readahead;
+  if (offset < file_size_ && len > file_size_ - offset) {
+    len = std::max(n, static_cast<size_t>(file_size_ - offset));
+  }
+  if (buf_capacity_ < len) {
+    buf_.reset(new char[len]);
+    buf_capacity_ = len;
+  }
+  buffer_offset_ = offset;
+  Status s = file_->Read(offset, len, &buffered_, buf_.get());
+  if (!s.ok()) {
+    buffered_ = Slice();
+    return s;
+  }
+  // A short read at the end of the file returns what there is, like
+  // RandomAccessFile::Read() does.
+  *result = Slice(buffered_.data(), std::min(n, buffered_.size()));
+  return Status::OK();
+}
+
+}  // namespace czy_leveldb
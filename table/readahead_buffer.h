@@ -0,0 +1,69 @@
+#pragma once
+// Per-iterator readahead for table scans.  Sits between a table iterator
+// and its RandomAccessFile: once a run of block reads is found to be
+// sequential, each miss reads the requested block plus a readahead window
+// that doubles from kInitialReadaheadSize up to kMaxReadaheadSize, and
+// later blocks are served from that window without another Read().
+//
+// Not thread-safe; each iterator owns its own buffer.
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "leveldb/slice.h"
+#include "leveldb/status.h"
+
+namespace czy_leveldb {
+
+class RandomAccessFile;
+
+class ReadaheadBuffer {
+ public:
+  static const size_t kInitialReadaheadSize = 8 * 1024;
+  static const size_t kMaxReadaheadSize = 256 * 1024;
+
+  // "file" is the table file, of "file_size" bytes.  If "fixed_readahead"
+  // is non-zero every read that misses the buffer reads that many extra
+  // bytes, starting with the first; otherwise readahead kicks in after
+  // kSequentialReadsBeforeReadahead sequential reads.
+  // REQUIRES: "file" outlives this buffer.
+  ReadaheadBuffer(RandomAccessFile* file, uint64_t file_size,
+                  size_t fixed_readahead);
+
+  ReadaheadBuffer(const ReadaheadBuffer&) = delete;
+  ReadaheadBuffer& operator=(const ReadaheadBuffer&) = delete;
+
+  // Same contract as RandomAccessFile::Read().  *result may point into
+  // the buffer, into "scratch", or into memory owned by "file", and stays
+  // valid until the next call.
+  Status Read(uint64_t offset, size_t n, Slice* result, char* scratch);
+
+ private:
+  static const int kSequentialReadsBeforeReadahead = 2;
+
+  bool Buffered(uint64_t offset, size_t n) const {
+    return offset >= buffer_offset_ &&
+           offset + n <= buffer_offset_ + buffered_.size();
+  }
+
+  RandomAccessFile* const file_;
+  const uint64_t file_size_;
+  const size_t fixed_readahead_;
+
+  // Readahead used by the next miss in auto mode.
+  size_t readahead_size_;
+  int num_sequential_reads_;
+  // End offset of the previous read; the next read is sequential if it
+  // starts here.
+  uint64_t prev_read_end_;
+
+  std::unique_ptr<char[]> buf_;
+  size_t buf_capacity_;
+  // File offset of buffered_[0].  buffered_ may point into buf_ or, for
+  // mmap-backed files, directly into the mapping.
+  uint64_t buffer_offset_;
+  Slice buffered_;
+};
+
+}  // namespace czy_leveldb
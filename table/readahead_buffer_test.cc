@@ -0,0 +1,109 @@
+#include "table/readahead_buffer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "leveldb/env.h"
+
+namespace czy_leveldb {
+
+namespace {
+
+// An in-memory file that records the size of every Read().
+class CountingFile : public RandomAccessFile {
+ public:
+  explicit CountingFile(size_t size) {
+    for (size_t i = 0; i < size; i++) {
+      contents_.push_back(static_cast<char>('a' + i % 26));
+    }
+  }
+
+  Status Read(uint64_t offset, size_t n, Slice* result,
+              char* scratch) const override {
+    reads_.push_back(n);
+    if (offset >= contents_.size()) {
+      *result = Slice();
+      return Status::OK();
+    }
+    n = std::min(n, static_cast<size_t>(contents_.size() - offset));
+    std::memcpy(scratch, contents_.data() + offset, n);
+    *result = Slice(scratch, n);
+    return Status::OK();
+  }
+
+  const std::string& contents() const { return contents_; }
+  const std::vector<size_t>& reads() const { return reads_; }
+
+ private:
+  std::string contents_;
+  mutable std::vector<size_t> reads_;
+};
+
+const size_t kBlock = 4096;
+
+}  // namespace
+
+TEST(ReadaheadBuffer, SequentialScanGrowsWindow) {
+  CountingFile file(4 << 20);
+  ReadaheadBuffer buffer(&file, file.contents().size(), 0);
+  char scratch[kBlock];
+  for (uint64_t offset = 0; offset < (2 << 20); offset += kBlock) {
+    Slice result;
+    ASSERT_TRUE(buffer.Read(offset, kBlock, &result, scratch).ok());
+    ASSERT_EQ(file.contents().substr(offset, kBlock), result.ToString());
+  }
+  // Far fewer file reads than blocks, and the window is capped.
+  const std::vector<size_t>& reads = file.reads();
+  ASSERT_LT(reads.size(), (2u << 20) / kBlock / 8);
+  ASSERT_EQ(kBlock, reads[0]);
+  ASSERT_EQ(kBlock + ReadaheadBuffer::kInitialReadaheadSize, reads[1]);
+  ASSERT_EQ(kBlock + 2 * ReadaheadBuffer::kInitialReadaheadSize, reads[2]);
+  ASSERT_EQ(kBlock + ReadaheadBuffer::kMaxReadaheadSize, reads.back());
+}
+
+TEST(ReadaheadBuffer, RandomReadsDoNotReadAhead) {
+  CountingFile file(1 << 20);
+  ReadaheadBuffer buffer(&file, file.contents().size(), 0);
+  char scratch[kBlock];
+  const uint64_t offsets[] = {40 * kBlock, 3 * kBlock, 100 * kBlock,
+                              7 * kBlock, 60 * kBlock};
+  for (uint64_t offset : offsets) {
+    Slice result;
+    ASSERT_TRUE(buffer.Read(offset, kBlock, &result, scratch).ok());
+    ASSERT_EQ(file.contents().substr(offset, kBlock), result.ToString());
+  }
+  for (size_t n : file.reads()) {
+    ASSERT_EQ(kBlock, n);
+  }
+}
+
+TEST(ReadaheadBuffer, FixedReadaheadStartsImmediately) {
+  CountingFile file(1 << 20);
+  ReadaheadBuffer buffer(&file, file.contents().size(), 64 * 1024);
+  char scratch[kBlock];
+  Slice result;
+  ASSERT_TRUE(buffer.Read(0, kBlock, &result, scratch).ok());
+  ASSERT_TRUE(buffer.Read(kBlock, kBlock, &result, scratch).ok());
+  ASSERT_EQ(file.contents().substr(kBlock, kBlock), result.ToString());
+  ASSERT_EQ(1u, file.reads().size());
+  ASSERT_EQ(kBlock + 64 * 1024, file.reads()[0]);
+}
+
+TEST(ReadaheadBuffer, WindowClampedToFileSize) {
+  const size_t file_size = 10 * kBlock + 100;
+  CountingFile file(file_size);
+  ReadaheadBuffer buffer(&file, file_size, 1 << 20);
+  char scratch[kBlock];
+  Slice result;
+  ASSERT_TRUE(buffer.Read(8 * kBlock, kBlock, &result, scratch).ok());
+  ASSERT_EQ(file_size - 8 * kBlock, file.reads()[0]);
+  // The tail of the file is served from the buffer.
+  ASSERT_TRUE(buffer.Read(10 * kBlock, 100, &result, scratch).ok());
+  ASSERT_EQ(file.contents().substr(10 * kBlock), result.ToString());
+  ASSERT_EQ(1u, file.reads().size());
+}
+
+}  // namespace czy_leveldb
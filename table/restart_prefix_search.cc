@@ -0,0 +1,126 @@
+#include "table/restart_prefix_search.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#define LEVELDB_RESTART_PREFIX_SSE42 1
+#else
+#define LEVELDB_RESTART_PREFIX_SSE42 0
+#endif
+
+#include "db/dbformat.h"
+#include "util/coding.h"
+
+namespace czy_leveldb {
+
+namespace {
+
+// Binary search narrows the candidates down to this many prefixes before
+// they are counted with a straight (vectorizable) scan.
+const uint32_t kScanWindow = 16;
+
+inline uint64_t PrefixAt(const char* prefixes, uint32_t index) {
+  return DecodeFixed64(prefixes + index * kRestartPrefixSize);
+}
+
+// Return the number of prefixes in [begin, end) that are less than
+// "target", or not greater than it if "inclusive" is set.
+// REQUIRES: the prefixes in [begin, end) are sorted.
+uint32_t CountBelowPortable(const char* prefixes, uint32_t begin,
+                            uint32_t end, uint64_t target, bool inclusive) {
+  uint32_t count = 0;
+  for (uint32_t i = begin; i < end; ++i) {
+    const uint64_t p = PrefixAt(prefixes, i);
+    count += inclusive ? (p <= target) : (p < target);
+  }
+  return count;
+}
+
+#if LEVELDB_RESTART_PREFIX_SSE42
+
+__attribute__((target("sse4.2"))) uint32_t CountBelowSse42(
+    const char* prefixes, uint32_t begin, uint32_t end, uint64_t target,
+    bool inclusive) {
+  uint32_t count = 0;
+  uint32_t i = begin;
+  // The prefixes are stored little-endian, so two of them load straight
+  // into a vector.  x86 has no unsigned 64-bit compare; flipping the sign
+  // bit of both sides turns the signed compare into an unsigned one.
+  const __m128i sign = _mm_set1_epi64x(static_cast<long long>(1ULL << 63));
+  const __m128i t = _mm_xor_si128(
+      _mm_set1_epi64x(static_cast<long long>(target)), sign);
+  for (; i + 2 <= end; i += 2) {
+    const __m128i p = _mm_xor_si128(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+            prefixes + i * kRestartPrefixSize)),
+        sign);
+    if (inclusive) {
+      // p <= t  <=>  !(p > t)
+      const int gt = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(p, t)));
+      count += 2 - __builtin_popcount(gt);
+    } else {
+      const int lt = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(t, p)));
+      count += __builtin_popcount(lt);
+    }
+  }
+  return count + CountBelowPortable(prefixes, i, end, target, inclusive);
+}
+
+#endif  // LEVELDB_RESTART_PREFIX_SSE42
+
+typedef uint32_t (*CountBelowFunction)(const char*, uint32_t, uint32_t,
+                                       uint64_t, bool);
+
+// Pick the scan at run time, so builds for generic x86-64 still use
+// SSE4.2 where the CPU has it.
+CountBelowFunction ChooseCountBelow() {
+#if LEVELDB_RESTART_PREFIX_SSE42
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("sse4.2")) {
+    return CountBelowSse42;
+  }
+#endif  // LEVELDB_RESTART_PREFIX_SSE42
+  return CountBelowPortable;
+}
+
+uint32_t PrefixBound(const char* prefixes, uint32_t num_restarts,
+                     uint64_t target, bool inclusive) {
+  static const CountBelowFunction count_below = ChooseCountBelow();
+  uint32_t begin = 0;
+  uint32_t end = num_restarts;
+  while (end - begin > kScanWindow) {
+    const uint32_t mid = begin + (end - begin) / 2;
+    const uint64_t p = PrefixAt(prefixes, mid);
+    if (inclusive ? (p <= target) : (p < target)) {
+      begin = mid + 1;
+    } else {
+      end = mid;
+    }
+  }
+  return begin + count_below(prefixes, begin, end, target, inclusive);
+}
+
+}  // namespace
+
+uint64_t RestartKeyPrefix(const Slice& internal_key) {
+  const Slice user_key = ExtractUserKey(internal_key);
+  uint64_t prefix = 0;
+  const size_t n = user_key.size() < kRestartPrefixSize ? user_key.size()
+                                                        : kRestartPrefixSize;
+  for (size_t i = 0; i < kRestartPrefixSize; i++) {
+    prefix <<= 8;
+    if (i < n) {
+      prefix |= static_cast<uint8_t>(user_key[i]);
+    }
+  }
+  return prefix;
+}
+
+void SearchRestartPrefixes(const char* prefixes, uint32_t num_restarts,
+                           uint64_t target_prefix, uint32_t* left,
+                           uint32_t* right) {
+  *left = PrefixBound(prefixes, num_restarts, target_prefix, false);
+  *right = *left + PrefixBound(prefixes + *left * kRestartPrefixSize,
+                               num_restarts - *left, target_prefix, true);
+}
+
+}  // namespace czy_leveldb
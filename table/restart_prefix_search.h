@@ -0,0 +1,47 @@
+#pragma once
+// Optional array of fixed-width key prefixes stored after a data block's
+// restart array, one per restart point:
+//
+//    entries...
+//    restarts:  uint32[num_restarts]
+//    prefixes:  fixed64[num_restarts]
+//    [hash index, see table/data_block_hash_index.h]
+//    footer:    uint32 (num_restarts | flags)
+//
+// Each prefix is the first 8 bytes of the restart key's user key read as a
+// big-endian integer (shorter user keys are zero padded), so comparing two
+// prefixes as unsigned integers gives the same order as a bytewise
+// comparison of the user keys' first 8 bytes.  The sequence number and
+// type tag of the internal key are left out: they sort by decreasing
+// sequence number and would break that order for short user keys.  A
+// seek can then locate its restart interval with integer comparisons,
+// which are vectorized where the CPU allows, and only fall back to the
+// full comparator for restart points whose prefix equals the target's.
+// Only valid for BytewiseComparator().
+
+#include <cstdint>
+
+#include "leveldb/slice.h"
+
+namespace czy_leveldb {
+
+// Set in the block footer when the prefix array is present.
+const uint32_t kRestartPrefixFlag = 1u << 30;
+
+const size_t kRestartPrefixSize = sizeof(uint64_t);
+
+// Return the ordering prefix of "internal_key", a restart key or a seek
+// target.
+uint64_t RestartKeyPrefix(const Slice& internal_key);
+
+// "prefixes" points at "num_restarts" encoded prefixes in restart order.
+// Sets *left to the number of restart points whose prefix is less than
+// "target_prefix" and *right to the number whose prefix is less than or
+// equal to it.  Every restart key before *left then sorts before the
+// target, every restart key from *right on sorts after it, and only the
+// restart points in [*left, *right) need a full key comparison.
+void SearchRestartPrefixes(const char* prefixes, uint32_t num_restarts,
+                           uint64_t target_prefix, uint32_t* left,
+                           uint32_t* right);
+
+}  // namespace czy_leveldb
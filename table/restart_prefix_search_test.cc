@@ -0,0 +1,113 @@
+#include "table/restart_prefix_search.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "util/coding.h"
+
+namespace czy_leveldb {
+
+namespace {
+
+std::string IKey(const std::string& user_key, uint64_t seq) {
+  std::string result = user_key;
+  PutFixed64(&result, (seq << 8) | 1);  // kTypeValue
+  return result;
+}
+
+// Internal key order: increasing user key, decreasing sequence number.
+int CompareIKeys(const std::string& a, const std::string& b) {
+  const Slice ua(a.data(), a.size() - 8);
+  const Slice ub(b.data(), b.size() - 8);
+  int r = ua.compare(ub);
+  if (r == 0) {
+    const uint64_t na = DecodeFixed64(a.data() + a.size() - 8);
+    const uint64_t nb = DecodeFixed64(b.data() + b.size() - 8);
+    r = (na > nb) ? -1 : (na < nb) ? +1 : 0;
+  }
+  return r;
+}
+
+// Check that every restart key before *left sorts before "target" and
+// every one from *right on after it.
+void CheckSearch(const std::vector<std::string>& restarts,
+                 const std::string& target) {
+  std::string prefixes;
+  for (const std::string& key : restarts) {
+    PutFixed64(&prefixes, RestartKeyPrefix(key));
+  }
+  uint32_t left, right;
+  SearchRestartPrefixes(prefixes.data(),
+                        static_cast<uint32_t>(restarts.size()),
+                        RestartKeyPrefix(target), &left, &right);
+  ASSERT_LE(left, right);
+  ASSERT_LE(right, restarts.size());
+  for (uint32_t i = 0; i < left; i++) {
+    ASSERT_LT(CompareIKeys(restarts[i], target), 0) << i;
+  }
+  for (uint32_t i = right; i < restarts.size(); i++) {
+    ASSERT_GT(CompareIKeys(restarts[i], target), 0) << i;
+  }
+}
+
+}  // namespace
+
+TEST(RestartPrefixSearch, PrefixIgnoresTag) {
+  // "a" with any tag must not sort after "ab", whatever the sequence.
+  ASSERT_LT(RestartKeyPrefix(IKey("a", 1)), RestartKeyPrefix(IKey("ab", 1)));
+  ASSERT_LT(RestartKeyPrefix(IKey("a", 0xffffff)),
+            RestartKeyPrefix(IKey("ab", 1)));
+  ASSERT_EQ(RestartKeyPrefix(IKey("abc", 1)),
+            RestartKeyPrefix(IKey("abc", 100)));
+  ASSERT_EQ(RestartKeyPrefix(IKey("abcdefgh", 1)),
+            RestartKeyPrefix(IKey("abcdefghij", 1)));
+  ASSERT_EQ(0u, RestartKeyPrefix(IKey("", 7)));
+}
+
+TEST(RestartPrefixSearch, ShortKeysAndVersions) {
+  std::vector<std::string> restarts = {
+      IKey("a", 9),          IKey("a", 3),    IKey(std::string("a\0", 2), 5),
+      IKey("ab", 8),         IKey("b", 20),   IKey("b", 10),
+      IKey("b", 1),          IKey("bcdefghij", 4), IKey("bcdefghik", 4),
+      IKey("c", 2)};
+  for (const char* user_key : {"", "a", "ab", "aa", "b", "bc", "bcdefghij",
+                               "bcdefghijk", "c", "d"}) {
+    for (uint64_t seq : {0ull, 1ull, 4ull, 5ull, 9ull, 15ull, 100ull}) {
+      CheckSearch(restarts, IKey(user_key, seq));
+    }
+  }
+}
+
+TEST(RestartPrefixSearch, Random) {
+  std::mt19937 rnd(301);
+  for (int iter = 0; iter < 20; iter++) {
+    std::vector<std::string> restarts;
+    const int n = 1 + rnd() % 300;
+    for (int i = 0; i < n; i++) {
+      // Short keys from a small alphabet, so prefixes tie often.
+      std::string user_key(rnd() % 12, 'a');
+      for (char& c : user_key) {
+        c = static_cast<char>('a' + rnd() % 3);
+      }
+      restarts.push_back(IKey(user_key, rnd() % 1000));
+    }
+    std::sort(restarts.begin(), restarts.end(),
+              [](const std::string& a, const std::string& b) {
+                return CompareIKeys(a, b) < 0;
+              });
+    restarts.erase(std::unique(restarts.begin(), restarts.end()),
+                   restarts.end());
+    for (int i = 0; i < 50; i++) {
+      std::string user_key(rnd() % 12, 'a');
+      for (char& c : user_key) {
+        c = static_cast<char>('a' + rnd() % 3);
+      }
+      CheckSearch(restarts, IKey(user_key, rnd() % 1000));
+    }
+  }
+}
+
+}  // namespace czy_leveldb
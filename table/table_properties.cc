@@ -0,0 +1,123 @@
+#include "leveldb/table_properties.h"
+
+#include <cinttypes>
+#include <cstdio>
+
+#include "db/dbformat.h"
+#include "table/table_properties_builder.h"
+#include "util/coding.h"
+
+namespace czy_leveldb {
+
+const char kPropertiesBlockName[] = "leveldb.properties";
+
+namespace {
+
+// Every property is stored as a length-prefixed name followed by a
+// varint64 value, so readers can skip names they do not know.
+struct PropertyField {
+  const char* name;
+  uint64_t TableProperties::*field;
+};
+
+const PropertyField kPropertyFields[] = {
+    {"leveldb.num.entries", &TableProperties::num_entries},
+    {"leveldb.num.deletions", &TableProperties::num_deletions},
+    {"leveldb.num.range-deletions", &TableProperties::num_range_deletions},
+    {"leveldb.raw.key.size", &TableProperties::raw_key_size},
+    {"leveldb.raw.value.size", &TableProperties::raw_value_size},
+    {"leveldb.data.size", &TableProperties::data_size},
+    {"leveldb.index.size", &TableProperties::index_size},
+    {"leveldb.filter.size", &TableProperties::filter_size},
+    {"leveldb.num.data.blocks", &TableProperties::num_data_blocks},
+    {"leveldb.smallest.seqno", &TableProperties::smallest_seqno},
+    {"leveldb.largest.seqno", &TableProperties::largest_seqno},
+    {"leveldb.creation.time", &TableProperties::creation_time},
+};
+
+}  // namespace
+
+void TableProperties::Add(const TableProperties& other) {
+  const bool had_entries = num_entries > 0;
+  num_entries += other.num_entries;
+  num_deletions += other.num_deletions;
+  num_range_deletions += other.num_range_deletions;
+  raw_key_size += other.raw_key_size;
+  raw_value_size += other.raw_value_size;
+  data_size += other.data_size;
+  index_size += other.index_size;
+  filter_size += other.filter_size;
+  num_data_blocks += other.num_data_blocks;
+  if (other.num_entries > 0) {
+    if (!had_entries || other.smallest_seqno < smallest_seqno) {
+      smallest_seqno = other.smallest_seqno;
+    }
+    if (!had_entries || other.largest_seqno > largest_seqno) {
+      largest_seqno = other.largest_seqno;
+    }
+  }
+  if (other.creation_time != 0 &&
+      (creation_time == 0 || other.creation_time < creation_time)) {
+    creation_time = other.creation_time;
+  }
+}
+
+void TableProperties::EncodeTo(std::string* dst) const {
+  for (const PropertyField& p : kPropertyFields) {
+    PutLengthPrefixedSlice(dst, p.name);
+    PutVarint64(dst, this->*p.field);
+  }
+}
+
+Status TableProperties::DecodeFrom(const Slice& input) {
+  Slice in = input;
+  Slice name;
+  uint64_t value;
+  while (!in.empty()) {
+    if (!GetLengthPrefixedSlice(&in, &name) || !GetVarint64(&in, &value)) {
+      return Status::Corruption("bad table properties block");
+    }
+    for (const PropertyField& p : kPropertyFields) {
+      if (name == Slice(p.name)) {
+        this->*p.field = value;
+        break;
+      }
+    }
+  }
+  return Status::OK();
+}
+
+std::string TableProperties::ToString() const {
+  std::string result;
+  char buf[100];
+  for (const PropertyField& p : kPropertyFields) {
+    std::snprintf(buf, sizeof(buf), "%s=%" PRIu64 "\n", p.name,
+                  this->*p.field);
+    result.append(buf);
+  }
+  return result;
+}
+
+void TablePropertiesBuilder::Add(const Slice& key, const Slice& value) {
+  props_.num_entries++;
+  props_.raw_value_size += value.size();
+
+  ParsedInternalKey ikey;
+  if (!keys_are_internal_ || !ParseInternalKey(key, &ikey)) {
+    props_.raw_key_size += key.size();
+    return;
+  }
+  props_.raw_key_size += ikey.user_key.size();
+  if (ikey.type == kTypeDeletion) {
+    props_.num_deletions++;
+  }
+  if (!seqno_seen_ || ikey.sequence < props_.smallest_seqno) {
+    props_.smallest_seqno = ikey.sequence;
+  }
+  if (!seqno_seen_ || ikey.sequence > props_.largest_seqno) {
+    props_.largest_seqno = ikey.sequence;
+  }
+  seqno_seen_ = true;
+}
+
+}  // namespace czy_leveldb
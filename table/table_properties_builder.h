@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+
+#include "leveldb/slice.h"
+#include "leveldb/table_properties.h"
+
+namespace czy_leveldb {
+
+// Gathers TableProperties while a table is built.  TableBuilder calls
+// Add() for every entry and fills in the block sizes itself before
+// writing the properties meta block in Finish().
+class TablePropertiesBuilder {
+ public:
+  // "keys_are_internal" is true when the table is ordered by an
+  // InternalKeyComparator, as every table the DB writes is; the sequence
+  // number and deletion marker are then taken from each key's tag.
+  // Tables built directly by a client with a user comparator pass false,
+  // and their keys only contribute to the size counters.
+  explicit TablePropertiesBuilder(bool keys_are_internal)
+      : keys_are_internal_(keys_are_internal), seqno_seen_(false) {}
+
+  TablePropertiesBuilder(const TablePropertiesBuilder&) = delete;
+  TablePropertiesBuilder& operator=(const TablePropertiesBuilder&) = delete;
+
+  void Add(const Slice& key, const Slice& value);
+
+  TableProperties* properties() { return &props_; }
+
+ private:
+  const bool keys_are_internal_;
+  TableProperties props_;
+  bool seqno_seen_;
+};
+
+}  // namespace czy_leveldb
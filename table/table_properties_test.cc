@@ -0,0 +1,94 @@
+#include "leveldb/table_properties.h"
+
+#include <string>
+
+#include "db/dbformat.h"
+#include "gtest/gtest.h"
+#include "table/table_properties_builder.h"
+#include "util/coding.h"
+
+namespace czy_leveldb {
+
+namespace {
+
+std::string IKey(const std::string& user_key, uint64_t seq, ValueType vt) {
+  std::string encoded;
+  AppendInternalKey(&encoded, ParsedInternalKey(user_key, seq, vt));
+  return encoded;
+}
+
+}  // namespace
+
+TEST(TableProperties, BuilderWithInternalKeys) {
+  TablePropertiesBuilder builder(true);
+  builder.Add(IKey("apple", 20, kTypeValue), "red");
+  builder.Add(IKey("banana", 7, kTypeDeletion), "");
+  builder.Add(IKey("cherry", 31, kTypeValue), "dark");
+  const TableProperties& props = *builder.properties();
+  ASSERT_EQ(3u, props.num_entries);
+  ASSERT_EQ(1u, props.num_deletions);
+  ASSERT_EQ(5u + 6 + 6, props.raw_key_size);
+  ASSERT_EQ(7u, props.raw_value_size);
+  ASSERT_EQ(7u, props.smallest_seqno);
+  ASSERT_EQ(31u, props.largest_seqno);
+}
+
+TEST(TableProperties, BuilderWithUserKeys) {
+  // Eight or more bytes of user key can parse as an internal key; with a
+  // user comparator the builder must not try.
+  TablePropertiesBuilder builder(false);
+  const std::string key("user-key\x00\x01\x00\x00\x00\x00\x00\x00", 16);
+  builder.Add(key, "value");
+  const TableProperties& props = *builder.properties();
+  ASSERT_EQ(1u, props.num_entries);
+  ASSERT_EQ(0u, props.num_deletions);
+  ASSERT_EQ(16u, props.raw_key_size);
+  ASSERT_EQ(0u, props.smallest_seqno);
+  ASSERT_EQ(0u, props.largest_seqno);
+}
+
+TEST(TableProperties, EncodeDecode) {
+  TableProperties props;
+  props.num_entries = 100;
+  props.num_deletions = 3;
+  props.raw_key_size = 1234;
+  props.data_size = 1ull << 40;
+  props.largest_seqno = 99;
+  props.creation_time = 1700000000;
+  std::string encoded;
+  props.EncodeTo(&encoded);
+
+  // An unknown property written by a newer version is skipped.
+  PutLengthPrefixedSlice(&encoded, "leveldb.from.the.future");
+  PutVarint64(&encoded, 42);
+
+  TableProperties decoded;
+  ASSERT_TRUE(decoded.DecodeFrom(encoded).ok());
+  ASSERT_EQ(props.ToString(), decoded.ToString());
+
+  encoded.resize(encoded.size() - 1);
+  ASSERT_TRUE(TableProperties().DecodeFrom(encoded).IsCorruption());
+}
+
+TEST(TableProperties, Aggregate) {
+  TableProperties a, b, total;
+  a.num_entries = 10;
+  a.smallest_seqno = 5;
+  a.largest_seqno = 50;
+  a.creation_time = 2000;
+  b.num_entries = 4;
+  b.smallest_seqno = 60;
+  b.largest_seqno = 70;
+  b.creation_time = 1000;
+  total.Add(a);
+  total.Add(b);
+  total.Add(TableProperties());  // An empty table changes nothing.
+  ASSERT_EQ(14u, total.num_entries);
+  ASSERT_EQ(5u, total.smallest_seqno);
+  ASSERT_EQ(70u, total.largest_seqno);
+  ASSERT_EQ(1000u, total.creation_time);
+  ASSERT_NE(std::string::npos,
+            total.ToString().find("leveldb.num.entries=14\n"));
+}
+
+}  // namespace czy_leveldb
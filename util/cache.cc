@@ -0,0 +1,7 @@
+#include "leveldb/cache.h"
+
+namespace czy_leveldb {
+
+Cache::~Cache() {}
+
+}  // namespace czy_leveldb
@@ -0,0 +1,160 @@
+#include "util/concurrent_arena.h"
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <thread>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/mman.h>
+#endif
+
+#include "port/port.h"
+
+namespace czy_leveldb {
+
+namespace {
+
+const size_t kAlign = alignof(std::max_align_t);
+
+size_t AlignUp(size_t n, size_t align) {
+  return (n + align - 1) & ~(align - 1);
+}
+
+char* AlignPointer(char* p, size_t align) {
+  return reinterpret_cast<char*>(
+      AlignUp(reinterpret_cast<uintptr_t>(p), align));
+}
+
+}  // namespace
+
+const size_t ConcurrentArena::kCacheLineSize;
+const size_t ConcurrentArena::kDefaultBlockSize;
+const size_t ConcurrentArena::kShardStride;
+
+ConcurrentArena::ConcurrentArena(size_t block_size, size_t huge_page_size)
+    : huge_page_size_(huge_page_size),
+      block_size_(AlignUp(block_size, kCacheLineSize)),
+      huge_block_size_(huge_page_size > 0 ? AlignUp(block_size, huge_page_size)
+                                          : 0),
+      memory_usage_(0),
+      huge_page_usage_(0),
+      huge_pages_unavailable_(false) {
+  size_t cores = std::thread::hardware_concurrency();
+  size_t num_shards = 1;
+  while (num_shards < cores) {
+    num_shards <<= 1;
+  }
+  shard_mask_ = num_shards - 1;
+  shard_mem_ = new char[num_shards * kShardStride + kCacheLineSize];
+  shards_ = AlignPointer(shard_mem_, kCacheLineSize);
+  for (size_t i = 0; i < num_shards; i++) {
+    new (shards_ + i * kShardStride) Shard();
+  }
+}
+
+ConcurrentArena::~ConcurrentArena() {
+  for (size_t i = 0; i <= shard_mask_; i++) {
+    reinterpret_cast<Shard*>(shards_ + i * kShardStride)->~Shard();
+  }
+  delete[] shard_mem_;
+  for (char* block : blocks_) {
+    delete[] block;
+  }
+#if defined(__linux__)
+  for (const auto& block : huge_blocks_) {
+    munmap(block.first, block.second);
+  }
+#endif
+}
+
+int ConcurrentArena::CurrentCpu() {
+#if defined(__linux__)
+  return sched_getcpu();
+#else
+  return -1;
+#endif
+}
+
+ConcurrentArena::Shard* ConcurrentArena::ShardForCpu(int cpu) {
+  size_t index;
+  if (cpu >= 0) {
+    index = static_cast<size_t>(cpu);
+  } else {
+    index = std::hash<std::thread::id>()(std::this_thread::get_id());
+  }
+  return reinterpret_cast<Shard*>(shards_ + (index & shard_mask_) * kShardStride);
+}
+
+char* ConcurrentArena::NewBlock(size_t bytes) {
+  char* raw = new char[bytes + kCacheLineSize];
+  memory_usage_.fetch_add(bytes + kCacheLineSize, std::memory_order_relaxed);
+  std::lock_guard<std::mutex> l(blocks_mu_);
+  blocks_.push_back(raw);
+  return AlignPointer(raw, kCacheLineSize);
+}
+
+char* ConcurrentArena::NewHugePageBlock(size_t bytes, int cpu) {
+#if defined(__linux__) && defined(MAP_HUGETLB)
+  void* addr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  if (addr == MAP_FAILED) {
+    // Most likely no huge pages are reserved (see /proc/sys/vm/nr_hugepages).
+    // Do not pay for a failing mmap on every later block; the next arena
+    // (i.e. the next memtable) tries again.
+    huge_pages_unavailable_.store(true, std::memory_order_relaxed);
+    return nullptr;
+  }
+  // Bind before the first touch so the pages are faulted in on the node
+  // of the core whose shard will write them.  Without NUMA support the
+  // kernel's first-touch policy places them on that node anyway, as long
+  // as the thread has not migrated in between.
+  port::BindToNumaNodeOfCpu(addr, bytes, cpu);
+  memory_usage_.fetch_add(bytes, std::memory_order_relaxed);
+  huge_page_usage_.fetch_add(bytes, std::memory_order_relaxed);
+  std::lock_guard<std::mutex> l(blocks_mu_);
+  huge_blocks_.emplace_back(static_cast<char*>(addr), bytes);
+  return static_cast<char*>(addr);
+#else
+  // Silence compiler warnings about unused arguments.
+  (void)bytes;
+  (void)cpu;
+  return nullptr;
+#endif
+}
+
+char* ConcurrentArena::AllocateAligned(size_t bytes) {
+  assert(bytes > 0);
+  bytes = AlignUp(bytes, kAlign);
+  if (bytes > block_size_ / 4) {
+    // Large entries get a block of their own so they do not waste the
+    // rest of a shard's block.
+    return NewBlock(bytes);
+  }
+
+  const int cpu = CurrentCpu();
+  Shard* shard = ShardForCpu(cpu);
+  std::lock_guard<std::mutex> l(shard->mu);
+  if (bytes > shard->remaining) {
+    char* block = nullptr;
+    if (huge_page_size_ > 0 &&
+        !huge_pages_unavailable_.load(std::memory_order_relaxed)) {
+      block = NewHugePageBlock(huge_block_size_, cpu);
+    }
+    if (block != nullptr) {
+      shard->ptr = block;
+      shard->remaining = huge_block_size_;
+    } else {
+      shard->ptr = NewBlock(block_size_);
+      shard->remaining = block_size_;
+    }
+  }
+  char* result = shard->ptr;
+  shard->ptr += bytes;
+  shard->remaining -= bytes;
+  return result;
+}
+
+}  // namespace czy_leveldb
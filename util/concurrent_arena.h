@@ -0,0 +1,96 @@
+#pragma once
+// An arena that many threads can allocate from at once.  Each CPU core
+// gets its own shard with its own current block, so concurrent memtable
+// inserts neither contend on one lock nor place nodes written by
+// different cores in the same cache line.
+//
+// Optionally, shard blocks are backed by huge pages (MAP_HUGETLB), which
+// cuts the TLB misses of random skip list traversals over a large
+// memtable, and bound to the NUMA node of the core that writes them.  If
+// no huge pages are reserved the arena silently falls back to ordinary
+// blocks, and stops asking for huge pages after the first failure.
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace czy_leveldb {
+
+class ConcurrentArena {
+ public:
+  static const size_t kCacheLineSize = 64;
+  static const size_t kDefaultBlockSize = 32 * 1024;
+
+  // Shards carve "block_size" byte blocks.  If "huge_page_size" is
+  // non-zero, shard blocks are instead "block_size" rounded up to a
+  // multiple of it and mapped from huge pages of that size (a power of
+  // two, e.g. 2MB) while such pages can be had.  Once a mapping fails,
+  // shards go back to "block_size" byte blocks for the rest of the
+  // arena's life.
+  explicit ConcurrentArena(size_t block_size = kDefaultBlockSize,
+                           size_t huge_page_size = 0);
+
+  ConcurrentArena(const ConcurrentArena&) = delete;
+  ConcurrentArena& operator=(const ConcurrentArena&) = delete;
+
+  ~ConcurrentArena();
+
+  // Return a pointer to "bytes" bytes aligned for any fundamental type.
+  // Thread-safe.
+  char* AllocateAligned(size_t bytes);
+
+  // Bytes of memory allocated by the arena, including unused block tails.
+  // Thread-safe.
+  size_t MemoryUsage() const {
+    return memory_usage_.load(std::memory_order_relaxed);
+  }
+
+  // The part of MemoryUsage() that is backed by huge pages.  Thread-safe.
+  size_t HugePageUsage() const {
+    return huge_page_usage_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Shard {
+    std::mutex mu;
+    char* ptr = nullptr;
+    size_t remaining = 0;
+  };
+  // Shards are padded to whole cache lines so neighbouring shards never
+  // share one.
+  static const size_t kShardStride =
+      (sizeof(Shard) + kCacheLineSize - 1) / kCacheLineSize * kCacheLineSize;
+
+  // The CPU the calling thread runs on, or -1 if unknown.
+  static int CurrentCpu();
+
+  // The shard of "cpu", or of the calling thread if "cpu" is -1.
+  Shard* ShardForCpu(int cpu);
+  // Allocate a new cache-line aligned block of "bytes" bytes.
+  char* NewBlock(size_t bytes);
+  // Map a block of "bytes" bytes, a multiple of huge_page_size_, from
+  // huge pages local to "cpu".  Returns nullptr if none are available.
+  // REQUIRES: huge_page_size_ is a power of two.
+  char* NewHugePageBlock(size_t bytes, int cpu);
+
+  const size_t huge_page_size_;
+  // Size of ordinary blocks: shard blocks when huge pages are off or
+  // unavailable.
+  const size_t block_size_;
+  // Size of shard blocks mapped from huge pages, or 0.
+  const size_t huge_block_size_;
+  size_t shard_mask_;
+  char* shard_mem_;  // Raw storage for the shards
+  char* shards_;     // First shard, cache-line aligned inside shard_mem_
+
+  std::mutex blocks_mu_;
+  std::vector<char*> blocks_;
+  std::vector<std::pair<char*, size_t>> huge_blocks_;  // Mapped address, size
+  std::atomic<size_t> memory_usage_;
+  std::atomic<size_t> huge_page_usage_;
+  std::atomic<bool> huge_pages_unavailable_;
+};
+
+}  // namespace czy_leveldb
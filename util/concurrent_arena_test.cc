@@ -0,0 +1,168 @@
+#include "util/concurrent_arena.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace czy_leveldb {
+
+namespace {
+
+const size_t kHugePageSize = 2 << 20;
+
+// Number of free huge pages of the default size, 0 if unknown.
+size_t FreeHugePages() {
+  std::ifstream meminfo("/proc/meminfo");
+  std::string line;
+  while (std::getline(meminfo, line)) {
+    if (line.compare(0, 15, "HugePages_Free:") == 0) {
+      return std::stoul(line.substr(15));
+    }
+  }
+  return 0;
+}
+
+bool IsAligned(const char* p) {
+  return reinterpret_cast<uintptr_t>(p) % alignof(std::max_align_t) == 0;
+}
+
+}  // namespace
+
+TEST(ConcurrentArenaTest, Empty) {
+  ConcurrentArena arena;
+  ASSERT_EQ(0u, arena.MemoryUsage());
+  ASSERT_EQ(0u, arena.HugePageUsage());
+}
+
+TEST(ConcurrentArenaTest, Simple) {
+  ConcurrentArena arena(4096);
+  std::vector<std::pair<size_t, char*>> allocated;
+  size_t bytes = 0;
+  for (int i = 0; i < 2000; i++) {
+    size_t s = (i % 100 == 0) ? 3000 : 1 + i % 97;  // Some own a block
+    char* r = arena.AllocateAligned(s);
+    ASSERT_TRUE(IsAligned(r));
+    // Fill the "i"th allocation with a known bit pattern.
+    std::memset(r, i % 256, s);
+    bytes += s;
+    allocated.emplace_back(s, r);
+    ASSERT_GE(arena.MemoryUsage(), bytes);
+  }
+  for (size_t i = 0; i < allocated.size(); i++) {
+    const char* p = allocated[i].second;
+    for (size_t b = 0; b < allocated[i].first; b++) {
+      // Check the "i"th allocation for the known bit pattern.
+      ASSERT_EQ(int(p[b]) & 0xff, int(i % 256));
+    }
+  }
+  ASSERT_EQ(0u, arena.HugePageUsage());
+}
+
+// Allocations made from many threads at once never overlap.
+TEST(ConcurrentArenaTest, ConcurrentAllocations) {
+  const int kThreads = 8;
+  const int kAllocsPerThread = 5000;
+  ConcurrentArena arena(8192);
+  std::vector<std::vector<std::pair<char*, size_t>>> results(kThreads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; t++) {
+    threads.emplace_back([&arena, &results, t]() {
+      for (int i = 0; i < kAllocsPerThread; i++) {
+        const size_t s = 8 + (i * 7 + t) % 120;
+        char* r = arena.AllocateAligned(s);
+        std::memset(r, t, s);
+        results[t].emplace_back(r, s);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  std::vector<std::pair<char*, size_t>> all;
+  for (int t = 0; t < kThreads; t++) {
+    for (const auto& r : results[t]) {
+      ASSERT_TRUE(IsAligned(r.first));
+      for (size_t b = 0; b < r.second; b++) {
+        ASSERT_EQ(t, r.first[b]);
+      }
+      all.push_back(r);
+    }
+  }
+  std::sort(all.begin(), all.end());
+  for (size_t i = 1; i < all.size(); i++) {
+    ASSERT_LE(all[i - 1].first + all[i - 1].second, all[i].first);
+  }
+}
+
+// With huge pages requested but none reserved, the arena falls back to
+// ordinary blocks instead of failing.
+TEST(ConcurrentArenaTest, HugePageFallback) {
+  ConcurrentArena arena(4096, kHugePageSize);
+  std::vector<char*> allocated;
+  for (int i = 0; i < 100; i++) {
+    char* r = arena.AllocateAligned(1000);
+    ASSERT_TRUE(IsAligned(r));
+    std::memset(r, 0xab, 1000);
+    allocated.push_back(r);
+  }
+  ASSERT_GE(arena.MemoryUsage(), 100 * 1000u);
+  ASSERT_LE(arena.HugePageUsage(), arena.MemoryUsage());
+  if (FreeHugePages() == 0) {
+    ASSERT_EQ(0u, arena.HugePageUsage());
+  }
+  // Large entries always get an ordinary block of their own.
+  const size_t before = arena.HugePageUsage();
+  char* big = arena.AllocateAligned(kHugePageSize);
+  std::memset(big, 0xcd, kHugePageSize);
+  ASSERT_EQ(before, arena.HugePageUsage());
+  for (char* r : allocated) {
+    ASSERT_EQ(char(0xab), r[999]);
+  }
+}
+
+// Once huge pages turn out to be unavailable, shards fall back to blocks
+// of the requested size, not of the huge page size, so a memtable does not
+// reach its write buffer size after a handful of entries.
+TEST(ConcurrentArenaTest, HugePageFallbackKeepsBlockSize) {
+  if (FreeHugePages() != 0) {
+    GTEST_SKIP() << "huge pages are reserved on this machine";
+  }
+  const size_t kBlockSize = 4096;
+  ConcurrentArena arena(kBlockSize, kHugePageSize);
+  const int kThreads = 8;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; t++) {
+    threads.emplace_back([&arena] {
+      for (int i = 0; i < 10; i++) {
+        std::memset(arena.AllocateAligned(100), 0xef, 100);
+      }
+    });
+  }
+  for (std::thread& t : threads) {
+    t.join();
+  }
+  ASSERT_EQ(0u, arena.HugePageUsage());
+  // At most one block per shard, plus the few extra blocks needed if
+  // every thread landed on the same shard.  With huge page sized blocks
+  // this would be at least 2MB.
+  size_t shards = 1;
+  while (shards < std::thread::hardware_concurrency()) {
+    shards <<= 1;
+  }
+  const size_t total = kThreads * 10 * 112;  // 100 bytes align up to 112
+  ASSERT_GT(arena.MemoryUsage(), 0u);
+  ASSERT_LE(arena.MemoryUsage(), (shards + total / kBlockSize + 1) *
+                                     (kBlockSize +
+                                      ConcurrentArena::kCacheLineSize));
+}
+
+}  // namespace czy_leveldb
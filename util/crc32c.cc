@@ -0,0 +1,252 @@
+#include "util/crc32c.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#define LEVELDB_CRC32C_SSE42 1
+#else
+#define LEVELDB_CRC32C_SSE42 0
+#endif
+
+#include "port/port.h"
+
+namespace czy_leveldb {
+namespace crc32c {
+
+namespace {
+
+// CRC-32C (Castagnoli) polynomial, reflected.
+const uint32_t kPolynomial = 0x82f63b78;
+
+// Lookup tables for the portable implementation (slicing by 4), built on
+// first use.
+struct SoftwareTables {
+  SoftwareTables() {
+    for (uint32_t n = 0; n < 256; n++) {
+      uint32_t crc = n;
+      for (int k = 0; k < 8; k++) {
+        crc = (crc & 1) ? (crc >> 1) ^ kPolynomial : crc >> 1;
+      }
+      table[0][n] = crc;
+    }
+    for (uint32_t n = 0; n < 256; n++) {
+      uint32_t crc = table[0][n];
+      for (int k = 1; k < 4; k++) {
+        crc = table[0][crc & 0xff] ^ (crc >> 8);
+        table[k][n] = crc;
+      }
+    }
+  }
+
+  uint32_t table[4][256];
+};
+
+}  // namespace
+
+uint32_t ExtendPortable(uint32_t crc, const char* buf, size_t size) {
+  static const SoftwareTables tables;
+  const uint32_t(*t)[256] = tables.table;
+  const uint8_t* p = reinterpret_cast<const uint8_t*>(buf);
+  const uint8_t* e = p + size;
+  uint32_t l = crc ^ 0xffffffffu;
+
+  while (p != e && (reinterpret_cast<uintptr_t>(p) & 3) != 0) {
+    l = t[0][(l ^ *p++) & 0xff] ^ (l >> 8);
+  }
+  while (e - p >= 4) {
+    l ^= static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+         (static_cast<uint32_t>(p[2]) << 16) |
+         (static_cast<uint32_t>(p[3]) << 24);
+    l = t[3][l & 0xff] ^ t[2][(l >> 8) & 0xff] ^ t[1][(l >> 16) & 0xff] ^
+        t[0][l >> 24];
+    p += 4;
+  }
+  while (p != e) {
+    l = t[0][(l ^ *p++) & 0xff] ^ (l >> 8);
+  }
+  return l ^ 0xffffffffu;
+}
+
+namespace {
+
+#if LEVELDB_CRC32C_SSE42
+
+// The crc32 instruction has a latency of three cycles but a throughput of
+// one per cycle, so large inputs are split into three streams that are
+// checksummed in parallel and then combined.  Combining needs the crc of a
+// stream shifted over the bytes that follow it, which is applied with the
+// "zeros" tables below (a GF(2) matrix multiply, split into bytes).
+const size_t kLong = 8192;
+const size_t kShort = 256;
+
+uint32_t Gf2MatrixTimes(const uint32_t* mat, uint32_t vec) {
+  uint32_t sum = 0;
+  while (vec) {
+    if (vec & 1) sum ^= *mat;
+    vec >>= 1;
+    mat++;
+  }
+  return sum;
+}
+
+void Gf2MatrixSquare(uint32_t* square, const uint32_t* mat) {
+  for (int n = 0; n < 32; n++) {
+    square[n] = Gf2MatrixTimes(mat, mat[n]);
+  }
+}
+
+// Build the operator that appends "len" zero bytes to a crc.
+// REQUIRES: len is a power of two.
+void ZerosOperator(uint32_t* even, size_t len) {
+  uint32_t odd[32];
+  // Operator for one zero bit.
+  odd[0] = kPolynomial;
+  uint32_t row = 1;
+  for (int n = 1; n < 32; n++) {
+    odd[n] = row;
+    row <<= 1;
+  }
+  Gf2MatrixSquare(even, odd);  // two zero bits
+  Gf2MatrixSquare(odd, even);  // four zero bits
+  // Each square doubles the number of zero bytes, starting from one.
+  do {
+    Gf2MatrixSquare(even, odd);
+    len >>= 1;
+    if (len == 0) return;
+    Gf2MatrixSquare(odd, even);
+    len >>= 1;
+  } while (len);
+  std::memcpy(even, odd, sizeof(odd));
+}
+
+struct ShiftTables {
+  ShiftTables() {
+    Build(long_zeros, kLong);
+    Build(short_zeros, kShort);
+  }
+
+  static void Build(uint32_t zeros[4][256], size_t len) {
+    uint32_t op[32];
+    ZerosOperator(op, len);
+    for (uint32_t n = 0; n < 256; n++) {
+      zeros[0][n] = Gf2MatrixTimes(op, n);
+      zeros[1][n] = Gf2MatrixTimes(op, n << 8);
+      zeros[2][n] = Gf2MatrixTimes(op, n << 16);
+      zeros[3][n] = Gf2MatrixTimes(op, n << 24);
+    }
+  }
+
+  uint32_t long_zeros[4][256];
+  uint32_t short_zeros[4][256];
+};
+
+inline uint32_t Shift(const uint32_t zeros[4][256], uint32_t crc) {
+  return zeros[0][crc & 0xff] ^ zeros[1][(crc >> 8) & 0xff] ^
+         zeros[2][(crc >> 16) & 0xff] ^ zeros[3][crc >> 24];
+}
+
+inline uint64_t Load64(const uint8_t* p) {
+  uint64_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+__attribute__((target("sse4.2"))) uint32_t ExtendSse42(uint32_t crc,
+                                                       const char* buf,
+                                                       size_t len) {
+  static const ShiftTables tables;
+  const uint8_t* next = reinterpret_cast<const uint8_t*>(buf);
+  uint64_t crc0 = crc ^ 0xffffffffu;
+  uint64_t crc1, crc2;
+
+  // Bring the data pointer to an eight-byte boundary.
+  while (len && (reinterpret_cast<uintptr_t>(next) & 7) != 0) {
+    crc0 = _mm_crc32_u8(static_cast<uint32_t>(crc0), *next);
+    next++;
+    len--;
+  }
+
+  while (len >= kLong * 3) {
+    crc1 = 0;
+    crc2 = 0;
+    const uint8_t* end = next + kLong;
+    do {
+      crc0 = _mm_crc32_u64(crc0, Load64(next));
+      crc1 = _mm_crc32_u64(crc1, Load64(next + kLong));
+      crc2 = _mm_crc32_u64(crc2, Load64(next + kLong + kLong));
+      next += 8;
+    } while (next < end);
+    crc0 = Shift(tables.long_zeros, static_cast<uint32_t>(crc0)) ^ crc1;
+    crc0 = Shift(tables.long_zeros, static_cast<uint32_t>(crc0)) ^ crc2;
+    next += kLong * 2;
+    len -= kLong * 3;
+  }
+
+  while (len >= kShort * 3) {
+    crc1 = 0;
+    crc2 = 0;
+    const uint8_t* end = next + kShort;
+    do {
+      crc0 = _mm_crc32_u64(crc0, Load64(next));
+      crc1 = _mm_crc32_u64(crc1, Load64(next + kShort));
+      crc2 = _mm_crc32_u64(crc2, Load64(next + kShort + kShort));
+      next += 8;
+    } while (next < end);
+    crc0 = Shift(tables.short_zeros, static_cast<uint32_t>(crc0)) ^ crc1;
+    crc0 = Shift(tables.short_zeros, static_cast<uint32_t>(crc0)) ^ crc2;
+    next += kShort * 2;
+    len -= kShort * 3;
+  }
+
+  const uint8_t* end = next + (len - (len & 7));
+  while (next < end) {
+    crc0 = _mm_crc32_u64(crc0, Load64(next));
+    next += 8;
+  }
+  len &= 7;
+
+  while (len) {
+    crc0 = _mm_crc32_u8(static_cast<uint32_t>(crc0), *next);
+    next++;
+    len--;
+  }
+  return static_cast<uint32_t>(crc0) ^ 0xffffffffu;
+}
+
+#endif  // LEVELDB_CRC32C_SSE42
+
+// Determine if port::AcceleratedCRC32C is available.
+bool CanAccelerateCRC32C() {
+  // port::AcceleretedCRC32C returns zero when unable to accelerate.
+  static const char kTestCRCBuffer[] = "TestCRCBuffer";
+  static const char kBufSize = sizeof(kTestCRCBuffer) - 1;
+  static const uint32_t kTestCRCValue = 0xdcbc59fa;
+
+  return port::AcceleratedCRC32C(0, kTestCRCBuffer, kBufSize) == kTestCRCValue;
+}
+
+typedef uint32_t (*ExtendFunction)(uint32_t, const char*, size_t);
+
+ExtendFunction ChooseExtend() {
+  if (CanAccelerateCRC32C()) {
+    return port::AcceleratedCRC32C;
+  }
+#if LEVELDB_CRC32C_SSE42
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("sse4.2")) {
+    return ExtendSse42;
+  }
+#endif  // LEVELDB_CRC32C_SSE42
+  return ExtendPortable;
+}
+
+}  // namespace
+
+uint32_t Extend(uint32_t crc, const char* data, size_t n) {
+  static const ExtendFunction extend = ChooseExtend();
+  return extend(crc, data, n);
+}
+
+}  // namespace crc32c
+}  // namespace czy_leveldb
@@ -0,0 +1,106 @@
+#include "util/crc32c.h"
+
+#include <cstring>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace czy_leveldb {
+namespace crc32c {
+
+namespace {
+
+// Bit-at-a-time reference, independent of both the table-driven and the
+// SSE4.2 implementations.
+uint32_t ReferenceValue(const char* data, size_t n) {
+  uint32_t crc = 0xffffffffu;
+  for (size_t i = 0; i < n; i++) {
+    crc ^= static_cast<uint8_t>(data[i]);
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (0x82f63b78u & (0u - (crc & 1)));
+    }
+  }
+  return crc ^ 0xffffffffu;
+}
+
+}  // namespace
+
+TEST(CRC, StandardResults) {
+  // From rfc3720 section B.4.
+  char buf[32];
+
+  memset(buf, 0, sizeof(buf));
+  ASSERT_EQ(0x8a9136aa, Value(buf, sizeof(buf)));
+
+  memset(buf, 0xff, sizeof(buf));
+  ASSERT_EQ(0x62a8ab43, Value(buf, sizeof(buf)));
+
+  for (int i = 0; i < 32; i++) {
+    buf[i] = i;
+  }
+  ASSERT_EQ(0x46dd794e, Value(buf, sizeof(buf)));
+
+  for (int i = 0; i < 32; i++) {
+    buf[i] = 31 - i;
+  }
+  ASSERT_EQ(0x113fdb5c, Value(buf, sizeof(buf)));
+
+  uint8_t data[48] = {
+      0x01, 0xc0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00,
+      0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x18, 0x28, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  };
+  ASSERT_EQ(0xd9963a56, Value(reinterpret_cast<char*>(data), sizeof(data)));
+}
+
+TEST(CRC, Values) { ASSERT_NE(Value("a", 1), Value("foo", 3)); }
+
+TEST(CRC, Extend) {
+  ASSERT_EQ(Value("hello world", 11), Extend(Value("hello ", 6), "world", 5));
+}
+
+TEST(CRC, MatchesReferenceAtAllLengthsAndAlignments) {
+  // Covers both three-stream loops of the SSE4.2 path (768 and 24576
+  // bytes and up) and the tails after them, with every misalignment of
+  // the start.  Extend() uses the fastest implementation available, so
+  // the portable one is checked separately.
+  std::string data;
+  uint32_t seed = 301;
+  for (int i = 0; i < 3 * 24576 + 8; i++) {
+    seed = seed * 1103515245 + 12345;
+    data.push_back(static_cast<char>(seed >> 16));
+  }
+  const size_t lengths[] = {0,     1,     7,     8,     15,    16,
+                            63,    64,    255,   256,   257,   767,
+                            768,   769,   1023,  1024,  4095,  4096,
+                            4097,  8191,  12000, 19990, 24575, 24576,
+                            24577, 3 * 8192 + 255, 3 * 8192 + 768,
+                            2 * 24576 + 3 * 256 + 7, 3 * 24576};
+  for (size_t offset = 0; offset < 8; offset++) {
+    for (size_t n : lengths) {
+      const char* p = data.data() + offset;
+      const uint32_t expected = ReferenceValue(p, n);
+      ASSERT_EQ(expected, Value(p, n))
+          << "offset " << offset << " length " << n;
+      ASSERT_EQ(expected, ExtendPortable(0, p, n))
+          << "offset " << offset << " length " << n;
+    }
+  }
+}
+
+TEST(CRC, PortableMatchesExtend) {
+  ASSERT_EQ(Value("hello world", 11),
+            ExtendPortable(ExtendPortable(0, "hello ", 6), "world", 5));
+}
+
+TEST(CRC, Mask) {
+  uint32_t crc = Value("foo", 3);
+  ASSERT_NE(crc, Mask(crc));
+  ASSERT_NE(crc, Mask(Mask(crc)));
+  ASSERT_EQ(crc, Unmask(Mask(crc)));
+  ASSERT_EQ(crc, Unmask(Unmask(Mask(Mask(crc)))));
+}
+
+}  // namespace crc32c
+}  // namespace czy_leveldb
@@ -0,0 +1,108 @@
+#include "util/dynamic_bloom.h"
+
+#include <cassert>
+#include <new>
+
+#include "util/hash.h"
+
+namespace czy_leveldb {
+
+namespace {
+
+uint32_t BloomHash(const Slice& key) {
+  return Hash(key.data(), key.size(), 0xbc9f1d34);
+}
+
+// The line is chosen from the high bits of the key's hash, so the bit
+// positions inside it must not come from those bits too, or keys sharing
+// a line would also share most of their probes.  Remix the hash so every
+// bit of it affects the probes.
+uint32_t ProbeHash(uint32_t h) {
+  uint32_t g = h * 0x9e3779b9;
+  g ^= g >> 15;
+  g *= 0x85ebca6b;
+  g ^= g >> 13;
+  return g;
+}
+
+// The step between probes.  Odd, so probes never repeat a bit of the line
+// before all of its bits were visited.
+uint32_t ProbeDelta(uint32_t g) { return ((g >> 17) | (g << 15)) | 1; }
+
+}  // namespace
+
+const size_t DynamicBloom::kLineBytes;
+const size_t DynamicBloom::kWordsPerLine;
+
+DynamicBloom::DynamicBloom(size_t total_bits, int num_probes)
+    : num_lines_(static_cast<uint32_t>((total_bits + kLineBytes * 8 - 1) /
+                                       (kLineBytes * 8))),
+      num_probes_(num_probes) {
+  assert(num_lines_ > 0);
+  assert(num_probes_ > 0);
+  const size_t words = num_lines_ * kWordsPerLine;
+  raw_ = new char[words * sizeof(uint64_t) + kLineBytes];
+  char* aligned = raw_ + (kLineBytes - reinterpret_cast<uintptr_t>(raw_) %
+                                           kLineBytes) % kLineBytes;
+  data_ = reinterpret_cast<std::atomic<uint64_t>*>(aligned);
+  for (size_t i = 0; i < words; i++) {
+    new (&data_[i]) std::atomic<uint64_t>(0);
+  }
+}
+
+DynamicBloom::~DynamicBloom() { delete[] raw_; }
+
+template <typename OrFunc>
+void DynamicBloom::AddHash(uint32_t h, const OrFunc& or_func) {
+  // Pick the line from the high bits of h (multiply-shift instead of a
+  // modulo), then derive the bit positions inside it as in the table
+  // filter, from a remixed hash: a rotated delta added num_probes_ times.
+  std::atomic<uint64_t>* line =
+      data_ + ((static_cast<uint64_t>(h) * num_lines_) >> 32) * kWordsPerLine;
+  uint32_t bit = ProbeHash(h);
+  const uint32_t delta = ProbeDelta(bit);
+  for (int i = 0; i < num_probes_; i++) {
+    const uint32_t pos = bit % (kLineBytes * 8);
+    or_func(&line[pos / 64], uint64_t{1} << (pos % 64));
+    bit += delta;
+  }
+}
+
+void DynamicBloom::Add(const Slice& key) {
+  AddHash(BloomHash(key), [](std::atomic<uint64_t>* word, uint64_t mask) {
+    word->store(word->load(std::memory_order_relaxed) | mask,
+                std::memory_order_relaxed);
+  });
+}
+
+void DynamicBloom::AddConcurrently(const Slice& key) {
+  AddHash(BloomHash(key), [](std::atomic<uint64_t>* word, uint64_t mask) {
+    // Skip the locked read-modify-write when the bit is already set, which
+    // is common once the filter fills up.
+    if ((word->load(std::memory_order_relaxed) & mask) != mask) {
+      word->fetch_or(mask, std::memory_order_relaxed);
+    }
+  });
+}
+
+bool DynamicBloom::MayContainHash(uint32_t h) const {
+  const std::atomic<uint64_t>* line =
+      data_ + ((static_cast<uint64_t>(h) * num_lines_) >> 32) * kWordsPerLine;
+  uint32_t bit = ProbeHash(h);
+  const uint32_t delta = ProbeDelta(bit);
+  for (int i = 0; i < num_probes_; i++) {
+    const uint32_t pos = bit % (kLineBytes * 8);
+    const uint64_t mask = uint64_t{1} << (pos % 64);
+    if ((line[pos / 64].load(std::memory_order_relaxed) & mask) == 0) {
+      return false;
+    }
+    bit += delta;
+  }
+  return true;
+}
+
+bool DynamicBloom::MayContain(const Slice& key) const {
+  return MayContainHash(BloomHash(key));
+}
+
+}  // namespace czy_leveldb
@@ -0,0 +1,52 @@
+#pragma once
+// An in-memory Bloom filter that keys are added to one at a time, for
+// structures like the memtable that never know their final key count.
+// All probes of a key fall in one 64-byte cache line, so a lookup costs
+// a single cache miss.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "leveldb/slice.h"
+
+namespace czy_leveldb {
+
+class DynamicBloom {
+ public:
+  // A filter of at least "total_bits" bits (rounded up to whole cache
+  // lines) setting "num_probes" bits per key.
+  explicit DynamicBloom(size_t total_bits, int num_probes = 6);
+
+  DynamicBloom(const DynamicBloom&) = delete;
+  DynamicBloom& operator=(const DynamicBloom&) = delete;
+
+  ~DynamicBloom();
+
+  // Add "key".  REQUIRES: external synchronization with other adds.
+  void Add(const Slice& key);
+
+  // Like Add(), but safe to call from several threads at once.
+  void AddConcurrently(const Slice& key);
+
+  // Returns false if "key" was certainly never added.  Safe to call
+  // concurrently with adds, though a racing add may not be observed.
+  bool MayContain(const Slice& key) const;
+
+  size_t MemoryUsage() const { return num_lines_ * kLineBytes; }
+
+ private:
+  static const size_t kLineBytes = 64;
+  static const size_t kWordsPerLine = kLineBytes / sizeof(uint64_t);
+
+  template <typename OrFunc>
+  void AddHash(uint32_t h, const OrFunc& or_func);
+  bool MayContainHash(uint32_t h) const;
+
+  const uint32_t num_lines_;
+  const int num_probes_;
+  char* raw_;                     // Storage, over-allocated for alignment
+  std::atomic<uint64_t>* data_;  // num_lines_ cache-line aligned lines
+};
+
+}  // namespace czy_leveldb
@@ -0,0 +1,90 @@
+#include "util/dynamic_bloom.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "util/coding.h"
+
+namespace czy_leveldb {
+
+namespace {
+
+std::string Key(uint32_t i, uint32_t salt = 0) {
+  std::string result;
+  PutFixed32(&result, i);
+  PutFixed32(&result, salt);
+  return result;
+}
+
+// Fraction of 10000 keys never added to "bloom" that it may contain.
+double FalsePositiveRate(const DynamicBloom& bloom) {
+  int hits = 0;
+  for (uint32_t i = 0; i < 10000; i++) {
+    if (bloom.MayContain(Key(i + 1000000000, 1))) {
+      hits++;
+    }
+  }
+  return hits / 10000.0;
+}
+
+}  // namespace
+
+TEST(DynamicBloomTest, Empty) {
+  DynamicBloom bloom(100);
+  ASSERT_EQ(64u, bloom.MemoryUsage());
+  ASSERT_FALSE(bloom.MayContain("hello"));
+  ASSERT_FALSE(bloom.MayContain(""));
+}
+
+TEST(DynamicBloomTest, Small) {
+  DynamicBloom bloom(1000);
+  bloom.Add("hello");
+  bloom.Add("world");
+  ASSERT_TRUE(bloom.MayContain("hello"));
+  ASSERT_TRUE(bloom.MayContain("world"));
+  ASSERT_FALSE(bloom.MayContain("x"));
+  ASSERT_FALSE(bloom.MayContain("foo"));
+}
+
+// At 10 bits per key the filter must stay close to the ~1% of a classic
+// Bloom filter despite keeping every key's probes in one cache line.
+TEST(DynamicBloomTest, FalsePositiveRate) {
+  for (uint32_t num_keys : {1000u, 10000u, 100000u}) {
+    DynamicBloom bloom(num_keys * 10);
+    for (uint32_t i = 0; i < num_keys; i++) {
+      bloom.Add(Key(i));
+    }
+    for (uint32_t i = 0; i < num_keys; i++) {
+      ASSERT_TRUE(bloom.MayContain(Key(i))) << "Length " << num_keys;
+    }
+    const double rate = FalsePositiveRate(bloom);
+    ASSERT_LT(rate, 0.015) << "Length " << num_keys;
+  }
+}
+
+TEST(DynamicBloomTest, ConcurrentAdd) {
+  const int kThreads = 4;
+  const uint32_t kKeysPerThread = 20000;
+  DynamicBloom bloom(kThreads * kKeysPerThread * 10);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; t++) {
+    threads.emplace_back([&bloom, t]() {
+      for (uint32_t i = 0; i < kKeysPerThread; i++) {
+        bloom.AddConcurrently(Key(i, t));
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (int t = 0; t < kThreads; t++) {
+    for (uint32_t i = 0; i < kKeysPerThread; i++) {
+      ASSERT_TRUE(bloom.MayContain(Key(i, t)));
+    }
+  }
+  ASSERT_LT(FalsePositiveRate(bloom), 0.015);
+}
+
+}  // namespace czy_leveldb
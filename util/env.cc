@@ -9,10 +9,16 @@ Env::Env() = default;
 Env::~Env() = default;
 
 Status Env::NewAppendableFile(const std::string & fname, WritableFile** result){
+    *result = nullptr;
     return Status::NotSupported("NewAppendableFile",fname);
 }
 
+Status Env::LinkFile(const std::string & src,const std::string & /*target*/){
+    return Status::NotSupported("LinkFile",src);
+}
+
 Status Env::RemoveDir(const std::string & dirname) {return DeleteDir(dirname);}
+Status Env::DeleteDir(const std::string & dirname) {return RemoveDir(dirname);}
 
 Status Env::RemoveFile(const std::string& fname) { return DeleteFile(fname); }
 Status Env::DeleteFile(const std::string& fname) { return RemoveFile(fname); }
@@ -21,6 +27,18 @@ SequentialFile::~SequentialFile() = default;
 
 RandomAccessFile::~RandomAccessFile() = default;
 
+Status RandomAccessFile::MultiRead(ReadRequest* reqs, size_t num_reqs) const {
+    for(size_t i = 0; i < num_reqs; i++){
+        ReadRequest & req = reqs[i];
+        req.status = Read(req.offset,req.len,&req.result,req.scratch);
+    }
+    return Status::OK();
+}
+
+Status RandomAccessFile::ReadAsync(ReadRequest* /*req*/, ReadCallback /*callback*/, void* /*arg*/) const {
+    return Status::NotSupported("ReadAsync");
+}
+
 WritableFile::~WritableFile() = default;
 
 Logger::~Logger() = default;
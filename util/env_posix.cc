@@ -10,7 +10,9 @@
 #include <unistd.h>
 
 #include <atomic>
+#include <cassert>
 #include <cerrno>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
@@ -29,6 +31,7 @@
 #include "leveldb/status.h"
 #include "port/port.h"
 #include "port/thread_annotations.h"
+#include "util/env_posix_test_helper.h"
 #include "util/posix_logger.h"
 
 namespace czy_leveldb{
@@ -110,7 +113,7 @@ public:
                 status = PosixError(filename_,errno);
                 break;
             }
-            *result = Silce(scratch,read_size);
+            *result = Slice(scratch,read_size);
             break;
         }
         return status;
@@ -173,6 +176,30 @@ public:
         }
         return status;
     }
+
+    //һδļ,ȡ
+    //ûгפfdʱÿζҪopen/close
+    Status MultiRead(ReadRequest * reqs,size_t num_reqs) const override{
+        int fd = fd_;
+        if(!has_permanent_fd_){
+            fd = ::open(file_name_.c_str(),O_RDONLY | kOpenBaseFlags);
+            if(fd < 0){
+                return PosixError(file_name_,errno);
+            }
+        }
+        assert(fd != -1);
+        for(size_t i = 0; i < num_reqs; i++){
+            ReadRequest & req = reqs[i];
+            ssize_t read_size = ::pread(fd,req.scratch,req.len,static_cast<off_t>(req.offset));
+            req.result = Slice(req.scratch,(read_size < 0) ? 0:read_size);
+            req.status = (read_size < 0) ? PosixError(file_name_,errno) : Status::OK();
+        }
+        if(!has_permanent_fd_){
+            assert(fd != fd_);
+            close(fd);
+        }
+        return Status::OK();
+    }
 private:
     const bool has_permanent_fd_;
     const int fd_;
@@ -195,7 +222,7 @@ public:
         mmap_limiter_->Release();
     }
 
-    Status Read (uint64_t offset,size_t n ,Slice * result,char * scratch) const override{
+    Status Read (uint64_t offset,size_t n ,Slice * result,char * /*scratch*/) const override{
         if(offset + n > length_){
             *result = Slice();
             //EINVAL::Ч
@@ -283,7 +310,7 @@ private:
     Status WriteUnbuffered(const char * data,size_t size){
         while(size > 0){
             ssize_t write_result = :: write(fd_ ,data,size);
-            while(write_result < 0){
+            if(write_result < 0){
                 if(errno  == EINTR){
                     continue;
                 }
@@ -347,4 +374,393 @@ private:
     const std::string filename_;
     const std::string dirname_;
 };
+
+int LockOrUnlock(int fd,bool lock){
+    errno = 0;
+    struct ::flock file_lock_info;
+    std::memset(&file_lock_info,0,sizeof(file_lock_info));
+    file_lock_info.l_type = (lock ? F_WRLCK : F_UNLCK);
+    file_lock_info.l_whence = SEEK_SET;
+    file_lock_info.l_start = 0;
+    file_lock_info.l_len = 0;//סļ
+    return ::fcntl(fd,F_SETLK,&file_lock_info);
+}
+
+class PosixFileLock : public FileLock{
+public:
+    PosixFileLock(int fd,std::string filename)
+     :fd_(fd),filename_(std::move(filename))
+    { }
+    int fd() const {return fd_;}
+    const std::string & filename() const {return filename_;}
+private:
+    const int fd_;
+    const std::string filename_;
+};
+
+//fcntlǽ̼,ͬһظʧ
+//һű¼Ѿסļ
+class PosixLockTable{
+public:
+    bool Insert(const std::string & fname) LOCKS_EXCLUDED(mu_){
+        mu_.Lock();
+        bool succeeded = locked_files_.insert(fname).second;
+        mu_.UnLock();
+        return succeeded;
+    }
+    void Remove(const std::string & fname) LOCKS_EXCLUDED(mu_){
+        mu_.Lock();
+        locked_files_.erase(fname);
+        mu_.UnLock();
+    }
+private:
+    port::Mutex mu_;
+    std::set<std::string> locked_files_ GUARDED_BY(mu_);
+};
+
+class PosixEnv : public Env{
+public:
+    PosixEnv();
+    ~PosixEnv() override{
+        static const char msg[] = "PosixEnv singleton destroyed. Unsupported behavior!\n";
+        std::fwrite(msg,1,sizeof(msg),stderr);
+        std::abort();
+    }
+
+    Status NewSequentialFile(const std::string & filename,SequentialFile ** result) override{
+        int fd = ::open(filename.c_str(),O_RDONLY | kOpenBaseFlags);
+        if(fd < 0){
+            *result = nullptr;
+            return PosixError(filename,errno);
+        }
+        *result = new PosixSquentialFile(filename,fd);
+        return Status::OK();
+    }
+
+    Status NewRandomAccessFile(const std::string & filename,RandomAccessFile ** result) override{
+        *result = nullptr;
+        int fd = ::open(filename.c_str(),O_RDONLY | kOpenBaseFlags);
+        if(fd < 0){
+            return PosixError(filename,errno);
+        }
+        if(!mmap_limiter_.Acquire()){
+            *result = new PosixRandomAccessFile(filename,fd,&fd_limiter_);
+            return Status::OK();
+        }
+        uint64_t file_size;
+        Status status = GetFileSize(filename,&file_size);
+        if(status.ok()){
+            void * mmap_base = ::mmap(nullptr,file_size,PROT_READ,MAP_SHARED,fd,0);
+            if(mmap_base != MAP_FAILED){
+                *result = new PosixMmapReadableFile(filename,reinterpret_cast<char *>(mmap_base),
+                                                    file_size,&mmap_limiter_);
+            }
+            else{
+                status = PosixError(filename,errno);
+            }
+        }
+        //ӳ佨֮fdͲҪ
+        ::close(fd);
+        if(!status.ok()){
+            mmap_limiter_.Release();
+        }
+        return status;
+    }
+
+    Status NewWritableFile(const std::string & filename,WritableFile ** result) override{
+        int fd = ::open(filename.c_str(),O_TRUNC | O_WRONLY | O_CREAT | kOpenBaseFlags,0644);
+        if(fd < 0){
+            *result = nullptr;
+            return PosixError(filename,errno);
+        }
+        *result = new PosixWritableFile(filename,fd);
+        return Status::OK();
+    }
+
+    Status NewAppendableFile(const std::string & filename,WritableFile ** result) override{
+        int fd = ::open(filename.c_str(),O_APPEND | O_WRONLY | O_CREAT | kOpenBaseFlags,0644);
+        if(fd < 0){
+            *result = nullptr;
+            return PosixError(filename,errno);
+        }
+        *result = new PosixWritableFile(filename,fd);
+        return Status::OK();
+    }
+
+    bool FileExists(const std::string & filename) override{
+        return ::access(filename.c_str(),F_OK) == 0;
+    }
+
+    Status GetChildren(const std::string & directory_path,std::vector<std::string> * result) override{
+        result->clear();
+        ::DIR * dir = ::opendir(directory_path.c_str());
+        if(dir == nullptr){
+            return PosixError(directory_path,errno);
+        }
+        struct ::dirent * entry;
+        while((entry = ::readdir(dir)) != nullptr){
+            result->emplace_back(entry->d_name);
+        }
+        ::closedir(dir);
+        return Status::OK();
+    }
+
+    Status RemoveFile(const std::string & filename) override{
+        if(::unlink(filename.c_str()) != 0){
+            return PosixError(filename,errno);
+        }
+        return Status::OK();
+    }
+
+    Status CreateDir(const std::string & dirname) override{
+        if(::mkdir(dirname.c_str(),0755) != 0){
+            return PosixError(dirname,errno);
+        }
+        return Status::OK();
+    }
+
+    Status RemoveDir(const std::string & dirname) override{
+        if(::rmdir(dirname.c_str()) != 0){
+            return PosixError(dirname,errno);
+        }
+        return Status::OK();
+    }
+
+    Status GetFileSize(const std::string & filename,uint64_t * size) override{
+        struct ::stat file_stat;
+        if(::stat(filename.c_str(),&file_stat) != 0){
+            *size = 0;
+            return PosixError(filename,errno);
+        }
+        *size = file_stat.st_size;
+        return Status::OK();
+    }
+
+    Status RenameFile(const std::string & from,const std::string & to) override{
+        if(std::rename(from.c_str(),to.c_str()) != 0){
+            return PosixError(from,errno);
+        }
+        return Status::OK();
+    }
+
+    //Ӳ,ĿļԴļ,Ҫ
+    Status LinkFile(const std::string & src,const std::string & target) override{
+        if(::link(src.c_str(),target.c_str()) != 0){
+            return PosixError(src,errno);
+        }
+        return Status::OK();
+    }
+
+    Status LockFile(const std::string & filename,FileLock ** lock) override{
+        *lock = nullptr;
+        int fd = ::open(filename.c_str(),O_RDWR | O_CREAT | kOpenBaseFlags,0644);
+        if(fd < 0){
+            return PosixError(filename,errno);
+        }
+        if(!locks_.Insert(filename)){
+            ::close(fd);
+            return Status::IOError("lock " + filename,"already held by process");
+        }
+        if(LockOrUnlock(fd,true) == -1){
+            int lock_errno = errno;
+            ::close(fd);
+            locks_.Remove(filename);
+            return PosixError("lock " + filename,lock_errno);
+        }
+        *lock = new PosixFileLock(fd,filename);
+        return Status::OK();
+    }
+
+    Status UnlockFile(FileLock * lock) override{
+        PosixFileLock * posix_file_lock = static_cast<PosixFileLock *>(lock);
+        if(LockOrUnlock(posix_file_lock->fd(),false) == -1){
+            return PosixError("unlock " + posix_file_lock->filename(),errno);
+        }
+        locks_.Remove(posix_file_lock->filename());
+        ::close(posix_file_lock->fd());
+        delete posix_file_lock;
+        return Status::OK();
+    }
+
+    void Schedule(void (*background_work_function)(void * background_work_arg),
+                  void * background_work_arg) override;
+
+    void StartThread(void (*thread_main)(void * thread_main_arg),
+                     void * thread_main_arg) override{
+        std::thread new_thread(thread_main,thread_main_arg);
+        new_thread.detach();
+    }
+
+    Status GetTestDirectory(std::string * result) override{
+        const char * env = std::getenv("TEST_TMPDIR");
+        if(env && env[0] != '\0'){
+            *result = env;
+        }
+        else{
+            char buf[100];
+            std::snprintf(buf,sizeof(buf),"/tmp/leveldbtest-%d",static_cast<int>(::geteuid()));
+            *result = buf;
+        }
+        //Ŀ¼Ѿ,Դ
+        CreateDir(*result);
+        return Status::OK();
+    }
+
+    Status NewLogger(const std::string & filename,Logger ** result) override{
+        int fd = ::open(filename.c_str(),O_APPEND | O_WRONLY | O_CREAT | kOpenBaseFlags,0644);
+        if(fd < 0){
+            *result = nullptr;
+            return PosixError(filename,errno);
+        }
+        std::FILE * fp = ::fdopen(fd,"w");
+        if(fp == nullptr){
+            ::close(fd);
+            *result = nullptr;
+            return PosixError(filename,errno);
+        }
+        *result = new PosixLogger(fp);
+        return Status::OK();
+    }
+
+    uint64_t NowMicros() override{
+        static constexpr uint64_t kUsecondsPerSecond = 1000000;
+        struct ::timeval tv;
+        ::gettimeofday(&tv,nullptr);
+        return static_cast<uint64_t>(tv.tv_sec) * kUsecondsPerSecond + tv.tv_usec;
+    }
+
+    void SleepForMicroseconds(int micros) override{
+        std::this_thread::sleep_for(std::chrono::microseconds(micros));
+    }
+
+private:
+    void BackgroundThreadMain();
+
+    static void BackgroundThreadEntryPoint(PosixEnv * env){
+        env->BackgroundThreadMain();
+    }
+
+    //̨еһ
+    struct BackgroundWorkItem{
+        explicit BackgroundWorkItem(void (*function)(void * arg),void * arg)
+         :function(function),arg(arg)
+        { }
+        void (*const function)(void *);
+        void * const arg;
+    };
+
+    port::Mutex background_work_mutex_;
+    port::CondVar background_work_cv_ GUARDED_BY(background_work_mutex_);
+    bool started_background_thread_ GUARDED_BY(background_work_mutex_);
+    std::queue<BackgroundWorkItem> background_work_queue_ GUARDED_BY(background_work_mutex_);
+
+    PosixLockTable locks_;
+    Limiter mmap_limiter_;
+    Limiter fd_limiter_;
+};
+
+//64λϵͳĬ1000mmap
+int MaxMmaps() {return g_mmap_limit;}
+
+//ʹ20%Ŀļֻļ
+int MaxOpenFiles(){
+    if(g_open_read_only_file_limit >= 0){
+        return g_open_read_only_file_limit;
+    }
+#ifdef __Fuchsia__
+    g_open_read_only_file_limit = 50;
+#else
+    struct ::rlimit rlim;
+    if(::getrlimit(RLIMIT_NOFILE,&rlim)){
+        g_open_read_only_file_limit = 50;
+    }
+    else if(rlim.rlim_cur == RLIM_INFINITY){
+        g_open_read_only_file_limit = std::numeric_limits<int>::max();
+    }
+    else{
+        g_open_read_only_file_limit = rlim.rlim_cur / 5;
+    }
+#endif
+    return g_open_read_only_file_limit;
 }
+
+PosixEnv::PosixEnv()
+ :background_work_cv_(&background_work_mutex_),
+  started_background_thread_(false),
+  mmap_limiter_(MaxMmaps()),
+  fd_limiter_(MaxOpenFiles())
+{ }
+
+void PosixEnv::Schedule(void (*background_work_function)(void * background_work_arg),
+                        void * background_work_arg){
+    background_work_mutex_.Lock();
+    //һεʱ̨߳
+    if(!started_background_thread_){
+        started_background_thread_ = true;
+        std::thread background_thread(PosixEnv::BackgroundThreadEntryPoint,this);
+        background_thread.detach();
+    }
+    if(background_work_queue_.empty()){
+        background_work_cv_.Signal();
+    }
+    background_work_queue_.emplace(background_work_function,background_work_arg);
+    background_work_mutex_.UnLock();
+}
+
+void PosixEnv::BackgroundThreadMain(){
+    while(true){
+        background_work_mutex_.Lock();
+        while(background_work_queue_.empty()){
+            background_work_cv_.Wait();
+        }
+        assert(!background_work_queue_.empty());
+        auto background_work_function = background_work_queue_.front().function;
+        void * background_work_arg = background_work_queue_.front().arg;
+        background_work_queue_.pop();
+        background_work_mutex_.UnLock();
+        background_work_function(background_work_arg);
+    }
+}
+
+namespace {
+
+//Env::Default()صĵ,Զ
+template <typename EnvType>
+class SingletonEnv{
+public:
+    SingletonEnv(){
+        static_assert(sizeof(env_storage_) >= sizeof(EnvType),"env_storage_ will not fit the Env");
+        static_assert(std::is_standard_layout<SingletonEnv<EnvType>>::value,
+                      "offsetof() requires a standard layout SingletonEnv");
+        static_assert(offsetof(SingletonEnv<EnvType>,env_storage_) % alignof(EnvType) == 0,
+                      "env_storage_ does not meet the Env's alignment needs");
+        static_assert(alignof(SingletonEnv<EnvType>) % alignof(EnvType) == 0,
+                      "env_storage_ does not meet the Env's alignment needs");
+        new (env_storage_) EnvType();
+    }
+    ~SingletonEnv() = default;
+    SingletonEnv(const SingletonEnv &) = delete;
+    SingletonEnv & operator=(const SingletonEnv &) = delete;
+    Env * env() {return reinterpret_cast<Env *>(&env_storage_);}
+private:
+    alignas(EnvType) char env_storage_[sizeof(EnvType)];
+};
+
+using PosixDefaultEnv = SingletonEnv<PosixEnv>;
+
+}  // namespace
+
+void EnvPosixTestHelper::SetReadOnlyFDLimit(int limit){
+    g_open_read_only_file_limit = limit;
+}
+
+void EnvPosixTestHelper::SetReadOnlyMMapLimit(int limit){
+    g_mmap_limit = limit;
+}
+
+Env * Env::Default(){
+    static PosixDefaultEnv env_container;
+    return env_container.env();
+}
+
+}  // namespace czy_leveldb
@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "leveldb/env.h"
+#include "leveldb/slice.h"
+#include "util/env_posix_test_helper.h"
+
+namespace czy_leveldb {
+
+namespace {
+
+// Runs before main(), and so before Env::Default() sizes its limiters:
+// every RandomAccessFile in this test is pread()-backed and reopens the
+// file for each call, the path MultiRead() batches.
+const bool kLimitsSet = [] {
+  EnvPosixTestHelper::SetReadOnlyMMapLimit(0);
+  EnvPosixTestHelper::SetReadOnlyFDLimit(0);
+  return true;
+}();
+
+// Serves reads from a string, failing any that start at "bad_offset".
+class StringSource : public RandomAccessFile {
+ public:
+  StringSource(const std::string& contents, uint64_t bad_offset)
+      : contents_(contents), bad_offset_(bad_offset) {}
+
+  Status Read(uint64_t offset, size_t n, Slice* result,
+              char* scratch) const override {
+    if (offset == bad_offset_) {
+      *result = Slice();
+      return Status::IOError("injected");
+    }
+    n = std::min(n, static_cast<size_t>(contents_.size() - offset));
+    std::memcpy(scratch, contents_.data() + offset, n);
+    *result = Slice(scratch, n);
+    return Status::OK();
+  }
+
+ private:
+  const std::string contents_;
+  const uint64_t bad_offset_;
+};
+
+}  // namespace
+
+class EnvPosixTest : public testing::Test {
+ public:
+  EnvPosixTest() : env_(Env::Default()) {
+    EXPECT_TRUE(env_->GetTestDirectory(&test_dir_).ok());
+  }
+
+  std::string Path(const std::string& name) const {
+    return test_dir_ + "/env_posix_test_" + name;
+  }
+
+  Env* env_;
+  std::string test_dir_;
+};
+
+TEST_F(EnvPosixTest, WriteReadRemove) {
+  const std::string fname = Path("file");
+  ASSERT_TRUE(WriteStringToFile(env_, "hello world", fname).ok());
+  ASSERT_TRUE(env_->FileExists(fname));
+  uint64_t size;
+  ASSERT_TRUE(env_->GetFileSize(fname, &size).ok());
+  ASSERT_EQ(11u, size);
+
+  std::string contents;
+  ASSERT_TRUE(ReadFileToString(env_, fname, &contents).ok());
+  ASSERT_EQ("hello world", contents);
+
+  RandomAccessFile* file;
+  ASSERT_TRUE(env_->NewRandomAccessFile(fname, &file).ok());
+  char scratch[5];
+  Slice result;
+  ASSERT_TRUE(file->Read(6, 5, &result, scratch).ok());
+  ASSERT_EQ("world", result.ToString());
+  delete file;
+
+  ASSERT_TRUE(env_->RemoveFile(fname).ok());
+  ASSERT_FALSE(env_->FileExists(fname));
+  ASSERT_TRUE(env_->GetFileSize(fname, &size).IsNotFound());
+}
+
+TEST_F(EnvPosixTest, MultiRead) {
+  ASSERT_TRUE(kLimitsSet);
+  const std::string fname = Path("multiread");
+  std::string contents;
+  for (int i = 0; i < 1000; i++) {
+    contents.append(std::to_string(i));
+  }
+  ASSERT_TRUE(WriteStringToFile(env_, contents, fname).ok());
+  RandomAccessFile* file;
+  ASSERT_TRUE(env_->NewRandomAccessFile(fname, &file).ok());
+
+  // Out of order, overlapping, and one running past the end of the file.
+  const uint64_t offsets[] = {500, 0, 505, 2880};
+  const size_t lengths[] = {20, 10, 3, 100};
+  char scratch[4][100];
+  ReadRequest reqs[4];
+  for (int i = 0; i < 4; i++) {
+    reqs[i].offset = offsets[i];
+    reqs[i].len = lengths[i];
+    reqs[i].scratch = scratch[i];
+  }
+  ASSERT_TRUE(file->MultiRead(reqs, 4).ok());
+  for (int i = 0; i < 4; i++) {
+    ASSERT_TRUE(reqs[i].status.ok());
+    ASSERT_EQ(contents.substr(offsets[i], lengths[i]),
+              reqs[i].result.ToString());
+  }
+  delete file;
+  ASSERT_TRUE(env_->RemoveFile(fname).ok());
+
+  ASSERT_TRUE(env_->NewRandomAccessFile(fname, &file).IsNotFound());
+}
+
+TEST(RandomAccessFileTest, DefaultMultiReadReportsPerRequestStatus) {
+  StringSource file("0123456789", 4);
+  char scratch[3][4];
+  ReadRequest reqs[3];
+  const uint64_t offsets[] = {8, 4, 0};
+  for (int i = 0; i < 3; i++) {
+    reqs[i].offset = offsets[i];
+    reqs[i].len = 4;
+    reqs[i].scratch = scratch[i];
+  }
+  ASSERT_TRUE(file.MultiRead(reqs, 3).ok());
+  ASSERT_TRUE(reqs[0].status.ok());
+  ASSERT_EQ("89", reqs[0].result.ToString());
+  ASSERT_TRUE(reqs[1].status.IsIOError());
+  ASSERT_TRUE(reqs[2].status.ok());
+  ASSERT_EQ("0123", reqs[2].result.ToString());
+}
+
+TEST_F(EnvPosixTest, AppendableFileKeepsContents) {
+  const std::string fname = Path("append");
+  ASSERT_TRUE(WriteStringToFile(env_, "abc", fname).ok());
+  WritableFile* file;
+  ASSERT_TRUE(env_->NewAppendableFile(fname, &file).ok());
+  ASSERT_TRUE(file->Append("def").ok());
+  ASSERT_TRUE(file->Close().ok());
+  delete file;
+  std::string contents;
+  ASSERT_TRUE(ReadFileToString(env_, fname, &contents).ok());
+  ASSERT_EQ("abcdef", contents);
+  ASSERT_TRUE(env_->RemoveFile(fname).ok());
+}
+
+TEST_F(EnvPosixTest, LinkFileSharesContents) {
+  const std::string src = Path("link_src");
+  const std::string target = Path("link_target");
+  env_->RemoveFile(target);
+  ASSERT_TRUE(WriteStringToFile(env_, "linked", src).ok());
+  ASSERT_TRUE(env_->LinkFile(src, target).ok());
+  // The link outlives the original name, as ingestion relies on.
+  ASSERT_TRUE(env_->RemoveFile(src).ok());
+  std::string contents;
+  ASSERT_TRUE(ReadFileToString(env_, target, &contents).ok());
+  ASSERT_EQ("linked", contents);
+  // Linking onto an existing file fails rather than replacing it.
+  ASSERT_TRUE(WriteStringToFile(env_, "other", src).ok());
+  ASSERT_FALSE(env_->LinkFile(src, target).ok());
+  ASSERT_TRUE(env_->RemoveFile(src).ok());
+  ASSERT_TRUE(env_->RemoveFile(target).ok());
+  ASSERT_TRUE(env_->LinkFile(src, target).IsNotFound());
+}
+
+TEST_F(EnvPosixTest, LockIsExclusiveWithinProcess) {
+  const std::string fname = Path("LOCK");
+  FileLock* lock;
+  ASSERT_TRUE(env_->LockFile(fname, &lock).ok());
+  FileLock* second;
+  ASSERT_TRUE(env_->LockFile(fname, &second).IsIOError());
+  ASSERT_EQ(nullptr, second);
+  ASSERT_TRUE(env_->UnlockFile(lock).ok());
+  ASSERT_TRUE(env_->LockFile(fname, &lock).ok());
+  ASSERT_TRUE(env_->UnlockFile(lock).ok());
+  ASSERT_TRUE(env_->RemoveFile(fname).ok());
+}
+
+TEST_F(EnvPosixTest, GetChildrenAndDirs) {
+  const std::string dir = Path("dir");
+  ASSERT_TRUE(env_->CreateDir(dir).ok());
+  ASSERT_TRUE(WriteStringToFile(env_, "x", dir + "/a").ok());
+  std::vector<std::string> children;
+  ASSERT_TRUE(env_->GetChildren(dir, &children).ok());
+  ASSERT_NE(children.end(), std::find(children.begin(), children.end(), "a"));
+  ASSERT_TRUE(env_->RenameFile(dir + "/a", dir + "/b").ok());
+  ASSERT_TRUE(env_->FileExists(dir + "/b"));
+  ASSERT_TRUE(env_->RemoveFile(dir + "/b").ok());
+  ASSERT_TRUE(env_->RemoveDir(dir).ok());
+}
+
+TEST_F(EnvPosixTest, ScheduleRunsInOrder) {
+  struct State {
+    std::atomic<int> next{0};
+    std::atomic<bool> in_order{true};
+  };
+  struct Item {
+    State* state;
+    int id;
+    static void Run(void* arg) {
+      Item* item = static_cast<Item*>(arg);
+      if (item->state->next.load() != item->id) {
+        item->state->in_order.store(false);
+      }
+      item->state->next.fetch_add(1);
+    }
+  };
+  State state;
+  std::vector<Item> items(10);
+  for (int i = 0; i < 10; i++) {
+    items[i] = Item{&state, i};
+    env_->Schedule(&Item::Run, &items[i]);
+  }
+  for (int i = 0; i < 1000 && state.next.load() < 10; i++) {
+    env_->SleepForMicroseconds(1000);
+  }
+  ASSERT_EQ(10, state.next.load());
+  ASSERT_TRUE(state.in_order.load());
+}
+
+}  // namespace czy_leveldb
@@ -0,0 +1,17 @@
+#pragma once
+
+namespace czy_leveldb {
+
+// A helper for the POSIX Env to facilitate testing.
+class EnvPosixTestHelper {
+ public:
+  // Set the maximum number of read-only files that will be opened.
+  // Must be called before creating an Env.
+  static void SetReadOnlyFDLimit(int limit);
+
+  // Set the maximum number of read-only files that will be mapped via mmap.
+  // Must be called before creating an Env.
+  static void SetReadOnlyMMapLimit(int limit);
+};
+
+}  // namespace czy_leveldb
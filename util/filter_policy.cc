@@ -0,0 +1,7 @@
+#include "leveldb/filter_policy.h"
+
+namespace czy_leveldb {
+
+FilterPolicy::~FilterPolicy() = default;
+
+}  // namespace czy_leveldb
@@ -0,0 +1,11 @@
+#pragma once
+// Simple hash function used for internal data structures
+
+#include <cstddef>
+#include <cstdint>
+
+namespace czy_leveldb {
+
+uint32_t Hash(const char* data, size_t n, uint32_t seed);
+
+}  // namespace czy_leveldb
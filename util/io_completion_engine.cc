@@ -0,0 +1,104 @@
+#include "util/io_completion_engine.h"
+
+namespace czy_leveldb {
+
+IOCompletionEngine::IOCompletionEngine(int num_threads)
+    : shutting_down_(false), native_reads_(0) {
+  if (num_threads < 1) {
+    num_threads = 1;
+  }
+  for (int i = 0; i < num_threads; i++) {
+    workers_.emplace_back(&IOCompletionEngine::WorkerMain, this);
+  }
+}
+
+IOCompletionEngine::~IOCompletionEngine() {
+  {
+    std::unique_lock<std::mutex> l(mu_);
+    while (native_reads_ > 0) {
+      native_cv_.wait(l);
+    }
+    shutting_down_ = true;
+  }
+  work_cv_.notify_all();
+  for (std::thread& t : workers_) {
+    t.join();
+  }
+}
+
+void IOCompletionEngine::Submit(const RandomAccessFile* file,
+                                ReadRequest* req,
+                                RandomAccessFile::ReadCallback callback,
+                                void* arg) {
+  NativeRead* native = new NativeRead{this, callback, arg};
+  {
+    std::lock_guard<std::mutex> l(mu_);
+    native_reads_++;
+  }
+  Status s = file->ReadAsync(req, &IOCompletionEngine::NativeReadDone, native);
+  if (s.ok()) {
+    return;
+  }
+
+  // ReadAsync() failed without calling back.  Only files without native
+  // async reads are read by the pool; for other errors the read is not
+  // retried, but the callback still runs on a pool thread.
+  delete native;
+  {
+    std::lock_guard<std::mutex> l(mu_);
+    native_reads_--;
+    if (native_reads_ == 0) {
+      native_cv_.notify_all();
+    }
+    if (s.IsNotSupportedError()) {
+      s = Status::OK();
+    }
+    queue_.push_back(PendingRead{file, req, callback, arg, s});
+  }
+  work_cv_.notify_one();
+}
+
+void IOCompletionEngine::NativeReadDone(void* arg, ReadRequest* req) {
+  NativeRead* native = static_cast<NativeRead*>(arg);
+  IOCompletionEngine* engine = native->engine;
+  (*native->callback)(native->arg, req);
+  delete native;
+
+  // The destructor may run as soon as mu_ is released, so the engine must
+  // not be touched after that.
+  std::lock_guard<std::mutex> l(engine->mu_);
+  engine->native_reads_--;
+  if (engine->native_reads_ == 0) {
+    engine->native_cv_.notify_all();
+  }
+}
+
+void IOCompletionEngine::WorkerMain() {
+  std::unique_lock<std::mutex> l(mu_);
+  while (true) {
+    // Drain the queue before honoring shutdown so no callback is lost.
+    while (queue_.empty() && !shutting_down_) {
+      work_cv_.wait(l);
+    }
+    if (queue_.empty()) {
+      return;
+    }
+    PendingRead p = queue_.front();
+    queue_.pop_front();
+    l.unlock();
+
+    ReadRequest* req = p.req;
+    if (p.status.ok()) {
+      req->status = p.file->Read(req->offset, req->len, &req->result,
+                                 req->scratch);
+    } else {
+      req->result = Slice();
+      req->status = p.status;
+    }
+    (*p.callback)(p.arg, req);
+
+    l.lock();
+  }
+}
+
+}  // namespace czy_leveldb
@@ -0,0 +1,72 @@
+#pragma once
+// Runs reads for asynchronous lookups.  Files that implement
+// RandomAccessFile::ReadAsync() are handed the request directly; for the
+// others a small pool of threads performs the blocking Read() and invokes
+// the completion callback, so the thread that submitted the read never
+// waits on disk.
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "leveldb/env.h"
+
+namespace czy_leveldb {
+
+class IOCompletionEngine {
+ public:
+  // Start "num_threads" threads for files without native async reads.
+  explicit IOCompletionEngine(int num_threads);
+
+  IOCompletionEngine(const IOCompletionEngine&) = delete;
+  IOCompletionEngine& operator=(const IOCompletionEngine&) = delete;
+
+  // Waits for every submitted read to complete, including native ones,
+  // then stops the threads.
+  ~IOCompletionEngine();
+
+  // Read "req" from "file" and call (*callback)(arg, req) when done,
+  // always from a thread other than the caller's.  Files whose ReadAsync()
+  // returns NotSupported are read by the pool; any other error from
+  // ReadAsync() is reported through req->status.  "file", "req" and its
+  // scratch buffer must stay live until the callback runs.
+  void Submit(const RandomAccessFile* file, ReadRequest* req,
+              RandomAccessFile::ReadCallback callback, void* arg);
+
+ private:
+  struct PendingRead {
+    const RandomAccessFile* file;
+    ReadRequest* req;
+    RandomAccessFile::ReadCallback callback;
+    void* arg;
+    // If not OK, the error ReadAsync() failed with, to be passed to the
+    // callback instead of reading.
+    Status status;
+  };
+
+  // Context of a read handed to ReadAsync(), so that its completion can
+  // be counted before the caller's callback runs.
+  struct NativeRead {
+    IOCompletionEngine* engine;
+    RandomAccessFile::ReadCallback callback;
+    void* arg;
+  };
+
+  static void NativeReadDone(void* arg, ReadRequest* req);
+
+  void WorkerMain();
+
+  std::mutex mu_;
+  std::condition_variable work_cv_;
+  // Signalled when native_reads_ drops to zero.
+  std::condition_variable native_cv_;
+  bool shutting_down_;
+  // Reads handed to ReadAsync() whose callback has not yet returned.
+  int native_reads_;
+  std::deque<PendingRead> queue_;
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace czy_leveldb
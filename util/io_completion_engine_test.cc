@@ -0,0 +1,212 @@
+#include "util/io_completion_engine.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace czy_leveldb {
+
+namespace {
+
+// A file without native async reads; the engine's threads call Read().
+class BlockingFile : public RandomAccessFile {
+ public:
+  explicit BlockingFile(const std::string& contents) : contents_(contents) {}
+
+  Status Read(uint64_t offset, size_t n, Slice* result,
+              char* scratch) const override {
+    if (offset >= contents_.size()) {
+      *result = Slice();
+      return Status::IOError("read past end of file");
+    }
+    n = std::min(n, static_cast<size_t>(contents_.size() - offset));
+    std::memcpy(scratch, contents_.data() + offset, n);
+    *result = Slice(scratch, n);
+    return Status::OK();
+  }
+
+ private:
+  const std::string contents_;
+};
+
+// A file with native async reads, completed inline for the test.
+class AsyncFile : public BlockingFile {
+ public:
+  explicit AsyncFile(const std::string& contents) : BlockingFile(contents) {}
+
+  Status ReadAsync(ReadRequest* req, ReadCallback callback,
+                   void* arg) const override {
+    native_reads_++;
+    req->status = Read(req->offset, req->len, &req->result, req->scratch);
+    (*callback)(arg, req);
+    return Status::OK();
+  }
+
+  mutable std::atomic<int> native_reads_{0};
+};
+
+// A file whose native async reads complete later, on threads of its own.
+class DeferredAsyncFile : public BlockingFile {
+ public:
+  explicit DeferredAsyncFile(const std::string& contents)
+      : BlockingFile(contents) {}
+
+  ~DeferredAsyncFile() override {
+    for (std::thread& t : threads_) {
+      t.join();
+    }
+  }
+
+  Status ReadAsync(ReadRequest* req, ReadCallback callback,
+                   void* arg) const override {
+    std::lock_guard<std::mutex> l(mu_);
+    threads_.emplace_back([this, req, callback, arg] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      req->status = Read(req->offset, req->len, &req->result, req->scratch);
+      (*callback)(arg, req);
+    });
+    return Status::OK();
+  }
+
+ private:
+  mutable std::mutex mu_;
+  mutable std::vector<std::thread> threads_;
+};
+
+// A file whose native async reads fail to start.
+class FailingAsyncFile : public BlockingFile {
+ public:
+  FailingAsyncFile() : BlockingFile("0123456789") {}
+
+  Status Read(uint64_t offset, size_t n, Slice* result,
+              char* scratch) const override {
+    blocking_reads_++;
+    return BlockingFile::Read(offset, n, result, scratch);
+  }
+
+  Status ReadAsync(ReadRequest* /*req*/, ReadCallback /*callback*/,
+                   void* /*arg*/) const override {
+    return Status::IOError("submission queue full");
+  }
+
+  mutable std::atomic<int> blocking_reads_{0};
+};
+
+struct Completions {
+  std::mutex mu;
+  std::vector<ReadRequest*> done;
+  std::vector<std::thread::id> threads;
+
+  static void Callback(void* arg, ReadRequest* req) {
+    Completions* c = static_cast<Completions*>(arg);
+    std::lock_guard<std::mutex> l(c->mu);
+    c->done.push_back(req);
+    c->threads.push_back(std::this_thread::get_id());
+  }
+};
+
+}  // namespace
+
+TEST(IOCompletionEngine, BlockingFilesCompleteOnWorkerThreads) {
+  const std::string contents = "abcdefghijklmnopqrstuvwxyz";
+  BlockingFile file(contents);
+  Completions completions;
+  const int kReads = 100;
+  std::vector<ReadRequest> reqs(kReads);
+  std::vector<std::string> scratch(kReads, std::string(4, '\0'));
+  {
+    IOCompletionEngine engine(3);
+    for (int i = 0; i < kReads; i++) {
+      reqs[i].offset = i % 30;
+      reqs[i].len = 4;
+      reqs[i].scratch = &scratch[i][0];
+      engine.Submit(&file, &reqs[i], &Completions::Callback, &completions);
+    }
+    // The destructor waits for every submitted read.
+  }
+  ASSERT_EQ(static_cast<size_t>(kReads), completions.done.size());
+  for (std::thread::id id : completions.threads) {
+    ASSERT_NE(std::this_thread::get_id(), id);
+  }
+  for (int i = 0; i < kReads; i++) {
+    if (reqs[i].offset < contents.size()) {
+      ASSERT_TRUE(reqs[i].status.ok());
+      ASSERT_EQ(contents.substr(reqs[i].offset, 4),
+                reqs[i].result.ToString());
+    } else {
+      ASSERT_TRUE(reqs[i].status.IsIOError());
+    }
+  }
+}
+
+TEST(IOCompletionEngine, NativeAsyncFilesBypassThePool) {
+  AsyncFile file("0123456789");
+  Completions completions;
+  ReadRequest req;
+  char scratch[3];
+  req.offset = 2;
+  req.len = 3;
+  req.scratch = scratch;
+  IOCompletionEngine engine(1);
+  engine.Submit(&file, &req, &Completions::Callback, &completions);
+  ASSERT_EQ(1, file.native_reads_.load());
+  ASSERT_EQ(1u, completions.done.size());
+  ASSERT_EQ("234", req.result.ToString());
+}
+
+TEST(IOCompletionEngine, DestructorWaitsForNativeReads) {
+  const std::string contents = "0123456789";
+  DeferredAsyncFile file(contents);
+  Completions completions;
+  const int kReads = 8;
+  std::vector<ReadRequest> reqs(kReads);
+  std::vector<std::string> scratch(kReads, std::string(2, '\0'));
+  {
+    IOCompletionEngine engine(1);
+    for (int i = 0; i < kReads; i++) {
+      reqs[i].offset = i;
+      reqs[i].len = 2;
+      reqs[i].scratch = &scratch[i][0];
+      engine.Submit(&file, &reqs[i], &Completions::Callback, &completions);
+    }
+  }
+  ASSERT_EQ(static_cast<size_t>(kReads), completions.done.size());
+  for (int i = 0; i < kReads; i++) {
+    ASSERT_EQ(contents.substr(i, 2), reqs[i].result.ToString());
+  }
+}
+
+TEST(IOCompletionEngine, NativeErrorsReachTheCallback) {
+  FailingAsyncFile file;
+  Completions completions;
+  ReadRequest req;
+  char scratch[3];
+  req.offset = 2;
+  req.len = 3;
+  req.scratch = scratch;
+  {
+    IOCompletionEngine engine(1);
+    engine.Submit(&file, &req, &Completions::Callback, &completions);
+  }
+  // Reported as is, from a pool thread, without falling back to Read().
+  ASSERT_EQ(1u, completions.done.size());
+  ASSERT_NE(std::this_thread::get_id(), completions.threads[0]);
+  ASSERT_TRUE(req.status.IsIOError());
+  ASSERT_EQ(0, file.blocking_reads_.load());
+}
+
+TEST(IOCompletionEngine, DefaultReadAsyncIsNotSupported) {
+  BlockingFile file("x");
+  ReadRequest req;
+  ASSERT_TRUE(file.ReadAsync(&req, &Completions::Callback, nullptr)
+                  .IsNotSupportedError());
+}
+
+}  // namespace czy_leveldb
@@ -0,0 +1,110 @@
+#include "leveldb/merge_operator.h"
+
+#include "leveldb/slice.h"
+#include "util/coding.h"
+
+namespace czy_leveldb {
+
+MergeOperator::~MergeOperator() = default;
+
+bool MergeOperator::PartialMerge(const Slice& /*key*/,
+                                 const Slice& /*left*/,
+                                 const Slice& /*right*/,
+                                 std::string* /*new_value*/) const {
+  return false;
+}
+
+namespace {
+
+class UInt64AddOperator : public MergeOperator {
+ public:
+  const char* Name() const override { return "leveldb.UInt64AddOperator"; }
+
+  bool FullMerge(const Slice& /*key*/, const Slice* existing_value,
+                 const std::vector<Slice>& operands,
+                 std::string* new_value) const override {
+    uint64_t sum = 0;
+    if (existing_value != nullptr && !Decode(*existing_value, &sum)) {
+      return false;
+    }
+    for (const Slice& operand : operands) {
+      uint64_t v;
+      if (!Decode(operand, &v)) {
+        return false;
+      }
+      sum += v;
+    }
+    new_value->clear();
+    PutFixed64(new_value, sum);
+    return true;
+  }
+
+  bool PartialMerge(const Slice& /*key*/, const Slice& left,
+                    const Slice& right,
+                    std::string* new_value) const override {
+    uint64_t a, b;
+    if (!Decode(left, &a) || !Decode(right, &b)) {
+      return false;
+    }
+    new_value->clear();
+    PutFixed64(new_value, a + b);
+    return true;
+  }
+
+ private:
+  static bool Decode(const Slice& s, uint64_t* v) {
+    if (s.size() != 8) {
+      return false;
+    }
+    *v = DecodeFixed64(s.data());
+    return true;
+  }
+};
+
+class StringAppendOperator : public MergeOperator {
+ public:
+  explicit StringAppendOperator(char delimiter) : delimiter_(delimiter) {}
+
+  const char* Name() const override { return "leveldb.StringAppendOperator"; }
+
+  bool FullMerge(const Slice& /*key*/, const Slice* existing_value,
+                 const std::vector<Slice>& operands,
+                 std::string* new_value) const override {
+    new_value->clear();
+    bool first = true;
+    if (existing_value != nullptr) {
+      new_value->assign(existing_value->data(), existing_value->size());
+      first = false;
+    }
+    for (const Slice& operand : operands) {
+      if (!first) {
+        new_value->push_back(delimiter_);
+      }
+      new_value->append(operand.data(), operand.size());
+      first = false;
+    }
+    return true;
+  }
+
+  bool PartialMerge(const Slice& /*key*/, const Slice& left,
+                    const Slice& right,
+                    std::string* new_value) const override {
+    new_value->assign(left.data(), left.size());
+    new_value->push_back(delimiter_);
+    new_value->append(right.data(), right.size());
+    return true;
+  }
+
+ private:
+  const char delimiter_;
+};
+
+}  // namespace
+
+const MergeOperator* NewUInt64AddOperator() { return new UInt64AddOperator; }
+
+const MergeOperator* NewStringAppendOperator(char delimiter) {
+  return new StringAppendOperator(delimiter);
+}
+
+}  // namespace czy_leveldb
@@ -0,0 +1,32 @@
+#include "leveldb/options.h"
+
+#include "leveldb/comparator.h"
+#include "leveldb/env.h"
+
+namespace czy_leveldb {
+
+Options::Options() : comparator(BytewiseComparator()), env(Env::Default()) {}
+
+CompressionType Options::CompressionForLevel(int level) const {
+  if (compression_per_level.empty()) {
+    return compression;
+  }
+  if (level < 0) {
+    level = 0;
+  }
+  const size_t n = compression_per_level.size();
+  return compression_per_level[static_cast<size_t>(level) < n ? level : n - 1];
+}
+
+size_t Options::BlockSizeForLevel(int level) const {
+  if (block_size_per_level.empty()) {
+    return block_size;
+  }
+  if (level < 0) {
+    level = 0;
+  }
+  const size_t n = block_size_per_level.size();
+  return block_size_per_level[static_cast<size_t>(level) < n ? level : n - 1];
+}
+
+}  // namespace czy_leveldb
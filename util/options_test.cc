@@ -0,0 +1,52 @@
+#include "leveldb/options.h"
+
+#include "gtest/gtest.h"
+#include "leveldb/comparator.h"
+#include "leveldb/env.h"
+
+namespace czy_leveldb {
+
+TEST(Options, NoPerLevelOverrides) {
+  Options options;
+  options.compression = CompressionType::kSnappyCompression;
+  options.block_size = 8192;
+  for (int level = -1; level < 7; level++) {
+    ASSERT_EQ(CompressionType::kSnappyCompression,
+              options.CompressionForLevel(level));
+    ASSERT_EQ(8192u, options.BlockSizeForLevel(level));
+  }
+}
+
+TEST(Options, LastEntryCoversDeeperLevels) {
+  Options options;
+  options.compression_per_level = {CompressionType::kNoCompression,
+                                   CompressionType::kLZ4Compression,
+                                   CompressionType::kZstdCompression};
+  options.block_size_per_level = {4096, 16384};
+  ASSERT_EQ(CompressionType::kNoCompression, options.CompressionForLevel(0));
+  ASSERT_EQ(CompressionType::kLZ4Compression, options.CompressionForLevel(1));
+  ASSERT_EQ(CompressionType::kZstdCompression,
+            options.CompressionForLevel(2));
+  ASSERT_EQ(CompressionType::kZstdCompression,
+            options.CompressionForLevel(6));
+  ASSERT_EQ(4096u, options.BlockSizeForLevel(0));
+  ASSERT_EQ(16384u, options.BlockSizeForLevel(1));
+  ASSERT_EQ(16384u, options.BlockSizeForLevel(6));
+}
+
+TEST(Options, NegativeLevelUsesFirstEntry) {
+  Options options;
+  options.compression_per_level = {CompressionType::kNoCompression,
+                                   CompressionType::kZstdCompression};
+  options.block_size_per_level = {4096, 65536};
+  ASSERT_EQ(CompressionType::kNoCompression, options.CompressionForLevel(-1));
+  ASSERT_EQ(4096u, options.BlockSizeForLevel(-1));
+}
+
+TEST(Options, DefaultsToDefaultEnvAndBytewiseComparator) {
+  Options options;
+  ASSERT_EQ(Env::Default(), options.env);
+  ASSERT_EQ(BytewiseComparator(), options.comparator);
+}
+
+}  // namespace czy_leveldb
@@ -0,0 +1,72 @@
+#include "leveldb/pinnable_slice.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace czy_leveldb {
+
+namespace {
+
+void CountRelease(void* arg1, void* arg2) {
+  ++*static_cast<int*>(arg1);
+  EXPECT_EQ(nullptr, arg2);
+}
+
+}  // namespace
+
+TEST(PinnableSlice, PinSliceReleasesOnReset) {
+  const std::string block = "block contents";
+  int releases = 0;
+  PinnableSlice value;
+  value.PinSlice(Slice(block.data() + 6, 8), &CountRelease, &releases,
+                 nullptr);
+  ASSERT_TRUE(value.IsPinned());
+  // No copy: the value points into the pinned memory.
+  ASSERT_EQ(block.data() + 6, value.data());
+  ASSERT_EQ("contents", value.ToString());
+  ASSERT_EQ(0, releases);
+
+  value.Reset();
+  ASSERT_EQ(1, releases);
+  ASSERT_FALSE(value.IsPinned());
+  ASSERT_TRUE(value.empty());
+  value.Reset();
+  ASSERT_EQ(1, releases);
+}
+
+TEST(PinnableSlice, PinSliceReleasesOnDestruction) {
+  int releases = 0;
+  {
+    PinnableSlice value;
+    value.PinSlice("pinned", &CountRelease, &releases, nullptr);
+  }
+  ASSERT_EQ(1, releases);
+}
+
+TEST(PinnableSlice, PinSelfCopies) {
+  std::string source = "copied value";
+  PinnableSlice value;
+  value.PinSelf(source);
+  source[0] = 'X';
+  ASSERT_FALSE(value.IsPinned());
+  ASSERT_EQ("copied value", value.ToString());
+  ASSERT_EQ(value.GetSelf()->data(), value.data());
+}
+
+TEST(PinnableSlice, CallerSuppliedBuffer) {
+  std::string buf;
+  PinnableSlice value(&buf);
+  value.GetSelf()->assign("filled in place");
+  value.PinSelf();
+  ASSERT_EQ("filled in place", value.ToString());
+  ASSERT_EQ(buf.data(), value.data());
+
+  // The buffer can be reused for the next lookup after Reset().
+  value.Reset();
+  value.PinSelf("second");
+  ASSERT_EQ("second", buf);
+  ASSERT_EQ("second", value.ToString());
+}
+
+}  // namespace czy_leveldb
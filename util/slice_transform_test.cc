@@ -0,0 +1,31 @@
+#include "leveldb/slice_transform.h"
+
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace czy_leveldb {
+
+TEST(SliceTransformTest, FixedPrefix) {
+  std::unique_ptr<const SliceTransform> transform(NewFixedPrefixTransform(3));
+  ASSERT_EQ(std::string("leveldb.FixedPrefix.3"), transform->Name());
+  ASSERT_TRUE(transform->InDomain("abc"));
+  ASSERT_TRUE(transform->InDomain("abcdef"));
+  ASSERT_FALSE(transform->InDomain("ab"));
+  ASSERT_FALSE(transform->InDomain(""));
+  ASSERT_EQ("abc", transform->Transform("abcdef").ToString());
+  ASSERT_EQ("abc", transform->Transform("abc").ToString());
+}
+
+TEST(SliceTransformTest, CappedPrefix) {
+  std::unique_ptr<const SliceTransform> transform(NewCappedPrefixTransform(3));
+  ASSERT_EQ(std::string("leveldb.CappedPrefix.3"), transform->Name());
+  ASSERT_TRUE(transform->InDomain(""));
+  ASSERT_TRUE(transform->InDomain("abcdef"));
+  ASSERT_EQ("abc", transform->Transform("abcdef").ToString());
+  ASSERT_EQ("ab", transform->Transform("ab").ToString());
+  ASSERT_EQ("", transform->Transform("").ToString());
+}
+
+}  // namespace czy_leveldb